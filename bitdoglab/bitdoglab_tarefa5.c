@@ -4,6 +4,8 @@
 #include "hardware/i2c.h"
 #include "hardware/pio.h"
 #include "hardware/uart.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
 #include <string.h>
 #include <stdbool.h>
 #include "inc/lora_RFM95.h"
@@ -30,12 +32,27 @@
 // =====================
 #define PIN_RST 20
 #define PIN_DIO0 8
+#define PIN_DIO3 9  // ValidHeader (LORA_RX_STREAM)
 #define LORA_FREQUENCY 915E6
 
 ssd1306_t disp;
 #include "blink.pio.h"
 
 #define SEND_INTERVAL_MS 10000  // Intervalo de envio (10 segundos)
+#define ANIM_INTERVAL_MS 300    // Passo da animação "Esperando dados"
+
+// Sinalizado pelo timer da animação (contexto de IRQ)
+static volatile bool anim_due = false;
+
+// Quadro desenhado que o ssd1306_show_async() ainda não aceitou (DMA ocupado)
+static bool disp_pending = false;
+
+// O display não confirmou (NACK) um quadro: o driver reenvia a tela toda no próximo show
+static volatile bool disp_retry = false;
+
+// Resultado do lora_init() enviado pelo core1 pelo FIFO entre núcleos
+#define CORE1_LORA_OK   0x4C4F5241u  // "LORA"
+#define CORE1_LORA_FAIL 0xDEADu
 
 // =====================
 // Estrutura de dados recebidos via LoRa
@@ -75,7 +92,57 @@ static void show_lux(float lux) {
     int y_top = (64 - 16) / 2;
     snprintf(line, sizeof(line), "%.1f Lux", lux);
     print_texto_centered(line, y_top, 2);
-    ssd1306_show(&disp);
+    // Só copia o quadro e dispara o DMA; se os dois buffers estiverem ocupados,
+    // o desenho fica marcado e o laço tenta de novo quando o DMA terminar
+    disp_pending = !ssd1306_show_async(&disp);
+}
+
+// =====================
+// Timer da animação: só sinaliza; o desenho (I2C) fica no laço principal
+// =====================
+static bool anim_timer_cb(repeating_timer_t *t) {
+    (void)t;
+    anim_due = true;
+    __sev();
+    return true;
+}
+
+// Fim de um quadro do display: IRQ do DMA, ou o laço se o NACK veio depois dela
+static void disp_done_cb(ssd1306_t *p, bool ok, void *arg) {
+    (void)p;
+    (void)arg;
+    if (!ok) {
+        disp_retry = true;
+        __sev();
+    }
+}
+
+// =====================
+// Configuração do módulo LoRa (usada pelo core1)
+// =====================
+static const lora_config_t lora_cfg = {
+    .spi_instance = SPI_PORT,
+    .pin_miso = PIN_MISO,
+    .pin_cs = PIN_CS,
+    .pin_sck = PIN_SCK,
+    .pin_mosi = PIN_MOSI,
+    .pin_rst = PIN_RST,
+    .pin_dio0 = PIN_DIO0,
+    .pin_dio3 = PIN_DIO3,
+    .frequency = LORA_FREQUENCY
+};
+
+// =====================
+// Core1: rádio. A IRQ do DIO0 é registrada aqui, então ela roda neste núcleo:
+// copia cada pacote para a fila e acorda o core0 com __sev(). O core0 fica com
+// o display e o stdio; um ssd1306_show() longo não atrasa o atendimento do rádio.
+// =====================
+static void core1_radio_main(void) {
+    bool ok = lora_init(lora_cfg);
+    if (ok) lora_start_rx_continuous();
+    multicore_fifo_push_blocking(ok ? CORE1_LORA_OK : CORE1_LORA_FAIL);
+
+    while (true) __wfe();
 }
 
 // =====================
@@ -111,20 +178,10 @@ int main() {
     ssd1306_show(&disp);
     sleep_ms(2000);
 
-    // Inicializa LoRa
-    lora_config_t lora_cfg = {
-        .spi_instance = SPI_PORT,
-        .pin_miso = PIN_MISO,
-        .pin_cs = PIN_CS,
-        .pin_sck = PIN_SCK,
-        .pin_mosi = PIN_MOSI,
-        .pin_rst = PIN_RST,
-        .pin_dio0 = PIN_DIO0,
-        .frequency = LORA_FREQUENCY
-    };
-
+    // Inicializa LoRa no core1 e espera o resultado
     printf("Inicializando módulo LoRa (%.0f Hz)...\n", (float)LORA_FREQUENCY);
-    if (!lora_init(lora_cfg)) {
+    multicore_launch_core1(core1_radio_main);
+    if (multicore_fifo_pop_blocking() != CORE1_LORA_OK) {
         printf("ERRO - Falha ao inicializar o módulo LoRa.\n");
         ssd1306_clear(&disp);
         print_texto_centered("Falha LoRa!", 20, 2);
@@ -137,52 +194,80 @@ int main() {
         print_texto_centered("LoRa BH1750", 20, 1);
         print_texto_centered("Modo RX ativo", 36, 1);
         ssd1306_show(&disp);
-        sleep_ms(1500);
-        lora_start_rx_continuous();
+        ssd1306_async_init(&disp, disp_done_cb, NULL, 0); // Daqui em diante o display é atualizado por DMA
+        sleep_ms(1500); // O core1 já está em RX: pacotes que chegarem agora ficam na fila
     }
 
-    uint8_t rxbuf[64];
     bool got_first_data = false;
-    uint32_t anim_tick = 0;
     int dots = 1;
+    repeating_timer_t anim_timer;
+    add_repeating_timer_ms(ANIM_INTERVAL_MS, anim_timer_cb, NULL, &anim_timer);
+    lora_rx_stats_t rx_seen = {0};
 
     // =====================
-    // Loop principal
+    // Loop principal: dorme em __wfe() até a IRQ do DIO0 ou do timer da animação
     // =====================
     while (true) {
-        int len = lora_receive_bytes(rxbuf, sizeof(rxbuf));
-
-        if (len == sizeof(bh1750_dados)) {
-            bh1750_dados rec;
-            memcpy(&rec, rxbuf, sizeof(rec));
-            
-            // CORREÇÃO: Dividir por 100 para obter o valor real em Lux
-            float lux = (float)rec.iluminancia / 100.0f;
-            
+        // A IRQ do DIO0 já copiou os pacotes para a fila; lê direto do slot, sem cópia
+        const lora_packet_t *pkt;
+        bool have_lux = false;
+        float lux = 0.0f;
+
+        while ((pkt = lora_rx_peek()) != NULL) {
+            if (pkt->len == sizeof(bh1750_dados)) {
+                bh1750_dados rec;
+                memcpy(&rec, pkt->data, sizeof(rec));
+
+                // CORREÇÃO: Dividir por 100 para obter o valor real em Lux
+                lux = (float)rec.iluminancia / 100.0f;
+                have_lux = true;
+                printf("Recebido: %.1f Lux | RSSI=%d dBm | SNR=%.2f dB\n",
+                       lux, pkt->rssi_dbm, pkt->snr_q4 / 4.0f);
+            }
+            else {
+                printf("LoRa recebeu %u bytes (brutos): ", pkt->len);
+                for (int i = 0; i < pkt->len; ++i) printf("%02X ", pkt->data[i]);
+                printf("\n");
+            }
+            lora_rx_release();
+        }
+
+        // Com vários pacotes na fila, só o mais recente vai para o display
+        if (have_lux) {
             show_lux(lux);
+            if (!got_first_data) cancel_repeating_timer(&anim_timer);
             got_first_data = true;
-            int rssi = lora_get_rssi();
-            printf("Recebido: %.1f Lux | RSSI=%d dBm\n", lux, rssi);
-        } 
-        else if (len > 0) {
-            printf("LoRa recebeu %d bytes (brutos): ", len);
-            for (int i = 0; i < len; ++i) printf("%02X ", rxbuf[i]);
-            printf("\n");
-        } 
-        else {
+        }
+
+        lora_rx_stats_t rx_now;
+        lora_rx_get_stats(&rx_now);
+        if (rx_now.overruns != rx_seen.overruns || rx_now.crc_errors != rx_seen.crc_errors) {
+            printf("[AVISO] Fila RX: %lu descartados (cheia), %lu com erro de CRC\n",
+                   (unsigned long)rx_now.overruns, (unsigned long)rx_now.crc_errors);
+        }
+        rx_seen = rx_now;
+
+        if (anim_due) {
+            anim_due = false;
             if (!got_first_data) {
-                anim_tick++;
-                if ((anim_tick % 3) == 0) {
-                    char msg[32];
-                    snprintf(msg, sizeof(msg), "Esperando dados%.*s", dots, "...");
-                    ssd1306_clear(&disp);
-                    print_texto_centered(msg, (64 - 8) / 2, 1);
-                    ssd1306_show(&disp);
-                    dots++;
-                    if (dots > 3) dots = 1;
-                }
+                char msg[32];
+                snprintf(msg, sizeof(msg), "Esperando dados%.*s", dots, "...");
+                ssd1306_clear(&disp);
+                print_texto_centered(msg, (64 - 8) / 2, 1);
+                disp_pending = !ssd1306_show_async(&disp);
+                dots++;
+                if (dots > 3) dots = 1;
             }
         }
-        sleep_ms(100);
+
+        if (disp_retry) {
+            disp_retry = false;
+            disp_pending = true;
+        }
+        if (disp_pending && !ssd1306_async_busy(&disp)) disp_pending = !ssd1306_show_async(&disp);
+
+        // A IRQ faz __sev(): se chegou entre o teste e o __wfe(), ele retorna na hora.
+        // O fim do DMA do display também faz __sev() e libera um quadro pendente
+        while (!lora_event_pending() && !anim_due && !disp_retry && !(disp_pending && !ssd1306_async_busy(&disp))) __wfe();
     }
 }
@@ -4,7 +4,14 @@
 #include <string.h>
 #include "pico/stdlib.h"
 #include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/dma.h"
 #include "lora_RFM95.h"
+#if LORA_SPI_PIO
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "lora_spi.pio.h"
+#endif
 
 // DEFINIÇÕES E REGISTRADORES INTERNOS
 // === MAPA DE REGISTRADORES DO MÓDULO RFM95 (MODO LORA) ===
@@ -42,27 +49,87 @@
 #define IRQ_TX_DONE_MASK         0x08
 #define IRQ_PAYLOAD_CRC_ERROR_MASK 0x20
 #define IRQ_RX_DONE_MASK         0x40
+#define IRQ_VALID_HEADER_MASK    0x10
 
+// MODEM: BW 125 kHz, CR 4/8, SF12 (ModemConfig1/2 e o bloco do interleaver no fluxo)
+#define MODEM_BW_HZ              125000
+#define MODEM_BW_CODE            0x07 // Bw de ModemConfig1 para MODEM_BW_HZ (tabela do datasheet)
+#define MODEM_CR_DENOM           8    // CR 4/MODEM_CR_DENOM
+#define MODEM_SF                 12
+#define MODEM_CONFIG_1_VALUE     ((MODEM_BW_CODE << 4) | ((MODEM_CR_DENOM - 4) << 1)) // Cabeçalho explícito
+#define MODEM_CONFIG_2_VALUE     ((MODEM_SF << 4) | 0x04)                             // CRC on
+
+#define REG_PKT_SNR_VALUE        0x19 // SNR do pacote mais recente, em complemento de 2 e passos de 0.25 dB.
 #define REG_PKT_RSSI_VALUE       0x1A // Contém o valor do RSSI do pacote mais recente.
+#define REG_FIFO_RX_BYTE_ADDR    0x25 // Posição do FIFO onde o modem escreve o próximo byte recebido.
+
+#define RX_RING_MASK             (LORA_RX_RING_SIZE - 1)
 
 
 // VARIÁVEIS PRIVADAS (STATIC)
 static lora_config_t lora;
 volatile static bool tx_done = false;
-volatile static bool rx_done = false;
 volatile static bool dio0_event = false;
+static volatile bool rx_capture = false; // RX contínuo: a IRQ do DIO0 lê o pacote
+static uint radio_core;                  // Núcleo que chamou lora_init(): o das IRQs do rádio
+
+// Fila SPSC de pacotes: a IRQ do DIO0 só avança rx_head e o laço principal só avança rx_tail
+static lora_packet_t rx_ring[LORA_RX_RING_SIZE];
+static volatile uint32_t rx_head = 0;
+static volatile uint32_t rx_tail = 0;
+static lora_rx_stats_t rx_stats;
+
+// DMA do FIFO: TX manda o endereço e depois o payload (ou zeros); RX descarta o
+// byte do endereço e grava o resto direto no destino, tudo numa janela de CS
+static int dma_tx_addr, dma_tx_data, dma_rx_skip, dma_rx_data;
+static volatile bool fifo_dma_busy = false;
+static uint8_t fifo_dma_addr;               // REG_FIFO com o bit de escrita
+static uint8_t fifo_dma_dummy;              // Bytes de MISO descartados
+static const uint8_t fifo_dma_zero = 0x00;  // MOSI durante a leitura
+static lora_packet_t *fifo_dma_pkt = NULL;  // Slot da fila sendo preenchido
+static volatile bool dio0_deferred = false; // DIO0 chegou com o DMA ocupando o SPI
+
+#if LORA_RX_STREAM
+// Pacote em fluxo: do ValidHeader ao RxDone o slot da fila recebe o payload aos pedaços
+static alarm_pool_t *stream_pool;           // Alarmes deste núcleo (o pool padrão é do core0)
+static repeating_timer_t stream_timer;
+static lora_packet_t *stream_pkt = NULL;    // Slot sendo preenchido (NULL = nenhum)
+static uint8_t stream_start;                // Posição do pacote no FIFO do rádio
+static uint8_t stream_len;                  // Bytes já em stream_pkt->data
+static uint8_t stream_chunk;                // Bytes do DMA de fluxo em curso
+static int64_t stream_poll_us;              // Um bloco do interleaver
+#endif
+
+#if LORA_SPI_PIO
+// Máquina de estados com o programa lora_spi: CS, SCK, MOSI e MISO
+static PIO lora_pio = pio0;
+static uint lora_sm;
+#endif
 
 // PROTÓTIPOS DE FUNÇÕES PRIVADAS
 static void lora_reset();
 static void lora_write_reg(uint8_t reg, uint8_t value);
 static uint8_t lora_read_reg(uint8_t reg);
 static void lora_write_fifo(const uint8_t *data, uint8_t len);
-static void lora_read_fifo(uint8_t *data, uint8_t len);
+static void fifo_dma_start(uint8_t *dst, const uint8_t *src, uint8_t len);
+static void fifo_dma_irq_handler(void);
+static bool bus_init(void);
+static inline void radio_core_check(void);
+static uint32_t radio_lock(void);
+static void radio_unlock(uint32_t irq);
 static void lora_set_mode(uint8_t mode);
-static void cs_select();
-static void cs_deselect();
-static void dio0_irq_handler(uint gpio, uint32_t events);
+static void bus_begin(uint len);
+static void bus_end(void);
+static uint8_t reg_xfer(uint8_t addr, uint8_t value);
+static void dio_irq_handler(uint gpio, uint32_t events);
 static void handle_dio0_events();
+static void service_irq_flags(void);
+static void poll_irq_flags(void);
+#if LORA_RX_STREAM
+static void stream_begin(void);
+static void stream_stop(void);
+static uint8_t stream_finish(const lora_packet_t *pkt, uint8_t start);
+#endif
 
 // IMPLEMENTAÇÃO DAS FUNÇÕES
 
@@ -70,18 +137,30 @@ static void handle_dio0_events();
 
 bool lora_init(lora_config_t config) {
     lora = config; // Copia a configuração para a variável estática
+    radio_core = get_core_num(); // As IRQs abaixo ficam neste núcleo
 
     // --- Inicialização do Hardware ---
-    spi_init(lora.spi_instance, 5E6);
-    gpio_set_function(lora.pin_miso, GPIO_FUNC_SPI);
-    gpio_set_function(lora.pin_mosi, GPIO_FUNC_SPI);
-    gpio_set_function(lora.pin_sck, GPIO_FUNC_SPI);
-    gpio_init(lora.pin_cs); gpio_set_dir(lora.pin_cs, GPIO_OUT); gpio_put(lora.pin_cs, 1);
+    if (!bus_init()) return false;
     gpio_init(lora.pin_rst); gpio_set_dir(lora.pin_rst, GPIO_OUT);
     
     gpio_init(lora.pin_dio0); gpio_set_dir(lora.pin_dio0, GPIO_IN);
     gpio_pull_down(lora.pin_dio0);
-    gpio_set_irq_enabled_with_callback(lora.pin_dio0, GPIO_IRQ_EDGE_RISE, true, &dio0_irq_handler);
+    gpio_set_irq_enabled_with_callback(lora.pin_dio0, GPIO_IRQ_EDGE_RISE, true, &dio_irq_handler);
+#if LORA_RX_STREAM
+    gpio_init(lora.pin_dio3); gpio_set_dir(lora.pin_dio3, GPIO_IN);
+    gpio_pull_down(lora.pin_dio3);
+    gpio_set_irq_enabled(lora.pin_dio3, GPIO_IRQ_EDGE_RISE, true); // Mesmo callback do DIO0
+    stream_pool = alarm_pool_create_with_unused_hardware_alarm(1);
+    if (!stream_pool) return false;
+#endif
+
+    // DMA do FIFO; a IRQ de fim fica no mesmo núcleo da IRQ do DIO0
+    dma_tx_addr = dma_claim_unused_channel(true);
+    dma_tx_data = dma_claim_unused_channel(true);
+    dma_rx_skip = dma_claim_unused_channel(true);
+    dma_rx_data = dma_claim_unused_channel(true);
+    irq_set_exclusive_handler(DMA_IRQ_1, fifo_dma_irq_handler);
+    irq_set_enabled(DMA_IRQ_1, true);
 
     lora_reset();
     
@@ -98,11 +177,16 @@ bool lora_init(lora_config_t config) {
     // Configurações para longo alcance e robustez
     lora_write_reg(REG_PA_CONFIG, 0xFF); // PaConfig: Max Power (+17dBm on PA_BOOST)
     lora_write_reg(REG_PA_DAC, 0x87); // PaDac: Ativa +20dBm
-    lora_write_reg(REG_MODEM_CONFIG_1, 0x78); // ModemConfig1: BW 62.5kHz, CR 4/8
-    lora_write_reg(REG_MODEM_CONFIG_2, 0xC4); // ModemConfig2: SF12, CRC on
+    lora_write_reg(REG_MODEM_CONFIG_1, MODEM_CONFIG_1_VALUE); // ModemConfig1: BW 125kHz, CR 4/8
+    lora_write_reg(REG_MODEM_CONFIG_2, MODEM_CONFIG_2_VALUE); // ModemConfig2: SF12, CRC on
     lora_write_reg(REG_MODEM_CONFIG_3, 0x0C); // ModemConfig3: LDO on, AGC on
     lora_write_reg(REG_PREAMBLE_MSB, 0x00);
     lora_write_reg(REG_PREAMBLE_LSB, 0x0C);
+#if LORA_RX_STREAM
+    // O modem escreve o payload no FIFO a cada bloco do interleaver: 4 + CR
+    // símbolos (MODEM_CR_DENOM), e cada símbolo dura 2^SF / BW
+    stream_poll_us = (int64_t)((MODEM_CR_DENOM * 1000000ull << MODEM_SF) / MODEM_BW_HZ);
+#endif
 
     lora_write_reg(0x0B, 0x37); // OCP default
     lora_write_reg(0x39, 0x12);
@@ -121,8 +205,11 @@ bool lora_init(lora_config_t config) {
 }
 
 bool lora_send(const char *msg) {
+    radio_core_check();
     if (strlen(msg) > 255) return false;
 
+    rx_capture = false; // A partir daqui o SPI é só do laço principal
+    while (fifo_dma_busy) tight_loop_contents(); // Termina uma leitura de pacote em curso
     lora_set_mode(MODE_STDBY); 
     lora_write_reg(REG_FIFO_ADDR_PTR, 0x00);
     lora_write_fifo((const uint8_t*)msg, strlen(msg));
@@ -149,42 +236,34 @@ bool lora_send(const char *msg) {
 }
 
 int lora_receive(char *buf, size_t maxlen) {
+    radio_core_check();
     // Tenta tratar evento por interrupção
     handle_dio0_events();
     // Fallback: se DIO0 não estiver ligado, faça polling do registrador de IRQs
-    if (!rx_done) {
-        uint8_t irq_flags = lora_read_reg(REG_IRQ_FLAGS);
-        if (irq_flags) {
-            lora_write_reg(REG_IRQ_FLAGS, 0xFF); // limpa todas as flags
-            if ((irq_flags & IRQ_RX_DONE_MASK) && !(irq_flags & IRQ_PAYLOAD_CRC_ERROR_MASK)) {
-                rx_done = true;
-            } else if (irq_flags & IRQ_TX_DONE_MASK) {
-                tx_done = true;
-            }
-        }
-    }
-    if (!rx_done) return 0;
-    rx_done = false;
+    if (rx_head == rx_tail) poll_irq_flags();
+
+    const lora_packet_t *pkt = lora_rx_peek();
+    if (!pkt) return 0;
 
-    uint8_t len = lora_read_reg(REG_RX_NB_BYTES);
+    uint8_t len = pkt->len;
     if (len > maxlen - 1) {
         printf("[AVISO] Pacote de %u bytes truncado para %u.\n", len, (unsigned)(maxlen - 1));
         len = (uint8_t)(maxlen - 1);
     }
-
-    uint8_t fifo_addr = lora_read_reg(REG_FIFO_RX_CURRENT_ADDR);
-    lora_write_reg(REG_FIFO_ADDR_PTR, fifo_addr);
-
-    lora_read_fifo((uint8_t*)buf, len);
+    memcpy(buf, pkt->data, len);
     buf[len] = '\0';
+    lora_rx_release();
 
     return len;
 }
 
 // <<< ADICIONAR IMPLEMENTAÇÃO DAS NOVAS FUNÇÕES >>>
 bool lora_send_bytes(const uint8_t *data, size_t len) {
+    radio_core_check();
     if (len > 255) return false;
 
+    rx_capture = false;
+    while (fifo_dma_busy) tight_loop_contents();
     lora_set_mode(MODE_STDBY);
     lora_write_reg(REG_FIFO_ADDR_PTR, 0x00);
     lora_write_fifo(data, len); // Usa a função existente de escrita no FIFO
@@ -211,64 +290,123 @@ bool lora_send_bytes(const uint8_t *data, size_t len) {
 }
 
 int lora_receive_bytes(uint8_t *buf, size_t maxlen) {
+    radio_core_check();
     // Tenta tratar evento por interrupção
     handle_dio0_events();
     // Fallback: se DIO0 não estiver ligado, faça polling do registrador de IRQs
-    if (!rx_done) {
-        uint8_t irq_flags = lora_read_reg(REG_IRQ_FLAGS);
-        if (irq_flags) {
-            lora_write_reg(REG_IRQ_FLAGS, 0xFF); // limpa todas as flags
-            if ((irq_flags & IRQ_RX_DONE_MASK) && !(irq_flags & IRQ_PAYLOAD_CRC_ERROR_MASK)) {
-                rx_done = true;
-            } else if (irq_flags & IRQ_TX_DONE_MASK) {
-                tx_done = true;
-            }
-        }
-    }
-    if (!rx_done) return 0;
-    rx_done = false;
+    if (rx_head == rx_tail) poll_irq_flags();
+
+    const lora_packet_t *pkt = lora_rx_peek();
+    if (!pkt) return 0;
 
-    uint8_t len = lora_read_reg(REG_RX_NB_BYTES);
+    uint8_t len = pkt->len;
     if (len > maxlen) {
         printf("[AVISO] Pacote de %u bytes truncado para %u.\n", len, (unsigned)maxlen);
         len = (uint8_t)maxlen;
     }
-
-    uint8_t fifo_addr = lora_read_reg(REG_FIFO_RX_CURRENT_ADDR);
-    lora_write_reg(REG_FIFO_ADDR_PTR, fifo_addr);
-
-    lora_read_fifo(buf, len); // Lê os bytes brutos
+    memcpy(buf, pkt->data, len);
+    lora_rx_release();
 
     return len;
 }
 
 
 void lora_start_rx_continuous(void) {
+    radio_core_check();
     lora_write_reg(REG_IRQ_FLAGS, 0xFF);
+#if LORA_RX_STREAM
+    lora_write_reg(REG_DIO_MAPPING_1, 0x01); // DIO0 -> RxDone, DIO3 -> ValidHeader
+#else
     lora_write_reg(REG_DIO_MAPPING_1, 0x00); // DIO0 -> RxDone
+#endif
     lora_write_reg(REG_FIFO_ADDR_PTR, 0x00);
     lora_set_mode(MODE_RX_CONTINUOUS);
+    rx_capture = true;
+}
+
+bool lora_event_pending(void) {
+    return dio0_event || rx_head != rx_tail;
+}
+
+const lora_packet_t *lora_rx_peek(void) {
+    uint32_t tail = rx_tail;
+    if (tail == rx_head) return NULL;
+    __dmb(); // Lê o pacote só depois de ver o rx_head que o publicou
+    return &rx_ring[tail & RX_RING_MASK];
+}
+
+void lora_rx_release(void) {
+    uint32_t tail = rx_tail;
+    if (tail == rx_head) return;
+    __dmb(); // Termina de ler o pacote antes de liberar o slot para a IRQ
+    rx_tail = tail + 1;
+}
+
+void lora_rx_get_stats(lora_rx_stats_t *stats) {
+    // Com a IRQ em outro núcleo a cópia pode misturar instantes, mas cada contador é uma palavra inteira
+    uint32_t irq = save_and_disable_interrupts();
+    *stats = rx_stats;
+    restore_interrupts(irq);
 }
 
 // --- Funções Privadas ---
 
+#if LORA_SPI_PIO
+
+static bool bus_init(void) {
+    if (lora.pin_sck != lora.pin_cs + 1) return false; // Side-set: CS e SCK consecutivos
+
+    lora_sm = (uint)pio_claim_unused_sm(lora_pio, true);
+    uint offset = pio_add_program(lora_pio, &lora_spi_program);
+    // 4 ciclos da máquina por bit
+    lora_spi_program_init(lora_pio, lora_sm, offset, lora.pin_cs, lora.pin_mosi, lora.pin_miso,
+                          (float)clock_get_hz(clk_sys) / (4.0f * LORA_SPI_HZ));
+    return true;
+}
+
+// Cabeçalho de uma transação de `len` bytes: o programa conta os bits
+static void bus_begin(uint len) {
+    pio_sm_put_blocking(lora_pio, lora_sm, len * 8u - 1u);
+}
+
+// O CS é side-set do programa: já subiu depois do último bit
+static void bus_end(void) {}
+
+// Macro-operação de registrador: três palavras no FIFO de TX e duas no de RX;
+// a CPU não desloca bits nem mexe no CS
+static uint8_t reg_xfer(uint8_t addr, uint8_t value) {
+    bus_begin(2);
+    pio_sm_put_blocking(lora_pio, lora_sm, (uint32_t)addr << 24);
+    pio_sm_put_blocking(lora_pio, lora_sm, (uint32_t)value << 24);
+    pio_sm_get_blocking(lora_pio, lora_sm); // MISO do byte de endereço
+    return (uint8_t)pio_sm_get_blocking(lora_pio, lora_sm);
+}
+
+#else
+
 static void cs_select() { gpio_put(lora.pin_cs, 0); }
 static void cs_deselect() { gpio_put(lora.pin_cs, 1); }
 
-static void lora_reset() {
-    gpio_put(lora.pin_rst, 0); sleep_ms(10);
-    gpio_put(lora.pin_rst, 1); sleep_ms(10);
+static bool bus_init(void) {
+    spi_init(lora.spi_instance, LORA_SPI_HZ);
+    gpio_set_function(lora.pin_miso, GPIO_FUNC_SPI);
+    gpio_set_function(lora.pin_mosi, GPIO_FUNC_SPI);
+    gpio_set_function(lora.pin_sck, GPIO_FUNC_SPI);
+    gpio_init(lora.pin_cs); gpio_set_dir(lora.pin_cs, GPIO_OUT); gpio_put(lora.pin_cs, 1);
+    return true;
 }
 
-static void lora_write_reg(uint8_t reg, uint8_t value) {
-    uint8_t buf[2] = { (uint8_t)(reg | 0x80), value };
+static void bus_begin(uint len) {
+    (void)len;
     cs_select();
-    spi_write_blocking(lora.spi_instance, buf, 2);
+}
+
+static void bus_end(void) {
     cs_deselect();
 }
 
-static uint8_t lora_read_reg(uint8_t reg) {
-    uint8_t buf[2] = { reg & 0x7F, 0x00 };
+static uint8_t reg_xfer(uint8_t addr, uint8_t value) {
+    uint8_t buf[2] = { addr, value };
     uint8_t rx[2];
     cs_select();
     spi_write_read_blocking(lora.spi_instance, buf, rx, 2);
@@ -276,52 +414,275 @@ static uint8_t lora_read_reg(uint8_t reg) {
     return rx[1];
 }
 
+#endif
+
+static void lora_reset() {
+    gpio_put(lora.pin_rst, 0); sleep_ms(10);
+    gpio_put(lora.pin_rst, 1); sleep_ms(10);
+}
+
+static void lora_write_reg(uint8_t reg, uint8_t value) {
+    reg_xfer((uint8_t)(reg | 0x80), value);
+}
+
+static uint8_t lora_read_reg(uint8_t reg) {
+    return reg_xfer(reg & 0x7F, 0x00);
+}
+
 static void lora_write_fifo(const uint8_t *data, uint8_t len) {
-    cs_select();
-    uint8_t addr = REG_FIFO | 0x80;
-    spi_write_blocking(lora.spi_instance, &addr, 1);
-    spi_write_blocking(lora.spi_instance, data, len);
-    cs_deselect();
+    fifo_dma_start(NULL, data, len);
+    while (fifo_dma_busy) __wfe(); // A IRQ de fim do DMA faz __sev()
 }
 
-static void lora_read_fifo(uint8_t *data, uint8_t len) {
-    cs_select();
-    uint8_t addr = REG_FIFO & 0x7F;
-    spi_write_blocking(lora.spi_instance, &addr, 1);
-    spi_read_blocking(lora.spi_instance, 0x00, data, len);
-    cs_deselect();
+// Canal de DMA no ritmo do SPI do rádio: TX lê da memória, RX grava nela
+static void fifo_dma_channel(int ch, bool tx, const volatile void *mem, bool incr, uint count, int chain_to) {
+#if LORA_SPI_PIO
+    // Escrita de 8 bits no FIFO de TX replica o byte: o autopull pega o MSB
+    volatile void *dr = tx ? (volatile void *)&lora_pio->txf[lora_sm] : (volatile void *)&lora_pio->rxf[lora_sm];
+    uint dreq = pio_get_dreq(lora_pio, lora_sm, tx);
+#else
+    volatile void *dr = &spi_get_hw(lora.spi_instance)->dr;
+    uint dreq = spi_get_dreq(lora.spi_instance, tx);
+#endif
+    dma_channel_config c = dma_channel_get_default_config(ch);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_dreq(&c, dreq);
+    channel_config_set_chain_to(&c, chain_to);
+    channel_config_set_read_increment(&c, tx && incr);
+    channel_config_set_write_increment(&c, !tx && incr);
+    if (tx) dma_channel_configure(ch, &c, dr, mem, count, false);
+    else    dma_channel_configure(ch, &c, (volatile void *)mem, dr, count, false);
+}
+
+// Endereço + payload numa janela de CS; termina em fifo_dma_irq_handler().
+// Leitura: src == NULL, o payload vai para dst. Escrita: dst == NULL.
+static void fifo_dma_start(uint8_t *dst, const uint8_t *src, uint8_t len) {
+    bool write = (src != NULL);
+
+    fifo_dma_addr = write ? (REG_FIFO | 0x80) : (REG_FIFO & 0x7F);
+    fifo_dma_busy = true;
+
+    fifo_dma_channel(dma_tx_addr, true, &fifo_dma_addr, false, 1, dma_tx_data);
+    fifo_dma_channel(dma_tx_data, true, write ? src : &fifo_dma_zero, write, len, dma_tx_data);
+    if (write) {
+        fifo_dma_channel(dma_rx_skip, false, &fifo_dma_dummy, false, len + 1u, dma_rx_skip);
+    } else {
+        fifo_dma_channel(dma_rx_skip, false, &fifo_dma_dummy, false, 1, dma_rx_data);
+        fifo_dma_channel(dma_rx_data, false, dst, true, len, dma_rx_data);
+    }
+    // Fim = último byte recebido: o SPI já terminou de deslocar
+    dma_channel_set_irq1_enabled(dma_rx_skip, write);
+    dma_channel_set_irq1_enabled(dma_rx_data, !write);
+
+    bus_begin(len + 1u);
+    dma_start_channel_mask((1u << dma_rx_skip) | (1u << dma_tx_addr));
+}
+
+// Publica o pacote lido pelo DMA na fila
+static void rx_publish(void) {
+    uint32_t head = rx_head;
+    uint32_t depth = head - rx_tail + 1;
+
+    __dmb(); // O pacote fica completo na memória antes de ser publicado
+    rx_head = head + 1;
+    rx_stats.captured++;
+    if (depth > rx_stats.max_depth) rx_stats.max_depth = depth;
+    fifo_dma_pkt = NULL;
+}
+
+static void fifo_dma_irq_handler(void) {
+    int done = dma_channel_get_irq1_status(dma_rx_data) ? dma_rx_data :
+               dma_channel_get_irq1_status(dma_rx_skip) ? dma_rx_skip : -1;
+    if (done < 0) return;
+    dma_channel_acknowledge_irq1(done);
+
+    bus_end();
+#if LORA_RX_STREAM
+    if (stream_chunk) {
+        stream_len += stream_chunk;
+        stream_chunk = 0;
+    }
+#endif
+    if (fifo_dma_pkt) rx_publish();
+    fifo_dma_busy = false;
+    if (dio0_deferred) {
+        dio0_deferred = false;
+        service_irq_flags();
+    }
+    __sev();
+}
+
+// As funções que usam o SPI só rodam no núcleo do rádio: radio_lock() desliga as
+// IRQs só do núcleo que chama, então do outro núcleo a IRQ do DIO0 ou do DMA
+// poderia usar o barramento ao mesmo tempo
+static inline void radio_core_check(void) {
+    hard_assert(get_core_num() == radio_core);
+}
+
+// Acesso ao rádio fora da IRQ: espera o DMA do FIFO e segura a IRQ do DIO0 (mesmo núcleo)
+static uint32_t radio_lock(void) {
+    for (;;) {
+        while (fifo_dma_busy) tight_loop_contents();
+        uint32_t irq = save_and_disable_interrupts();
+        if (!fifo_dma_busy) return irq;
+        restore_interrupts(irq);
+    }
+}
+
+static void radio_unlock(uint32_t irq) {
+    restore_interrupts(irq);
 }
 
 static void lora_set_mode(uint8_t mode) {
     lora_write_reg(REG_OP_MODE, (0x80 | mode)); // Bit 7 (LongRangeMode) sempre deve ser 1
 }
 
-static void dio0_irq_handler(uint gpio, uint32_t events) {
+// DIO0 (RxDone/TxDone) e, com LORA_RX_STREAM, DIO3 (ValidHeader): as flags dizem o que houve
+static void dio_irq_handler(uint gpio, uint32_t events) {
     (void)gpio; (void)events;
-    dio0_event = true;
+    if (rx_capture) {
+        // RX contínuo: tira o pacote do rádio já, antes que o próximo o sobrescreva
+        service_irq_flags();
+    } else {
+        dio0_event = true; // TX: tratado em handle_dio0_events() pelo laço de envio
+    }
+    __sev(); // Acorda o laço principal parado em __wfe()
 }
 
 static void handle_dio0_events() {
     if (!dio0_event) return;
     dio0_event = false;
 
+    uint32_t irq = radio_lock();
+    service_irq_flags();
+    radio_unlock(irq);
+}
+
+// Polling do RegIrqFlags; com o RX contínuo ativo a IRQ do DIO0 também usa o SPI
+static void poll_irq_flags(void) {
+    uint32_t irq = radio_lock();
+    service_irq_flags();
+    radio_unlock(irq);
+}
+
+// Lê e limpa as flags; no RxDone dispara o DMA do payload para um slot da fila.
+// Roda na IRQ do DIO0, na IRQ de fim do DMA ou com as IRQs desligadas: é o único produtor da fila.
+static void service_irq_flags(void) {
+    if (fifo_dma_busy) {
+        dio0_deferred = true; // O SPI está com o DMA; volta aqui no fim dele
+        return;
+    }
+
     uint8_t irq_flags = lora_read_reg(REG_IRQ_FLAGS);
-    lora_write_reg(REG_IRQ_FLAGS, 0xFF); // Limpa todas as flags escrevendo 1s
-
-    if ((irq_flags & IRQ_RX_DONE_MASK) && !(irq_flags & IRQ_PAYLOAD_CRC_ERROR_MASK)) {
-        rx_done = true;
-    } else if (irq_flags & IRQ_TX_DONE_MASK) {
-        tx_done = true;
-    } else if (irq_flags & IRQ_PAYLOAD_CRC_ERROR_MASK) {
-        printf("[LORA_LIB] Erro de CRC no pacote!\n");
+    if (!irq_flags) return;
+    lora_write_reg(REG_IRQ_FLAGS, irq_flags); // Limpa só as lidas: uma que subir agora gera outra IRQ
+
+    if (irq_flags & IRQ_TX_DONE_MASK) tx_done = true;
+#if LORA_RX_STREAM
+    if ((irq_flags & IRQ_VALID_HEADER_MASK) && rx_capture) stream_begin();
+#endif
+    if (!(irq_flags & IRQ_RX_DONE_MASK)) return;
+    if (irq_flags & IRQ_PAYLOAD_CRC_ERROR_MASK) {
+        rx_stats.crc_errors++;
+#if LORA_RX_STREAM
+        stream_stop(); // O que já foi copiado não vale
+#endif
+        return;
+    }
+
+    uint32_t head = rx_head;
+    uint32_t depth = head - rx_tail;
+    if (depth >= LORA_RX_RING_SIZE) {
+        rx_stats.overruns++; // Fila cheia: descarta o pacote novo
+        return;
+    }
+
+    // Registradores antes do payload: durante o DMA o SPI fica ocupado
+    lora_packet_t *pkt = &rx_ring[head & RX_RING_MASK];
+    pkt->timestamp_us = time_us_64();
+    pkt->len = lora_read_reg(REG_RX_NB_BYTES);
+    pkt->snr_q4 = (int8_t)lora_read_reg(REG_PKT_SNR_VALUE);
+    pkt->rssi_dbm = (int16_t)(lora_read_reg(REG_PKT_RSSI_VALUE) - 157);
+    uint8_t start = lora_read_reg(REG_FIFO_RX_CURRENT_ADDR);
+    uint8_t done = 0;
+#if LORA_RX_STREAM
+    done = stream_finish(pkt, start); // Só falta o que chegou depois do último bloco lido
+#endif
+    lora_write_reg(REG_FIFO_ADDR_PTR, (uint8_t)(start + done));
+
+    fifo_dma_pkt = pkt;
+    if (pkt->len == done) {
+        rx_publish();
+        return;
     }
+    fifo_dma_start(pkt->data + done, NULL, (uint8_t)(pkt->len - done));
 }
 
+#if LORA_RX_STREAM
+
+// Timer de um bloco do interleaver: copia o que o modem escreveu no FIFO desde a última vez
+static bool stream_poll(repeating_timer_t *rt) {
+    (void)rt;
+    lora_packet_t *pkt = stream_pkt;
+    if (!pkt || !rx_capture) {
+        stream_pkt = NULL;
+        return false;
+    }
+    if (fifo_dma_busy) return true; // O SPI está com outro DMA: fica para o próximo bloco
+
+    uint8_t pos = (uint8_t)(stream_start + stream_len);
+    uint8_t n = (uint8_t)(lora_read_reg(REG_FIFO_RX_BYTE_ADDR) - pos);
+    if (n == 0) return true;
+    if (stream_len + n > LORA_MAX_PAYLOAD) { // O FIFO não é mais deste pacote
+        stream_pkt = NULL;
+        return false;
+    }
+    lora_write_reg(REG_FIFO_ADDR_PTR, pos);
+    stream_chunk = n;
+    fifo_dma_start(pkt->data + stream_len, NULL, n);
+    return true;
+}
+
+// ValidHeader: o payload começa onde o modem vai escrever e passa a ser lido a cada bloco
+static void stream_begin(void) {
+    uint32_t head = rx_head;
+
+    stream_stop(); // Cabeçalho anterior sem RxDone
+    if (head - rx_tail >= LORA_RX_RING_SIZE) return; // Fila cheia: o RxDone conta o descarte
+
+    stream_start = lora_read_reg(REG_FIFO_RX_BYTE_ADDR);
+    stream_len = 0;
+    stream_pkt = &rx_ring[head & RX_RING_MASK];
+    alarm_pool_add_repeating_timer_us(stream_pool, -stream_poll_us, stream_poll, NULL, &stream_timer);
+}
+
+static void stream_stop(void) {
+    if (stream_pkt) cancel_repeating_timer(&stream_timer);
+    stream_pkt = NULL;
+}
+
+// RxDone com CRC bom: quantos bytes do pacote que começa em `start` já estão no slot
+static uint8_t stream_finish(const lora_packet_t *pkt, uint8_t start) {
+    uint8_t done = 0;
+
+    if (stream_pkt == pkt && stream_start == start && stream_len <= pkt->len) {
+        done = stream_len;
+        rx_stats.streamed += done;
+    }
+    stream_stop();
+    return done;
+}
+
+#endif
+
 
 
 // <<< ADICIONE A IMPLEMENTAÇÃO DA NOVA FUNÇÃO AQUI >>>
 int lora_get_rssi(void) {
+    radio_core_check();
+    uint32_t irq = radio_lock();
     uint8_t rssi_raw = lora_read_reg(REG_PKT_RSSI_VALUE);
+    radio_unlock(irq);
     // A fórmula para calcular o RSSI em dBm é RSSI = -157 + Rssi (para o frontend de HF)
     // Veja a seção 5.5.5 do datasheet do SX1276/7/8/9.
     return rssi_raw - 157;
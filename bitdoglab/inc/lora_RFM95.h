@@ -12,18 +12,67 @@
 // CONFIGURAÇÕES DE TEMPO (ms)
 #define TX_TIMEOUT_MS       5000   // tempo máximo esperando TxDone
 
+// SPI DO RÁDIO (o SX127x aceita até 10 MHz; o FIFO vai por DMA, sem ocupar a CPU)
+#ifndef LORA_SPI_HZ
+#define LORA_SPI_HZ         5000000
+#endif
+
+// SPI DO RÁDIO PELA PIO (lora_spi.pio) em vez do bloco SPI: o CS é temporizado
+// pelo programa, cada registrador é uma macro-operação de FIFO e o FIFO do
+// rádio vai por DMA nos DREQs da PIO. Exige CS e SCK em GPIOs consecutivos.
+#ifndef LORA_SPI_PIO
+#define LORA_SPI_PIO        0
+#endif
+
+// RECEPÇÃO EM FLUXO: no ValidHeader (DIO3) o pacote começa a sair do FIFO do
+// rádio enquanto ainda chega, acompanhando RegFifoRxByteAddr a cada bloco do
+// interleaver; no RxDone só falta o resto e o CRC confirma o pacote. Exige o
+// DIO3 ligado.
+#ifndef LORA_RX_STREAM
+#define LORA_RX_STREAM      0
+#endif
+
+// FILA DE RECEPÇÃO
+#define LORA_MAX_PAYLOAD    255    // Maior payload do SX127x
+#define LORA_RX_RING_SIZE   4      // Pacotes na fila (potência de 2)
+
+// Pacote capturado na IRQ do DIO0 (RxDone)
+typedef struct {
+    uint64_t timestamp_us;      // Instante do RxDone (time_us_64)
+    int16_t  rssi_dbm;          // RSSI do pacote
+    int8_t   snr_q4;            // SNR do pacote em 1/4 dB
+    uint8_t  len;               // Bytes válidos em data
+    uint8_t  data[LORA_MAX_PAYLOAD];
+} lora_packet_t;
+
+// Contadores da fila de recepção
+typedef struct {
+    uint32_t captured;          // Pacotes copiados do FIFO do rádio para a fila
+    uint32_t overruns;          // Pacotes descartados com a fila cheia
+    uint32_t crc_errors;        // RxDone com erro de CRC (não entram na fila)
+    uint32_t max_depth;         // Maior ocupação observada
+    uint32_t streamed;          // Bytes copiados antes do RxDone (LORA_RX_STREAM)
+} lora_rx_stats_t;
+
 // Struct de configuração para tornar a biblioteca mais portável
 typedef struct {
-    spi_inst_t *spi_instance;
+    spi_inst_t *spi_instance;   // Sem uso com LORA_SPI_PIO
     uint pin_miso;
     uint pin_cs;
     uint pin_sck;
     uint pin_mosi;
     uint pin_rst;
     uint pin_dio0;
+    uint pin_dio3;              // ValidHeader; só com LORA_RX_STREAM
     long frequency; // Frequência em Hz (ex: 915E6)
 } lora_config_t;
 
+// NÚCLEO DO RÁDIO: as IRQs do DIO0/DIO3 e do DMA do FIFO ficam no núcleo que
+// chama lora_init(). lora_send*, lora_receive*, lora_start_rx_continuous e
+// lora_get_rssi usam o SPI e só podem ser chamadas desse núcleo (hard_assert).
+// A fila (lora_event_pending, lora_rx_peek/release, lora_rx_get_stats) pode
+// ser lida do outro núcleo.
+
 /**
  * @brief Inicializa o módulo LoRa com as configurações fornecidas.
  * * @param config A struct com as configurações de pinos, SPI e frequência.
@@ -67,8 +116,36 @@ bool lora_send_bytes(const uint8_t *data, size_t len);
  */
 int lora_receive_bytes(uint8_t *buf, size_t maxlen);
 
+/**
+ * @brief Indica se há pacote na fila ou evento do DIO0 ainda não tratado.
+ * A IRQ do DIO0 também executa __sev(), então o laço principal pode dormir com
+ * __wfe() enquanto isto for falso.
+ * @return true se há pacote (ou TxDone) esperando.
+ */
+bool lora_event_pending(void);
+
+/**
+ * @brief Pacote mais antigo da fila de recepção, sem cópia.
+ * Em RX contínuo, a IRQ do DIO0 lê o FIFO do rádio na hora do RxDone e grava
+ * o pacote na fila; um segundo pacote não sobrescreve o primeiro enquanto o
+ * laço principal atualiza o display. O ponteiro vale até lora_rx_release().
+ * @return O pacote, ou NULL se a fila está vazia.
+ */
+const lora_packet_t *lora_rx_peek(void);
+
+/**
+ * @brief Devolve à fila o pacote obtido com lora_rx_peek().
+ */
+void lora_rx_release(void);
+
+/**
+ * @brief Copia os contadores da fila de recepção (capturas, descartes, CRC).
+ */
+void lora_rx_get_stats(lora_rx_stats_t *stats);
+
 /**
  * @brief Obtém o RSSI (Received Signal Strength Indication) do último pacote recebido.
+ * Com a fila, prefira o rssi_dbm do próprio pacote: este valor é do mais recente.
  * @return O valor do RSSI em dBm.
  */
 int lora_get_rssi(void); // <<< ADICIONE ESTA LINHA
@@ -25,6 +25,9 @@ SOFTWARE.
 
 #include <pico/stdlib.h>
 #include <hardware/i2c.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/sync.h>
 #include <pico/binary_info.h>
 #include <stdlib.h>
 #include <string.h>
@@ -33,6 +36,62 @@ SOFTWARE.
 #include "ssd1306.h"
 #include "font.h"
 
+// non-blocking show: one display, one DMA channel feeding IC_DATA_CMD
+static struct {
+    ssd1306_t *p;
+    int chan;
+    uint16_t *words[2];     // a refresh as DATA_CMD words: every window's commands and data, STOP ending each transfer
+    size_t len[2];
+    uint8_t fill;           // buffer being filled by ssd1306_show_async
+    volatile int8_t on_bus; // buffer the DMA is sending (-1: idle)
+    volatile int8_t queued; // buffer waiting for the bus (-1: none)
+    volatile bool resend;   // a NACK dropped windows already copied to shadow: next show sends every page
+    ssd1306_done_cb_t done;
+    void *arg;
+    uint32_t min_frame_us;
+    uint64_t last_us;       // when the last frame was queued
+    repeating_timer_t retry;    // one-shot: __sev() when the frame-rate limit ends
+    volatile bool retry_armed;
+} async= {.chan=-1, .on_bus=-1, .queued=-1};
+
+// glyph column bits stretched for scale 2 and 3: bit j becomes bits j*s..j*s+s-1
+static uint16_t scale2[256];
+static uint32_t scale3[256];
+
+static void ssd1306_build_scale_tables(void) {
+    if(scale2[0xff])
+        return;
+    for(uint32_t b=0; b<256; ++b) {
+        uint32_t d=0, t=0;
+        for(uint32_t j=0; j<8; ++j) {
+            if(b&(1u<<j)) {
+                d|=3u<<(2*j);
+                t|=7u<<(3*j);
+            }
+        }
+        scale2[b]=d;
+        scale3[b]=t;
+    }
+}
+
+inline static uint64_t ssd1306_scale_bits(uint8_t b, uint32_t scale) {
+    switch(scale) {
+    case 1:
+        return b;
+    case 2:
+        return scale2[b];
+    case 3:
+        return scale3[b];
+    default: {
+        uint64_t m=0, ones=(1ull<<scale)-1;
+        for(uint32_t j=0; b; ++j, b>>=1)
+            if(b&1)
+                m|=ones<<(j*scale);
+        return m;
+    }
+    }
+}
+
 inline static void swap(int32_t *a, int32_t *b) {
     int32_t *t=a;
     *a=*b;
@@ -40,6 +99,8 @@ inline static void swap(int32_t *a, int32_t *b) {
 }
 
 inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, char *name) {
+    if(async.p && async.p->i2c_i==i2c)
+        ssd1306_async_wait(async.p);
     switch(i2c_write_blocking(i2c, addr, src, len, false)) {
     case PICO_ERROR_GENERIC:
         printf("[%s] addr not acknowledged!\n", name);
@@ -53,9 +114,25 @@ inline static void fancy_write(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src
     }
 }
 
+void ssd1306_write_cmds(ssd1306_t *p, const uint8_t *cmds, size_t len) {
+    // control byte 0x00 (Co=0, D/C#=0): every following byte is a command or an argument
+    p->txbuf[0]=0x00;
+    memcpy(p->txbuf+1, cmds, len);
+    fancy_write(p->i2c_i, p->address, p->txbuf, len+1, "ssd1306_write_cmds");
+}
+
 inline static void ssd1306_write(ssd1306_t *p, uint8_t val) {
-    uint8_t d[2]= {0x00, val};
-    fancy_write(p->i2c_i, p->address, d, 2, "ssd1306_write");
+    ssd1306_write_cmds(p, &val, 1);
+}
+
+inline static void ssd1306_mark_dirty(ssd1306_t *p, uint32_t x, uint32_t page) {
+    if(x<p->dirty_lo[page]) p->dirty_lo[page]=x;
+    if(x>p->dirty_hi[page]) p->dirty_hi[page]=x;
+}
+
+inline static void ssd1306_mark_all(ssd1306_t *p) {
+    memset(p->dirty_lo, 0, sizeof(p->dirty_lo));
+    memset(p->dirty_hi, p->width-1, sizeof(p->dirty_hi));
 }
 
 bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address, i2c_inst_t *i2c_instance) {
@@ -66,14 +143,23 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
 
     p->i2c_i=i2c_instance;
 
+    if(p->pages>SSD1306_MAX_PAGES)
+        return false;
 
+    // txbuf (control byte + up to a whole frame), then buffer and shadow
     p->bufsize=(p->pages)*(p->width);
-    if((p->buffer=malloc(p->bufsize+1))==NULL) {
+    if((p->txbuf=malloc(3*p->bufsize+1))==NULL) {
         p->bufsize=0;
         return false;
     }
 
-    ++(p->buffer);
+    p->buffer=p->txbuf+p->bufsize+1;
+    p->shadow=p->buffer+p->bufsize;
+    memset(p->buffer, 0, p->bufsize);
+    ssd1306_mark_all(p);
+    p->full_refresh=true; // display RAM is undefined after power-on
+    p->show_bytes=0;
+    ssd1306_build_scale_tables();
 
     // from https://github.com/makerportal/rpi-pico-ssd1306
     uint8_t cmds[]= {
@@ -109,14 +195,23 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
         0x00,  // horizontal
     };
 
-    for(size_t i=0; i<sizeof(cmds); ++i)
-        ssd1306_write(p, cmds[i]);
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
 
     return true;
 }
 
 inline void ssd1306_deinit(ssd1306_t *p) {
-    free(p->buffer-1);
+    if(async.p==p) {
+        ssd1306_async_wait(p);
+        if(async.retry_armed)
+            cancel_repeating_timer(&async.retry);
+        async.retry_armed=false;
+        dma_channel_set_irq0_enabled(async.chan, false);
+        dma_channel_unclaim(async.chan);
+        free(async.words[0]);
+        async.p=NULL;
+    }
+    free(p->txbuf);
 }
 
 inline void ssd1306_poweroff(ssd1306_t *p) {
@@ -128,8 +223,8 @@ inline void ssd1306_poweron(ssd1306_t *p) {
 }
 
 inline void ssd1306_contrast(ssd1306_t *p, uint8_t val) {
-    ssd1306_write(p, SET_CONTRAST);
-    ssd1306_write(p, val);
+    uint8_t cmds[]= {SET_CONTRAST, val};
+    ssd1306_write_cmds(p, cmds, sizeof(cmds));
 }
 
 inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
@@ -138,18 +233,21 @@ inline void ssd1306_invert(ssd1306_t *p, uint8_t inv) {
 
 inline void ssd1306_clear(ssd1306_t *p) {
     memset(p->buffer, 0, p->bufsize);
+    ssd1306_mark_all(p);
 }
 
 void ssd1306_clear_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
     if(x>=p->width || y>=p->height) return;
 
     p->buffer[x+p->width*(y>>3)]&=~(0x1<<(y&0x07));
+    ssd1306_mark_dirty(p, x, y>>3);
 }
 
 void ssd1306_draw_pixel(ssd1306_t *p, uint32_t x, uint32_t y) {
     if(x>=p->width || y>=p->height) return;
 
     p->buffer[x+p->width*(y>>3)]|=0x1<<(y&0x07); // y>>3==y/8 && y&0x7==y%8
+    ssd1306_mark_dirty(p, x, y>>3);
 }
 
 void ssd1306_draw_line(ssd1306_t *p, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
@@ -193,10 +291,8 @@ void ssd1306_draw_empty_square(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t wi
     ssd1306_draw_line(p, x+width, y, x+width, y+height);
 }
 
-void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
-    if(c<font[3]||c>font[4])
-        return;
-
+// one square per font pixel: glyphs too tall for ssd1306_draw_char_with_font's 64-bit columns
+static void ssd1306_draw_char_squares(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
     uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
     for(uint8_t w=0; w<font[1]; ++w) { // width
         uint32_t pp=(c-font[3])*font[1]*parts_per_line+w*parts_per_line+5;
@@ -213,6 +309,53 @@ void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t
     }
 }
 
+void ssd1306_draw_char_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
+    if(c<font[3]||c>font[4])
+        return;
+
+    uint32_t parts_per_line=(font[0]>>3)+((font[0]&7)>0);
+    uint32_t rows=parts_per_line*8*scale, shift=y&7;
+    if(rows+shift>64) {
+        ssd1306_draw_char_squares(p, x, y, scale, font, c);
+        return;
+    }
+
+    // clip once: the glyph box against the display, in columns and pages
+    if(!scale || x>=p->width || y>=p->height)
+        return;
+    uint32_t x_end=x+font[1]*scale, page0=y>>3, pages=(shift+rows+7)>>3;
+    if(x_end>p->width)
+        x_end=p->width;
+    if(page0+pages>p->pages)
+        pages=p->pages-page0;
+
+    // each font column becomes one bit column, OR'ed into the page bytes scale times
+    const uint8_t *g=font+5+(c-font[3])*font[1]*parts_per_line;
+    for(uint32_t cx=x; cx<x_end; cx+=scale, g+=parts_per_line) {
+        uint64_t col=0;
+        for(uint32_t lp=0; lp<parts_per_line; ++lp)
+            col|=ssd1306_scale_bits(g[lp], scale)<<(lp*8*scale);
+        col<<=shift;
+
+        uint32_t n=x_end-cx<scale?x_end-cx:scale;
+        uint8_t *dst=p->buffer+page0*p->width+cx;
+        for(uint32_t page=0; page<pages && col; ++page, col>>=8, dst+=p->width) {
+            uint8_t b=(uint8_t)col;
+            if(scale==1) {
+                *dst|=b; // page-aligned: the font byte is the display byte
+                continue;
+            }
+            for(uint32_t k=0; k<n; ++k)
+                dst[k]|=b;
+        }
+    }
+
+    for(uint32_t page=page0; page<page0+pages; ++page) {
+        ssd1306_mark_dirty(p, x, page);
+        ssd1306_mark_dirty(p, x_end-1, page);
+    }
+}
+
 void ssd1306_draw_string_with_font(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, const char *s) {
     for(int32_t x_n=x; *s; x_n+=(font[1]+font[2])*scale) {
         ssd1306_draw_char_with_font(p, x_n, y, scale, font, *(s++));
@@ -290,18 +433,255 @@ inline void ssd1306_bmp_show_image(ssd1306_t *p, const uint8_t *data, const long
     ssd1306_bmp_show_image_with_offset(p, data, size, 0, 0);
 }
 
+// narrow the dirty range of a page to the bytes that differ from the shadow
+static void ssd1306_trim_page(ssd1306_t *p, uint8_t page) {
+    const uint8_t *buf=p->buffer+page*p->width;
+    const uint8_t *sh=p->shadow+page*p->width;
+    uint8_t lo=p->dirty_lo[page], hi=p->dirty_hi[page];
+
+    while(lo<=hi && buf[lo]==sh[lo]) ++lo;
+    while(hi>lo && buf[hi]==sh[hi]) --hi;
+    p->dirty_lo[page]=lo;
+    p->dirty_hi[page]=hi;
+}
+
+typedef void (*ssd1306_window_fn)(ssd1306_t *p, const uint8_t *cmds, size_t ncmds, uint8_t page0, uint8_t page1, uint8_t col0, uint8_t col1);
+
+// columns col0..col1 of pages page0..page1 in one transfer (horizontal addressing wraps inside the window)
+static void ssd1306_send_window(ssd1306_t *p, const uint8_t *cmds, size_t ncmds, uint8_t page0, uint8_t page1, uint8_t col0, uint8_t col1) {
+    size_t len=col1-col0+1, n=0;
+
+    ssd1306_write_cmds(p, cmds, ncmds);
+
+    p->txbuf[n++]=0x40;
+    for(uint8_t page=page0; page<=page1; ++page) {
+        size_t off=page*p->width+col0;
+        memcpy(p->txbuf+n, p->buffer+off, len);
+        memcpy(p->shadow+off, p->buffer+off, len);
+        n+=len;
+    }
+
+    fancy_write(p->i2c_i, p->address, p->txbuf, n, "ssd1306_show");
+    p->show_bytes+=ncmds+2+n+1; // address + control byte per transfer
+}
+
+// same bytes as ssd1306_send_window, as DATA_CMD words in the buffer being filled
+static void ssd1306_queue_window(ssd1306_t *p, const uint8_t *cmds, size_t ncmds, uint8_t page0, uint8_t page1, uint8_t col0, uint8_t col1) {
+    uint16_t *w=async.words[async.fill]+async.len[async.fill], *start=w;
+    size_t len=col1-col0+1;
+
+    *w++=0x00;
+    for(size_t i=0; i<ncmds; ++i)
+        *w++=cmds[i];
+    w[-1]|=I2C_IC_DATA_CMD_STOP_BITS;
+
+    *w++=0x40;
+    for(uint8_t page=page0; page<=page1; ++page) {
+        size_t off=page*p->width+col0;
+        for(size_t i=0; i<len; ++i)
+            *w++=p->buffer[off+i];
+        memcpy(p->shadow+off, p->buffer+off, len);
+    }
+    w[-1]|=I2C_IC_DATA_CMD_STOP_BITS;
+
+    async.len[async.fill]+=w-start;
+    p->show_bytes+=ncmds+2+(len*(page1-page0+1)+1)+1;
+}
+
+// trim against the shadow, hand every run of changed pages to send, mark everything clean
+static void ssd1306_flush(ssd1306_t *p, ssd1306_window_fn send) {
+    p->show_bytes=0;
+    if(!p->full_refresh)
+        for(uint8_t page=0; page<p->pages; ++page)
+            ssd1306_trim_page(p, page);
+
+    for(uint8_t first=0, last; first<p->pages; first=last+1) {
+        last=first;
+        if(p->dirty_lo[first]>p->dirty_hi[first])
+            continue;
+
+        uint8_t lo=p->dirty_lo[first], hi=p->dirty_hi[first];
+        while(last+1<p->pages && p->dirty_lo[last+1]<=p->dirty_hi[last+1]) {
+            ++last;
+            if(p->dirty_lo[last]<lo) lo=p->dirty_lo[last];
+            if(p->dirty_hi[last]>hi) hi=p->dirty_hi[last];
+        }
+        uint8_t cmds[]= {SET_COL_ADDR, lo, hi, SET_PAGE_ADDR, first, last};
+        if(p->width==64) {
+            cmds[1]+=32;
+            cmds[2]+=32;
+        }
+        send(p, cmds, sizeof(cmds), first, last, lo, hi);
+    }
+
+    memset(p->dirty_lo, 0xff, sizeof(p->dirty_lo));
+    memset(p->dirty_hi, 0, sizeof(p->dirty_hi));
+    p->full_refresh=false;
+}
+
 void ssd1306_show(ssd1306_t *p) {
-    uint8_t payload[]= {SET_COL_ADDR, 0, p->width-1, SET_PAGE_ADDR, 0, p->pages-1};
-    if(p->width==64) {
-        payload[1]+=32;
-        payload[2]+=32;
+    ssd1306_flush(p, ssd1306_send_window);
+}
+
+static void ssd1306_dma_start(int8_t b) {
+    i2c_hw_t *hw=i2c_get_hw(async.p->i2c_i);
+
+    if((hw->tar&0x7f)!=async.p->address) { // TAR only changes with the controller disabled
+        hw->enable=0;
+        hw->tar=async.p->address;
+        hw->enable=1;
     }
+    async.on_bus=b;
+    dma_channel_set_trans_count(async.chan, async.len[b], false);
+    dma_channel_set_read_addr(async.chan, async.words[b], true);
+}
+
+// a NACK aborts the transfer and holds the tx fifo in flush, dropping every
+// later DMA write, until IC_CLR_TX_ABRT is read
+static bool ssd1306_take_abort(void) {
+    i2c_hw_t *hw=i2c_get_hw(async.p->i2c_i);
 
-    for(size_t i=0; i<sizeof(payload); ++i)
-        ssd1306_write(p, payload[i]);
+    if(!hw->tx_abrt_source)
+        return false;
+    (void)hw->clr_tx_abrt;
+    async.resend=true;
+    return true;
+}
+
+// bus idle: a NACK on the last bytes, after the DMA interrupt, shows up here
+static void ssd1306_take_late_abort(void) {
+    bool aborted;
+    uint32_t irq=save_and_disable_interrupts();
+    aborted=async.on_bus<0 && async.queued<0 && ssd1306_take_abort();
+    restore_interrupts(irq);
+    if(aborted && async.done)
+        async.done(async.p, false, async.arg);
+}
 
-    *(p->buffer-1)=0x40;
+static bool ssd1306_retry_cb(repeating_timer_t *t) {
+    (void)t;
+    async.retry_armed=false;
+    __sev();
+    return false;
+}
+
+// the frame-rate limit holds the next frame back: a caller sleeping in __wfe()
+// is woken when it ends
+static bool ssd1306_rate_limited(void) {
+    uint64_t now=time_us_64();
+
+    if(!async.min_frame_us || !async.last_us || now-async.last_us>=async.min_frame_us)
+        return false;
+    if(!async.retry_armed)
+        async.retry_armed=add_repeating_timer_us((int64_t)(async.last_us+async.min_frame_us-now),
+                                                 ssd1306_retry_cb, NULL, &async.retry);
+    return true;
+}
 
-    fancy_write(p->i2c_i, p->address, p->buffer-1, p->bufsize+1, "ssd1306_show");
+// the DMA has read the whole buffer: the next queued frame goes out right away,
+// unless a NACK dropped this one (the queued frame only holds changes on top of it)
+static void ssd1306_dma_irq_handler(void) {
+    if(!dma_channel_get_irq0_status(async.chan))
+        return;
+    dma_channel_acknowledge_irq0(async.chan);
+
+    bool ok=!ssd1306_take_abort();
+    async.on_bus=-1;
+    if(async.queued>=0) {
+        int8_t b=async.queued;
+        async.queued=-1;
+        if(ok)
+            ssd1306_dma_start(b);
+    }
+    if(async.done)
+        async.done(async.p, ok, async.arg);
+    __sev();
+}
+
+bool ssd1306_async_init(ssd1306_t *p, ssd1306_done_cb_t done, void *arg, uint32_t min_frame_us) {
+    // worst case: every page its own window, control byte and 6 commands, then control byte and data
+    size_t words=p->bufsize+p->pages*(1+6+1);
+
+    if(async.p)
+        return false;
+    if((async.words[0]=malloc(2*words*sizeof(uint16_t)))==NULL)
+        return false;
+    if((async.chan=dma_claim_unused_channel(false))<0) {
+        free(async.words[0]);
+        return false;
+    }
+    async.words[1]=async.words[0]+words;
+    async.p=p;
+    async.done=done;
+    async.arg=arg;
+    async.min_frame_us=min_frame_us;
+    async.last_us=0;
+    async.retry_armed=false;
+    async.on_bus=async.queued=-1;
+    async.resend=false;
+
+    dma_channel_config c=dma_channel_get_default_config(async.chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(p->i2c_i, true));
+    dma_channel_configure(async.chan, &c, &i2c_get_hw(p->i2c_i)->data_cmd, NULL, 0, false);
+
+    dma_channel_set_irq0_enabled(async.chan, true);
+    irq_set_exclusive_handler(DMA_IRQ_0, ssd1306_dma_irq_handler);
+    irq_set_enabled(DMA_IRQ_0, true);
+    return true;
+}
+
+bool ssd1306_show_async(ssd1306_t *p) {
+    if(async.p!=p) {
+        ssd1306_show(p);
+        return true;
+    }
+
+    if(ssd1306_rate_limited())
+        return false;
+    if(async.queued>=0) // both buffers taken: the drawing stays dirty for the next call
+        return false;
+
+    ssd1306_take_late_abort();
+    if(async.resend) { // the display may hold anything the lost transfers were to overwrite
+        async.resend=false;
+        ssd1306_mark_all(p);
+        p->full_refresh=true;
+    }
+    async.fill=async.on_bus==0?1:0;
+    async.len[async.fill]=0;
+    ssd1306_flush(p, ssd1306_queue_window);
+    if(!async.len[async.fill])
+        return true;
+    async.last_us=time_us_64();
+
+    uint32_t irq=save_and_disable_interrupts();
+    if(async.on_bus<0)
+        ssd1306_dma_start(async.fill);
+    else
+        async.queued=async.fill;
+    restore_interrupts(irq);
+    return true;
+}
+
+bool ssd1306_async_busy(ssd1306_t *p) {
+    if(async.p!=p)
+        return false;
+    if(async.on_bus>=0 || async.queued>=0)
+        return true;
+    ssd1306_take_late_abort();
+    return ssd1306_rate_limited();
+}
+
+void ssd1306_async_wait(ssd1306_t *p) {
+    if(async.p!=p)
+        return;
+    while(async.on_bus>=0 || async.queued>=0)
+        __wfe(); // the DMA interrupt does __sev()
+    while(i2c_get_hw(p->i2c_i)->status&I2C_IC_STATUS_ACTIVITY_BITS) // last bytes leaving the tx fifo
+        tight_loop_contents();
+    ssd1306_take_late_abort();
 }
 
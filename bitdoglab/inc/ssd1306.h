@@ -33,6 +33,8 @@ SOFTWARE.
 #include <pico/stdlib.h>
 #include <hardware/i2c.h>
 
+#define SSD1306_MAX_PAGES 8 /**< 64 lines */
+
 /**
 *	@brief defines commands used in ssd1306
 */
@@ -56,10 +58,22 @@ typedef enum {
     SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+typedef struct ssd1306_t_ ssd1306_t;
+
+/**
+*	@brief called from the DMA interrupt when a frame queued by ssd1306_show_async has left its transfer buffer
+*
+*	ok is false when the display did not acknowledge: the frame, and any frame
+*	queued behind it, was dropped and the next ssd1306_show_async sends every
+*	page. A NACK on the last bytes, after the interrupt, is reported the same
+*	way from the next ssd1306_show_async, ssd1306_async_busy or ssd1306_async_wait.
+*/
+typedef void (*ssd1306_done_cb_t)(ssd1306_t *p, bool ok, void *arg);
+
 /**
 *	@brief holds the configuration
 */
-typedef struct {
+struct ssd1306_t_ {
     uint8_t width; 		/**< width of display */
     uint8_t height; 	/**< height of display */
     uint8_t pages;		/**< stores pages of display (calculated on initialization*/
@@ -68,7 +82,13 @@ typedef struct {
     bool external_vcc; 	/**< whether display uses external vcc */ 
     uint8_t *buffer;	/**< display buffer */
     size_t bufsize;		/**< buffer size */
-} ssd1306_t;
+    uint8_t *shadow;	/**< display RAM as of the last show, to skip unchanged bytes */
+    uint8_t *txbuf;		/**< control byte + commands or window data of one i2c transfer */
+    uint8_t dirty_lo[SSD1306_MAX_PAGES];	/**< first column drawn on each page since the last show */
+    uint8_t dirty_hi[SSD1306_MAX_PAGES];	/**< last column drawn on each page (lo>hi: page untouched) */
+    bool full_refresh;	/**< next show sends every page, shadow or not */
+    size_t show_bytes;	/**< bytes put on the i2c bus by the last show (address bytes included) */
+};
 
 /**
 *	@brief initialize display
@@ -130,11 +150,82 @@ void ssd1306_invert(ssd1306_t *p, uint8_t inv);
 /**
 	@brief display buffer, should be called on change
 
+	Only pages drawn since the last call are considered, and within them only
+	the columns that differ from what the display already has. Each run of
+	consecutive changed pages goes out as one SET_COL_ADDR/SET_PAGE_ADDR window;
+	the bus cost ends up in p->show_bytes.
+
 	@param[in] p : instance of display
 
 */
 void ssd1306_show(ssd1306_t *p);
 
+/**
+	@brief send a command sequence in one i2c transfer
+
+	The commands and their arguments follow a single 0x00 control byte,
+	instead of one start/address/control phase per byte.
+
+	@param[in] p : instance of display
+	@param[in] cmds : commands and arguments
+	@param[in] len : number of bytes in cmds, at most p->bufsize
+*/
+void ssd1306_write_cmds(ssd1306_t *p, const uint8_t *cmds, size_t len);
+
+/**
+	@brief enable the non-blocking show path for this display
+
+	Claims a DMA channel paced by the i2c tx DREQ and two transfer buffers,
+	and installs the DMA_IRQ_0 handler on the calling core. Only one display
+	can use it. Other blocking calls of this driver wait for the DMA first;
+	other users of the same i2c bus must call ssd1306_async_wait.
+
+	@param[in] p : instance of display
+	@param[in] done : completion callback, may be NULL
+	@param[in] arg : passed to done
+	@param[in] min_frame_us : minimum time between queued frames (0: no limit)
+
+	@return bool.
+	@retval true for Success
+	@retval false if out of memory or DMA channels
+*/
+bool ssd1306_async_init(ssd1306_t *p, ssd1306_done_cb_t done, void *arg, uint32_t min_frame_us);
+
+/**
+	@brief non-blocking show
+
+	Copies the changed windows (see ssd1306_show) into a free transfer buffer
+	and sends them by DMA; the display buffer can be drawn again as soon as
+	this returns. Falls back to ssd1306_show if async is not enabled.
+
+	@param[in] p : instance of display
+
+	@return bool.
+	@retval true if the frame was queued (or nothing changed)
+	@retval false if both buffers are busy or the frame-rate limit applies; the drawing stays pending for the next call.
+	The DMA interrupt or, for the limit, a one-shot timer does __sev() when a retry can succeed
+*/
+bool ssd1306_show_async(ssd1306_t *p);
+
+/**
+	@brief whether a frame is still on its way to the display, or the
+	frame-rate limit still holds the next one back
+
+	Once idle, also clears a NACK on the last bytes and reports it to done.
+	While the limit holds, a one-shot timer does __sev() when it ends, so a
+	caller can sleep in __wfe() until this turns false.
+
+	@param[in] p : instance of display
+*/
+bool ssd1306_async_busy(ssd1306_t *p);
+
+/**
+	@brief wait until queued frames are out and the bus is idle
+
+	@param[in] p : instance of display
+*/
+void ssd1306_async_wait(ssd1306_t *p);
+
 /**
 	@brief clear display buffer
 
@@ -0,0 +1,100 @@
+// channel.c
+#include "channel.h"
+
+#include <math.h>
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define SPEED_OF_LIGHT  299792458.0
+#define FXOSC_HZ        32000000.0
+#define SNR_MAX_DB      10.0    // O SX1276 não reporta muito acima disso
+
+// Larguras de banda na ordem do código de RegModemConfig1
+static const double bw_table[] = {
+    7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000
+};
+
+// Limiar de SNR por SF (SF6..SF12)
+static const double snr_min[] = { -5.0, -7.5, -10.0, -12.5, -15.0, -17.5, -20.0 };
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+// xorshift64*: sequência reprodutível a partir da semente
+static double uniform(channel_t *ch) {
+    ch->rng ^= ch->rng >> 12;
+    ch->rng ^= ch->rng << 25;
+    ch->rng ^= ch->rng >> 27;
+    return (double)((ch->rng * 2685821657736338717ull) >> 11) / 9007199254740992.0;
+}
+
+static double gaussian(channel_t *ch) {
+    double u1 = uniform(ch), u2 = uniform(ch);
+
+    if (u1 < 1e-12) u1 = 1e-12;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+void channel_defaults(channel_cfg_t *cfg) {
+    cfg->tx_dbm = 20.0;
+    cfg->ple = 2.7;
+    cfg->shadow_db = 0.0;
+    cfg->nf_db = 6.0;
+    cfg->loss = 0.0;
+    cfg->capture_db = 6.0;
+    cfg->seed = 1;
+}
+
+void channel_init(channel_t *ch, const channel_cfg_t *cfg) {
+    ch->cfg = *cfg;
+    ch->rng = cfg->seed ? cfg->seed : 1;
+}
+
+double channel_freq_hz(const rfm95_packet_t *pkt) {
+    return pkt->frf * FXOSC_HZ / 524288.0;
+}
+
+double channel_bw_hz(const rfm95_packet_t *pkt) {
+    return pkt->bw_code < sizeof(bw_table) / sizeof(bw_table[0]) ? bw_table[pkt->bw_code] : 125000.0;
+}
+
+double channel_path_loss_db(const channel_t *ch, double dist_m, double freq_hz) {
+    double fspl_1m = 20.0 * log10(4.0 * M_PI * freq_hz / SPEED_OF_LIGHT);
+
+    if (dist_m < 1.0) dist_m = 1.0;
+    return fspl_1m + 10.0 * ch->cfg.ple * log10(dist_m);
+}
+
+double channel_noise_dbm(const channel_t *ch, double bw_hz) {
+    return -174.0 + 10.0 * log10(bw_hz) + ch->cfg.nf_db;
+}
+
+double channel_snr_min_db(uint8_t sf) {
+    if (sf < 6) sf = 6;
+    if (sf > 12) sf = 12;
+    return snr_min[sf - 6];
+}
+
+double channel_rx_power_dbm(channel_t *ch, const rfm95_packet_t *pkt, double dist_m) {
+    double p = ch->cfg.tx_dbm - channel_path_loss_db(ch, dist_m, channel_freq_hz(pkt));
+
+    if (ch->cfg.shadow_db > 0) p += ch->cfg.shadow_db * gaussian(ch);
+    return p;
+}
+
+channel_fate_t channel_apply(channel_t *ch, rfm95_packet_t *pkt, double rx_dbm) {
+    double snr = rx_dbm - channel_noise_dbm(ch, channel_bw_hz(pkt));
+
+    pkt->rssi_dbm = (int16_t)lround(rx_dbm);
+    pkt->snr_db = (float)(snr > SNR_MAX_DB ? SNR_MAX_DB : snr);
+    if (snr < channel_snr_min_db(pkt->sf)) return CHANNEL_WEAK;
+    if (ch->cfg.loss > 0 && uniform(ch) < ch->cfg.loss) return CHANNEL_LOST;
+    return CHANNEL_OK;
+}
@@ -0,0 +1,92 @@
+// channel.h - canal LoRa virtual: perda de percurso, RSSI/SNR, sensibilidade e colisões
+#ifndef CHANNEL_H_
+#define CHANNEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rfm95_model.h"
+
+// ============================================
+// === Modelo do canal ===
+// ============================================
+//
+// Perda log-distância a partir do espaço livre em d0 = 1 m, com sombreamento
+// gaussiano opcional por pacote. O ruído é o térmico na banda do pacote mais a
+// figura de ruído do receptor; o pacote só é demodulado com SNR acima do
+// limiar do SF (datasheet do SX1276, tabela 13). Uma perda aleatória extra
+// cobre o que o modelo não vê.
+//
+// Colisão: se um pacote do mesmo canal (frequência e SF) chega enquanto o
+// receptor demodula outro, o novo se perde; o que estava em curso sobrevive só
+// se for pelo menos capture_db mais forte (efeito de captura), senão termina
+// com erro de CRC.
+
+typedef struct {
+    double tx_dbm;              // Potência de saída dos TX
+    double ple;                 // Expoente de perda de percurso
+    double shadow_db;           // Desvio do sombreamento (0 = sem)
+    double nf_db;               // Figura de ruído do receptor
+    double loss;                // Probabilidade de perda extra (0..1)
+    double capture_db;          // Margem do efeito de captura
+    uint64_t seed;
+} channel_cfg_t;
+
+typedef enum {
+    CHANNEL_OK,                 // Entregue ao rádio
+    CHANNEL_WEAK,               // SNR abaixo do limiar do SF
+    CHANNEL_LOST,               // Perda aleatória
+    CHANNEL_COLLIDED,           // Chegou com o receptor ocupado
+    // Decididos pelo rádio do receptor, depois da entrega
+    CHANNEL_MISSED,             // O rádio não estava em RX (ex.: antes do firmware ligar a recepção)
+    CHANNEL_MISMATCH,           // Frequência, SF, BW ou sync word diferentes dos do rádio
+} channel_fate_t;
+
+typedef struct {
+    channel_cfg_t cfg;
+    uint64_t rng;
+} channel_t;
+
+/**
+ * @brief Configuração padrão: 20 dBm, expoente 2.7, NF 6 dB, captura 6 dB.
+ */
+void channel_defaults(channel_cfg_t *cfg);
+
+/**
+ * @brief Inicializa o canal (semente do gerador aleatório).
+ */
+void channel_init(channel_t *ch, const channel_cfg_t *cfg);
+
+/**
+ * @brief Perda de percurso a `dist_m` na frequência do pacote, em dB.
+ */
+double channel_path_loss_db(const channel_t *ch, double dist_m, double freq_hz);
+
+/**
+ * @brief Piso de ruído do receptor para a banda `bw_hz`, em dBm.
+ */
+double channel_noise_dbm(const channel_t *ch, double bw_hz);
+
+/**
+ * @brief SNR mínimo para demodular com o SF dado, em dB.
+ */
+double channel_snr_min_db(uint8_t sf);
+
+/**
+ * @brief Potência com que `pkt` chega a `dist_m`, com o sombreamento sorteado.
+ */
+double channel_rx_power_dbm(channel_t *ch, const rfm95_packet_t *pkt, double dist_m);
+
+/**
+ * @brief Preenche RSSI/SNR do pacote para o receptor e decide se ele passa
+ * (sensibilidade e perda aleatória; colisões ficam com quem chama).
+ */
+channel_fate_t channel_apply(channel_t *ch, rfm95_packet_t *pkt, double rx_dbm);
+
+/**
+ * @brief Frequência e largura de banda de um pacote, em Hz.
+ */
+double channel_freq_hz(const rfm95_packet_t *pkt);
+double channel_bw_hz(const rfm95_packet_t *pkt);
+
+#endif // CHANNEL_H_
@@ -0,0 +1,548 @@
+// link_main.c - co-simulação TX → RX: tx_sim e rx_sim ligados pelo canal LoRa virtual
+//
+//   lora_link [opções]
+//
+// Sobe um rx_sim (receptor da BitDogLab) e --tx processos tx_sim (firmware do
+// TX com `stream on <período>`), cada um ligado ao hub por um socketpair. O hub
+// mantém os relógios virtuais em passo de quantum, aplica o canal aos pacotes e
+// mede a entrega de ponta a ponta: do início da transmissão até o valor
+// aparecer no display do receptor. Sai com 1 se algum nó terminar com erro ou,
+// com --expect, se menos amostras que o pedido chegarem ao display (ctest).
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "sim_link.h"
+#include "channel.h"
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define MAX_TX_NODES    16
+
+typedef struct {
+    uint32_t       seq;
+    uint32_t       node;
+    uint64_t       start_ns;
+    uint64_t       airtime_ns;
+    rfm95_packet_t pkt;         // Como chegou ao receptor (RSSI/SNR preenchidos)
+    channel_fate_t fate;
+    bool           corrupted;   // Colisão durante a recepção
+    uint64_t       shown_ns;    // 0 = não chegou ao display
+} pkt_rec_t;
+
+typedef struct {
+    pid_t    pid;
+    int      fd;
+    bool     alive;
+    bool     rx;
+    double   dist_m;            // TX: distância até o receptor
+    uint32_t period_ms;
+    uint64_t start_ns;          // TX: quando o comando do stream chega ao console
+    int      in_fd;             // stdin do nó (-1 = já fechado)
+    char     input[64];
+    uint32_t tx_packets;
+    uint64_t airtime_ns;
+    // RX: pacote que o receptor está demodulando, visto pelo hub
+    uint32_t lock_seq;
+    uint64_t lock_end_ns;
+    double   lock_dbm;
+    // Mensagens para a próxima barreira
+    sim_link_msg_t *out;
+    size_t   nout, cap;
+} node_t;
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static node_t     nodes[MAX_TX_NODES + 1];
+static int        nnodes;
+static channel_t  channel;
+
+static pkt_rec_t *recs;
+static size_t     nrecs, recs_cap;
+static uint32_t  *pending;      // Pacotes da rodada atual
+static size_t     npending, pending_cap;
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static void *grow(void *p, size_t *cap, size_t need, size_t elem) {
+    if (need <= *cap) return p;
+    *cap = *cap ? *cap * 2 : 64;
+    if (*cap < need) *cap = need;
+    p = realloc(p, *cap * elem);
+    if (!p) {
+        perror("realloc");
+        exit(1);
+    }
+    return p;
+}
+
+static void queue_msg(node_t *n, uint32_t type, uint32_t seq, uint64_t t_ns, const rfm95_packet_t *pkt) {
+    sim_link_msg_t *m;
+
+    n->out = grow(n->out, &n->cap, n->nout + 1, sizeof(*n->out));
+    m = &n->out[n->nout++];
+    memset(m, 0, sizeof(*m));
+    m->type = type;
+    m->seq = seq;
+    m->t_ns = t_ns;
+    if (pkt) m->pkt = *pkt;
+}
+
+static pid_t spawn(char *const argv[], int link_fd, int *in_fd,
+                   const char *out_path, const char *err_path) {
+    int in[2];
+    pid_t pid;
+
+    if (pipe(in) < 0) {
+        perror("pipe");
+        exit(1);
+    }
+    pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0) {
+        int out = open(out_path ? out_path : "/dev/null", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(in[0], STDIN_FILENO);
+        if (out >= 0) dup2(out, STDOUT_FILENO);
+        if (err_path) {
+            int err = open(err_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (err >= 0) dup2(err, STDERR_FILENO);
+        }
+        close(in[0]);
+        close(in[1]);
+        fcntl(link_fd, F_SETFD, 0);     // O lado do nó sobrevive ao exec
+        execv(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+    close(in[0]);
+    fcntl(in[1], F_SETFD, FD_CLOEXEC);
+    *in_fd = in[1];
+    return pid;
+}
+
+static void start_node(node_t *n, const char *prog, char **args,
+                       const char *log_dir, const char *name, bool quiet) {
+    char *argv[16];
+    char fd_str[16], out_path[PATH_MAX], err_path[PATH_MAX];
+    int sv[2], argc = 0;
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) < 0) {
+        perror("socketpair");
+        exit(1);
+    }
+    snprintf(fd_str, sizeof(fd_str), "%d", sv[1]);
+    argv[argc++] = (char *)prog;
+    argv[argc++] = "--link-fd";
+    argv[argc++] = fd_str;
+    while (*args && argc < 14) argv[argc++] = *args++;
+    if (quiet) argv[argc++] = "--quiet";
+    argv[argc] = NULL;
+
+    if (log_dir) {
+        snprintf(out_path, sizeof(out_path), "%s/%s.out", log_dir, name);
+        snprintf(err_path, sizeof(err_path), "%s/%s.err", log_dir, name);
+        n->pid = spawn(argv, sv[1], &n->in_fd, out_path, err_path);
+    } else {
+        n->pid = spawn(argv, sv[1], &n->in_fd, NULL, NULL);
+    }
+    close(sv[1]);
+    n->fd = sv[0];
+    n->alive = true;
+}
+
+// Lê as mensagens do nó até o SYNC da barreira (ou até ele sair)
+static void collect(node_t *n, int index) {
+    sim_link_msg_t msg;
+
+    for (;;) {
+        ssize_t r = recv(n->fd, &msg, sizeof(msg), 0);
+
+        if (r != (ssize_t)sizeof(msg)) {
+            n->alive = false;
+            close(n->fd);
+            return;
+        }
+        switch (msg.type) {
+        case SIM_LINK_TX: {
+            pkt_rec_t *p;
+            recs = grow(recs, &recs_cap, nrecs + 1, sizeof(*recs));
+            p = &recs[nrecs++];
+            memset(p, 0, sizeof(*p));
+            p->seq = (uint32_t)nrecs;
+            p->node = (uint32_t)index;
+            p->start_ns = msg.pkt.start_ns;
+            p->airtime_ns = msg.pkt.airtime_ns;
+            p->pkt = msg.pkt;
+            n->tx_packets++;
+            n->airtime_ns += msg.pkt.airtime_ns;
+            pending = grow(pending, &pending_cap, npending + 1, sizeof(*pending));
+            pending[npending++] = p->seq;
+            break;
+        }
+        case SIM_LINK_SHOWN:
+            if (msg.seq && msg.seq <= nrecs && !recs[msg.seq - 1].shown_ns)
+                recs[msg.seq - 1].shown_ns = msg.t_ns;
+            break;
+        case SIM_LINK_MISSED:
+        case SIM_LINK_MISMATCH:
+            // O rádio recusou o pacote: não conta como entregue e não ocupa o receptor
+            if (!msg.seq || msg.seq > nrecs) break;
+            recs[msg.seq - 1].fate = msg.type == SIM_LINK_MISSED ? CHANNEL_MISSED : CHANNEL_MISMATCH;
+            if (n->lock_seq == msg.seq) n->lock_seq = 0;
+            break;
+        case SIM_LINK_SYNC:
+            return;
+        default:
+            break;
+        }
+    }
+}
+
+static int cmp_start(const void *a, const void *b) {
+    const pkt_rec_t *pa = &recs[*(const uint32_t *)a - 1];
+    const pkt_rec_t *pb = &recs[*(const uint32_t *)b - 1];
+    return pa->start_ns < pb->start_ns ? -1 : pa->start_ns > pb->start_ns;
+}
+
+static bool same_channel(const rfm95_packet_t *a, const rfm95_packet_t *b) {
+    return a->frf == b->frf && a->sf == b->sf && a->bw_code == b->bw_code;
+}
+
+// Aplica o canal aos pacotes da rodada, em ordem de início, para cada receptor
+static void route(void) {
+    qsort(pending, npending, sizeof(*pending), cmp_start);
+
+    for (size_t k = 0; k < npending; k++) {
+        pkt_rec_t *p = &recs[pending[k] - 1];
+
+        for (int j = 0; j < nnodes; j++) {
+            node_t *rx = &nodes[j];
+            rfm95_packet_t pkt = p->pkt;
+            double dbm;
+
+            if (!rx->rx || !rx->alive) continue;
+            dbm = channel_rx_power_dbm(&channel, &pkt, nodes[p->node].dist_m);
+
+            if (rx->lock_seq && p->start_ns < rx->lock_end_ns &&
+                same_channel(&pkt, &recs[rx->lock_seq - 1].pkt)) {
+                pkt_rec_t *locked = &recs[rx->lock_seq - 1];
+                p->fate = CHANNEL_COLLIDED;
+                p->pkt.rssi_dbm = (int16_t)dbm;
+                if (rx->lock_dbm - dbm < channel.cfg.capture_db && !locked->corrupted) {
+                    locked->corrupted = true;
+                    queue_msg(rx, SIM_LINK_CORRUPT, locked->seq, p->start_ns, NULL);
+                }
+                continue;
+            }
+
+            p->fate = channel_apply(&channel, &pkt, dbm);
+            p->pkt = pkt;
+            if (p->fate != CHANNEL_OK) continue;
+            queue_msg(rx, SIM_LINK_RX, p->seq, p->start_ns, &pkt);
+            rx->lock_seq = p->seq;
+            rx->lock_end_ns = p->start_ns + p->airtime_ns;
+            rx->lock_dbm = dbm;
+        }
+    }
+    npending = 0;
+}
+
+// Console do nó: o comando chega com o nó parado na barreira, então o firmware
+// o lê logo depois do GO, no tempo virtual certo. O EOF vem junto; o tx_sim
+// segue até --run-ms.
+static void feed_input(node_t *n, uint64_t now_ns) {
+    if (n->in_fd < 0 || now_ns < n->start_ns) return;
+    if (n->input[0] && write(n->in_fd, n->input, strlen(n->input)) < 0) perror("write");
+    close(n->in_fd);
+    n->in_fd = -1;
+}
+
+static void release(node_t *n, uint64_t next_ns) {
+    queue_msg(n, SIM_LINK_GO, 0, next_ns, NULL);
+    for (size_t i = 0; i < n->nout; i++) {
+        if (send(n->fd, &n->out[i], sizeof(n->out[i]), 0) != (ssize_t)sizeof(n->out[i])) {
+            n->alive = false;
+            close(n->fd);
+            break;
+        }
+    }
+    n->nout = 0;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static double pct(const uint64_t *v, size_t n, double p) {
+    size_t i = (size_t)(p * (double)(n - 1) + 0.5);
+    return v[i] / 1e6;
+}
+
+// Retorna o número de amostras que chegaram ao display
+static uint32_t report(uint64_t end_ns, const char *csv) {
+    uint32_t tx_total = 0, fates[6] = { 0 }, corrupted = 0, shown = 0;
+    uint64_t *lat = malloc((nrecs ? nrecs : 1) * sizeof(uint64_t));
+    uint64_t air_sum = 0, air_union = 0, cover_end = 0, tail_sum = 0;
+    double secs = end_ns / 1e9;
+
+    printf("\n=== lora_link ===\n");
+    printf("Tempo virtual:   %.3f s\n", secs);
+    for (int i = 0; i < nnodes; i++) {
+        const node_t *n = &nodes[i];
+        if (n->rx) continue;
+        printf("TX%-2d             %.0f m, período %u ms: %u pacotes, %.1f s no ar (ciclo de trabalho %.1f%%)\n",
+               i - 1, n->dist_m, n->period_ms, n->tx_packets, n->airtime_ns / 1e9,
+               secs > 0 ? 100.0 * n->airtime_ns / 1e9 / secs : 0.0);
+        tx_total += n->tx_packets;
+    }
+
+    // Ocupação do canal: união dos intervalos no ar (recs já vêm quase em ordem)
+    for (size_t i = 0; i < nrecs; i++) {
+        const pkt_rec_t *p = &recs[i];
+        uint64_t s = p->start_ns, e = p->start_ns + p->airtime_ns;
+        air_sum += p->airtime_ns;
+        if (e > cover_end) {
+            air_union += e - (s > cover_end ? s : cover_end);
+            cover_end = e;
+        }
+        fates[p->fate]++;
+        if (p->corrupted) corrupted++;
+        if (p->shown_ns) {
+            lat[shown++] = p->shown_ns - p->start_ns;
+            tail_sum += p->shown_ns - (p->start_ns + p->airtime_ns);
+        }
+    }
+    printf("Canal:           ocupação %.1f%% (carga oferecida %.1f%%)\n",
+           secs > 0 ? 100.0 * air_union / 1e9 / secs : 0.0, secs > 0 ? 100.0 * air_sum / 1e9 / secs : 0.0);
+    printf("Pacotes:         %u transmitidos, %u entregues ao rádio, %u abaixo da sensibilidade, "
+           "%u perdidos, %u em colisão (+%u corrompidos na recepção)\n",
+           tx_total, fates[CHANNEL_OK], fates[CHANNEL_WEAK], fates[CHANNEL_LOST],
+           fates[CHANNEL_COLLIDED], corrupted);
+    printf("                 recusados pelo rádio do RX: %u fora de RX, %u com configuração diferente\n",
+           fates[CHANNEL_MISSED], fates[CHANNEL_MISMATCH]);
+    printf("Amostras:        %u no display = %.3f amostras/s (oferecidas %.3f/s)\n",
+           shown, secs > 0 ? shown / secs : 0.0, secs > 0 ? tx_total / secs : 0.0);
+
+    if (shown) {
+        qsort(lat, shown, sizeof(*lat), cmp_u64);
+        printf("Latência:        início do TX → display  mín %.1f ms, p50 %.1f, p90 %.1f, p99 %.1f, máx %.1f ms\n",
+               pct(lat, shown, 0.0), pct(lat, shown, 0.5), pct(lat, shown, 0.9),
+               pct(lat, shown, 0.99), pct(lat, shown, 1.0));
+        printf("                 após o fim do pacote no ar: média %.1f ms\n", tail_sum / 1e6 / shown);
+    }
+    free(lat);
+
+    if (csv) {
+        static const char *fate_name[] = { "ok", "fraco", "perdido", "colisao", "sem_rx", "config" };
+        FILE *f = fopen(csv, "w");
+        if (!f) {
+            perror(csv);
+            return shown;
+        }
+        fprintf(f, "seq,tx,inicio_ns,no_ar_ns,rssi_dbm,snr_db,destino,corrompido,display_ns\n");
+        for (size_t i = 0; i < nrecs; i++) {
+            const pkt_rec_t *p = &recs[i];
+            fprintf(f, "%u,%u,%llu,%llu,%d,%.1f,%s,%d,%llu\n", p->seq, p->node - 1,
+                    (unsigned long long)p->start_ns, (unsigned long long)p->airtime_ns,
+                    p->pkt.rssi_dbm, p->pkt.snr_db, fate_name[p->fate], p->corrupted,
+                    (unsigned long long)p->shown_ns);
+        }
+        fclose(f);
+    }
+    return shown;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s [opções]\n"
+        "  --tx <n>             Número de transmissores (padrão 1, máx. %d)\n"
+        "  --dist <m[,m...]>    Distância de cada TX ao receptor (padrão 100; a última se repete)\n"
+        "  --period-ms <ms>     Período do stream do TX0, 1..3600000 (padrão 10000)\n"
+        "  --period-step-ms <ms> Acréscimo no período de cada TX seguinte (padrão 0)\n"
+        "  --stagger-ms <ms>    Atraso do início do stream entre TX seguidos (padrão período/n)\n"
+        "  --run-ms <ms>        Tempo virtual simulado (padrão 120000)\n"
+        "  --quantum-us <us>    Passo de sincronismo entre os nós (padrão 1000)\n"
+        "  --lux <valor>        Iluminância do TX0; os seguintes somam 10 lux cada (padrão 250)\n"
+        "  --tx-dbm <dBm>       Potência dos TX (padrão 20, como lora.power)\n"
+        "  --ple <n>            Expoente de perda de percurso (padrão 2.7)\n"
+        "  --shadow-db <dB>     Desvio do sombreamento por pacote (padrão 0)\n"
+        "  --nf-db <dB>         Figura de ruído do receptor (padrão 6)\n"
+        "  --loss <p>           Perda aleatória extra, 0..1 (padrão 0)\n"
+        "  --capture-db <dB>    Margem do efeito de captura (padrão 6)\n"
+        "  --seed <n>           Semente do canal (padrão 1)\n"
+        "  --csv <arquivo>      Um registro por pacote\n"
+        "  --expect <n>         Falha (status 1) com menos de n amostras no display\n"
+        "  --log-dir <dir>      Saídas e relatórios de cada nó em <dir>\n"
+        "  --tx-sim <caminho>   Executável do TX (padrão: ao lado do lora_link)\n"
+        "  --rx-sim <caminho>   Executável do RX\n", prog, MAX_TX_NODES);
+}
+
+// ============================================
+// === main ===
+// ============================================
+
+int main(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "tx",             required_argument, NULL, 'n' },
+        { "dist",           required_argument, NULL, 'd' },
+        { "period-ms",      required_argument, NULL, 'p' },
+        { "period-step-ms", required_argument, NULL, 'P' },
+        { "stagger-ms",     required_argument, NULL, 'g' },
+        { "run-ms",         required_argument, NULL, 't' },
+        { "quantum-us",     required_argument, NULL, 'Q' },
+        { "lux",            required_argument, NULL, 'l' },
+        { "tx-dbm",         required_argument, NULL, 'w' },
+        { "ple",            required_argument, NULL, 'e' },
+        { "shadow-db",      required_argument, NULL, 's' },
+        { "nf-db",          required_argument, NULL, 'N' },
+        { "loss",           required_argument, NULL, 'L' },
+        { "capture-db",     required_argument, NULL, 'c' },
+        { "seed",           required_argument, NULL, 'S' },
+        { "csv",            required_argument, NULL, 'C' },
+        { "expect",         required_argument, NULL, 'x' },
+        { "log-dir",        required_argument, NULL, 'D' },
+        { "tx-sim",         required_argument, NULL, 'T' },
+        { "rx-sim",         required_argument, NULL, 'R' },
+        { "help",           no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    channel_cfg_t cfg;
+    int ntx = 1, c;
+    double dist[MAX_TX_NODES];
+    int ndist = 0;
+    uint32_t period_ms = 10000, period_step_ms = 0;
+    int64_t stagger_ms = -1;
+    uint64_t run_ms = 120000, quantum_ns = 1000000;
+    double lux = 250.0;
+    const char *csv = NULL, *log_dir = NULL;
+    char tx_path[PATH_MAX], rx_path[PATH_MAX], self[PATH_MAX];
+    const char *tx_sim = NULL, *rx_sim = NULL;
+    uint64_t barrier_ns = 0;
+    uint32_t expect = 0, shown;
+    bool failed = false;
+
+    channel_defaults(&cfg);
+    while ((c = getopt_long(argc, argv, "h", opts, NULL)) != -1) {
+        switch (c) {
+        case 'n': ntx = atoi(optarg); break;
+        case 'd': {
+            char *tok = strtok(optarg, ",");
+            while (tok && ndist < MAX_TX_NODES) {
+                dist[ndist++] = atof(tok);
+                tok = strtok(NULL, ",");
+            }
+            break;
+        }
+        case 'p': period_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'P': period_step_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'g': stagger_ms = strtoll(optarg, NULL, 0); break;
+        case 't': run_ms = strtoull(optarg, NULL, 0); break;
+        case 'Q': quantum_ns = strtoull(optarg, NULL, 0) * 1000ull; break;
+        case 'l': lux = atof(optarg); break;
+        case 'w': cfg.tx_dbm = atof(optarg); break;
+        case 'e': cfg.ple = atof(optarg); break;
+        case 's': cfg.shadow_db = atof(optarg); break;
+        case 'N': cfg.nf_db = atof(optarg); break;
+        case 'L': cfg.loss = atof(optarg); break;
+        case 'c': cfg.capture_db = atof(optarg); break;
+        case 'S': cfg.seed = strtoull(optarg, NULL, 0); break;
+        case 'C': csv = optarg; break;
+        case 'x': expect = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'D': log_dir = optarg; break;
+        case 'T': tx_sim = optarg; break;
+        case 'R': rx_sim = optarg; break;
+        default:  usage(argv[0]); return c == 'h' ? 0 : 2;
+        }
+    }
+    // O console do TX recusa `stream on 0`
+    if (ntx < 1 || ntx > MAX_TX_NODES || !quantum_ns || !period_ms) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // tx_sim e rx_sim ficam no mesmo diretório de build
+    snprintf(self, sizeof(self), "%s", argv[0]);
+    snprintf(tx_path, sizeof(tx_path), "%s/tx_sim", dirname(self));
+    snprintf(self, sizeof(self), "%s", argv[0]);
+    snprintf(rx_path, sizeof(rx_path), "%s/rx_sim", dirname(self));
+    if (!tx_sim) tx_sim = tx_path;
+    if (!rx_sim) rx_sim = rx_path;
+
+    channel_init(&channel, &cfg);
+    if (stagger_ms < 0) stagger_ms = period_ms / ntx;
+
+    {
+        char run_str[32];
+        char *rx_args[] = { "--run-ms", run_str, NULL };
+        snprintf(run_str, sizeof(run_str), "%llu", (unsigned long long)run_ms);
+        nodes[0].rx = true;
+        start_node(&nodes[0], rx_sim, rx_args, log_dir, "rx", !log_dir);
+        nnodes = 1;
+    }
+    for (int i = 0; i < ntx; i++) {
+        node_t *n = &nodes[nnodes];
+        char run_str[32], lux_str[32], name[16];
+        char *tx_args[] = { "--run-ms", run_str, "--lux", lux_str, NULL };
+
+        n->dist_m = ndist ? dist[i < ndist ? i : ndist - 1] : 100.0;
+        n->period_ms = period_ms + (uint32_t)i * period_step_ms;
+        snprintf(run_str, sizeof(run_str), "%llu", (unsigned long long)run_ms);
+        snprintf(lux_str, sizeof(lux_str), "%.2f", lux + 10.0 * i);
+        snprintf(name, sizeof(name), "tx%d", i);
+        n->start_ns = (uint64_t)stagger_ms * (uint64_t)i * 1000000ull;
+        snprintf(n->input, sizeof(n->input), "stream on %u\n", n->period_ms);
+        start_node(n, tx_sim, tx_args, log_dir, name, !log_dir);
+        nnodes++;
+    }
+
+    // Passo de quantum: todos chegam na barreira, o canal roda, todos seguem
+    for (;;) {
+        int alive = 0;
+
+        for (int i = 0; i < nnodes; i++)
+            if (nodes[i].alive) collect(&nodes[i], i);
+        route();
+        for (int i = 0; i < nnodes; i++) {
+            if (!nodes[i].alive) continue;
+            feed_input(&nodes[i], barrier_ns);
+            release(&nodes[i], barrier_ns + quantum_ns);
+            alive += nodes[i].alive;
+        }
+        if (!alive) break;
+        barrier_ns += quantum_ns;
+    }
+
+    for (int i = 0; i < nnodes; i++) {
+        int status;
+        waitpid(nodes[i].pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "%s %d terminou com erro (status 0x%x)\n",
+                    nodes[i].rx ? "rx" : "tx", nodes[i].rx ? 0 : i - 1, status);
+            failed = true;
+        }
+    }
+    shown = report(barrier_ns < run_ms * 1000000ull ? barrier_ns : run_ms * 1000000ull, csv);
+    if (shown < expect) {
+        fprintf(stderr, "lora_link: %u amostras no display, esperadas %u\n", shown, expect);
+        failed = true;
+    }
+    return failed ? 1 : 0;
+}
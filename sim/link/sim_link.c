@@ -0,0 +1,110 @@
+// sim_link.c - lado do nó no canal virtual: barreiras de tempo, pacotes e avisos
+#include "sim_link.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static int             link_fd = -1;
+static rfm95_model_t  *link_radio;
+static uint64_t        barrier_ns;  // Próximo SYNC (0: o primeiro sai no início)
+static uint32_t        rx_seq;      // Pacote aceito pelo rádio
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static void link_send(const sim_link_msg_t *msg) {
+    if (send(link_fd, msg, sizeof(*msg), 0) != (ssize_t)sizeof(*msg)) {
+        fprintf(stderr, "sim_link: hub fechou a ligação\n");
+        exit(1);
+    }
+}
+
+static void on_tx(void *arg, const rfm95_packet_t *pkt) {
+    sim_link_msg_t msg = { .type = SIM_LINK_TX, .t_ns = sim_time_ns(), .pkt = *pkt };
+
+    (void)arg;
+    link_send(&msg);
+}
+
+// SYNC e espera do GO, aplicando o que o hub mandou para este nó
+static void barrier(void) {
+    sim_link_msg_t msg = { .type = SIM_LINK_SYNC, .t_ns = barrier_ns };
+
+    link_send(&msg);
+    for (;;) {
+        ssize_t n = recv(link_fd, &msg, sizeof(msg), 0);
+
+        if (n != (ssize_t)sizeof(msg)) {
+            fprintf(stderr, "sim_link: hub fechou a ligação\n");
+            exit(1);
+        }
+        switch (msg.type) {
+        case SIM_LINK_RX: {
+            uint32_t mismatch;
+            sim_link_msg_t reply = { .seq = msg.seq, .t_ns = msg.t_ns };
+
+            if (!link_radio) break;
+            mismatch = link_radio->stats.rx_mismatch;
+            if (rfm95_model_rx_begin(link_radio, &msg.pkt)) {
+                rx_seq = msg.seq;
+                break;
+            }
+            reply.type = link_radio->stats.rx_mismatch != mismatch ? SIM_LINK_MISMATCH : SIM_LINK_MISSED;
+            link_send(&reply);
+            break;
+        }
+        case SIM_LINK_CORRUPT:
+            if (link_radio && msg.seq == rx_seq) rfm95_model_rx_corrupt(link_radio);
+            break;
+        case SIM_LINK_GO:
+            barrier_ns = msg.t_ns;
+            return;
+        default:
+            break;
+        }
+    }
+}
+
+static uint64_t link_next(void *ctx) {
+    (void)ctx;
+    return barrier_ns;
+}
+
+static void link_poll(void *ctx) {
+    (void)ctx;
+    while (sim_time_ns() >= barrier_ns) barrier();
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+void sim_link_open(int fd, sim_link_role_t role, rfm95_model_t *radio) {
+    link_fd = fd;
+    link_radio = radio;
+    barrier_ns = 0;
+    rx_seq = 0;
+    if (radio && role == SIM_LINK_ROLE_TX) radio->on_tx = on_tx;
+}
+
+sim_source_t sim_link_source(void) {
+    return (sim_source_t){ link_next, link_poll, NULL };
+}
+
+uint32_t sim_link_rx_seq(void) {
+    return rx_seq;
+}
+
+void sim_link_shown(uint32_t seq) {
+    sim_link_msg_t msg = { .type = SIM_LINK_SHOWN, .seq = seq, .t_ns = sim_time_ns() };
+
+    if (link_fd >= 0) link_send(&msg);
+}
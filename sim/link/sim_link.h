@@ -0,0 +1,75 @@
+// sim_link.h - ligação de um firmware simulado ao canal LoRa virtual (lora_link)
+#ifndef SIM_LINK_H_
+#define SIM_LINK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_dev.h"
+#include "rfm95_model.h"
+
+// ============================================
+// === Canal virtual ===
+// ============================================
+//
+// O lora_link roda um processo por nó (tx_sim, rx_sim), cada um com o seu
+// tempo virtual, ligados a ele por um socketpair (SOCK_SEQPACKET) herdado no
+// --link-fd. O tempo anda em quanta: ao chegar na barreira, o nó manda SYNC e
+// espera o GO com a próxima; o hub só libera quando todos chegaram, então
+// nenhum nó fica mais de um quantum à frente dos outros.
+//
+// O TX manda cada pacote no início da transmissão (on_tx do modelo). Na
+// barreira seguinte o hub aplica o canal (perda de percurso, RSSI/SNR,
+// sensibilidade, colisões) e entrega o pacote ao rádio dos receptores com o
+// instante de início original; o quantum precisa ser menor que o tempo até o
+// ValidHeader. Uma colisão descoberta depois marca o pacote em curso como
+// corrompido. O RX avisa quando o firmware usou o pacote (SHOWN), para a
+// latência de ponta a ponta, e quando o rádio recusou o pacote entregue
+// (MISSED: fora de RX, antes do firmware ligar a recepção; MISMATCH:
+// frequência, SF, BW ou sync word diferentes).
+
+typedef enum {
+    SIM_LINK_TX = 1,            // nó → hub: pacote transmitido (início)
+    SIM_LINK_SYNC,              // nó → hub: chegou na barreira t_ns
+    SIM_LINK_SHOWN,             // nó → hub: pacote seq usado pela aplicação em t_ns
+    SIM_LINK_RX,                // hub → nó: pacote para o rádio
+    SIM_LINK_CORRUPT,           // hub → nó: pacote seq colidiu durante a recepção
+    SIM_LINK_GO,                // hub → nó: pode avançar até t_ns
+    SIM_LINK_MISSED,            // nó → hub: o rádio não estava em RX para o pacote seq
+    SIM_LINK_MISMATCH,          // nó → hub: o rádio está configurado diferente do pacote seq
+} sim_link_type_t;
+
+typedef struct {
+    uint32_t       type;
+    uint32_t       seq;         // Número do pacote, dado pelo hub (0 = nenhum)
+    uint64_t       t_ns;
+    rfm95_packet_t pkt;
+} sim_link_msg_t;
+
+typedef enum {
+    SIM_LINK_ROLE_TX,
+    SIM_LINK_ROLE_RX,
+} sim_link_role_t;
+
+/**
+ * @brief Liga o processo ao hub pelo descritor herdado e prende o rádio ao canal
+ * (TX: on_tx do modelo; RX: recebe os pacotes entregues).
+ */
+void sim_link_open(int fd, sim_link_role_t role, rfm95_model_t *radio);
+
+/**
+ * @brief Fonte de eventos das barreiras, para registrar na plataforma.
+ */
+sim_source_t sim_link_source(void);
+
+/**
+ * @brief Pacote que o rádio está recebendo (ou recebeu por último); 0 = nenhum.
+ */
+uint32_t sim_link_rx_seq(void);
+
+/**
+ * @brief Avisa o hub que a aplicação usou o pacote `seq` agora.
+ */
+void sim_link_shown(uint32_t seq);
+
+#endif // SIM_LINK_H_
@@ -0,0 +1,9 @@
+// console.h - libbase (console.h) para o build nativo (sim/)
+#ifndef __CONSOLE_H
+#define __CONSOLE_H
+
+char readchar(void);
+int readchar_nonblock(void);
+void putsnonl(const char *s);
+
+#endif
@@ -0,0 +1,159 @@
+// csr.h - mapa de CSRs do colorlight_i5 para o build nativo (sim/)
+// Mesmos endereços e campos de build/colorlight_i5/software/include/generated/csr.h
+// para os periféricos usados pelo firmware; os acessos passam por
+// csr_read_simple()/csr_write_simple() do barramento simulado.
+#include <generated/soc.h>
+#ifndef __GENERATED_CSR_H
+#define __GENERATED_CSR_H
+#include <stdint.h>
+#include <system.h>
+#include <hw/common.h>
+
+#ifndef CSR_BASE
+#define CSR_BASE 0xf0000000L
+#endif /* ! CSR_BASE */
+
+//--------------------------------------------------------------------------------
+// CSR Registers/Fields Definition.
+//--------------------------------------------------------------------------------
+
+/* SPI Registers */
+#define CSR_SPI_BASE (CSR_BASE + 0x0L)
+#define CSR_SPI_CONTROL_ADDR (CSR_BASE + 0x0L)
+#define CSR_SPI_STATUS_ADDR (CSR_BASE + 0x4L)
+#define CSR_SPI_MOSI_ADDR (CSR_BASE + 0x8L)
+#define CSR_SPI_MISO_ADDR (CSR_BASE + 0xcL)
+#define CSR_SPI_CS_ADDR (CSR_BASE + 0x10L)
+#define CSR_SPI_LOOPBACK_ADDR (CSR_BASE + 0x14L)
+
+/* SPI Fields */
+#define CSR_SPI_CONTROL_START_OFFSET 0
+#define CSR_SPI_CONTROL_START_SIZE 1
+#define CSR_SPI_CONTROL_LENGTH_OFFSET 8
+#define CSR_SPI_CONTROL_LENGTH_SIZE 8
+#define CSR_SPI_STATUS_DONE_OFFSET 0
+#define CSR_SPI_STATUS_DONE_SIZE 1
+#define CSR_SPI_STATUS_MODE_OFFSET 1
+#define CSR_SPI_STATUS_MODE_SIZE 1
+#define CSR_SPI_CS_SEL_OFFSET 0
+#define CSR_SPI_CS_SEL_SIZE 1
+#define CSR_SPI_CS_MODE_OFFSET 16
+#define CSR_SPI_CS_MODE_SIZE 1
+#define CSR_SPI_LOOPBACK_MODE_OFFSET 0
+#define CSR_SPI_LOOPBACK_MODE_SIZE 1
+
+/* LORA_RESET Registers */
+#define CSR_LORA_RESET_BASE (CSR_BASE + 0x800L)
+#define CSR_LORA_RESET_OUT_ADDR (CSR_BASE + 0x800L)
+
+/* I2C Registers */
+#define CSR_I2C_BASE (CSR_BASE + 0x1000L)
+#define CSR_I2C_W_ADDR (CSR_BASE + 0x1000L)
+#define CSR_I2C_R_ADDR (CSR_BASE + 0x1004L)
+
+/* I2C Fields */
+#define CSR_I2C_W_SCL_OFFSET 0
+#define CSR_I2C_W_SCL_SIZE 1
+#define CSR_I2C_W_OE_OFFSET 1
+#define CSR_I2C_W_OE_SIZE 1
+#define CSR_I2C_W_SDA_OFFSET 2
+#define CSR_I2C_W_SDA_SIZE 1
+#define CSR_I2C_R_SDA_OFFSET 0
+#define CSR_I2C_R_SDA_SIZE 1
+
+/* CTRL Registers */
+#define CSR_CTRL_BASE (CSR_BASE + 0x1800L)
+#define CSR_CTRL_RESET_ADDR (CSR_BASE + 0x1800L)
+#define CSR_CTRL_SCRATCH_ADDR (CSR_BASE + 0x1804L)
+
+/* LEDS Registers */
+#define CSR_LEDS_BASE (CSR_BASE + 0x2800L)
+#define CSR_LEDS_OUT_ADDR (CSR_BASE + 0x2800L)
+
+/* SPIFLASH Registers */
+#define CSR_SPIFLASH_BASE (CSR_BASE + 0x3800L)
+#define CSR_SPIFLASH_MASTER_CS_ADDR (CSR_BASE + 0x3808L)
+
+/* TIMER0 Registers */
+#define CSR_TIMER0_BASE (CSR_BASE + 0x4000L)
+#define CSR_TIMER0_UPTIME_LATCH_ADDR (CSR_BASE + 0x4020L)
+#define CSR_TIMER0_UPTIME_CYCLES_ADDR (CSR_BASE + 0x4024L)
+
+//--------------------------------------------------------------------------------
+// CSR Registers Access Functions.
+//--------------------------------------------------------------------------------
+
+/* SPI Access Functions */
+static inline void spi_control_write(uint32_t v) {
+	csr_write_simple(v, CSR_SPI_CONTROL_ADDR);
+}
+static inline uint32_t spi_status_read(void) {
+	return csr_read_simple(CSR_SPI_STATUS_ADDR);
+}
+static inline void spi_mosi_write(uint32_t v) {
+	csr_write_simple(v, CSR_SPI_MOSI_ADDR);
+}
+static inline uint32_t spi_miso_read(void) {
+	return csr_read_simple(CSR_SPI_MISO_ADDR);
+}
+static inline uint32_t spi_cs_read(void) {
+	return csr_read_simple(CSR_SPI_CS_ADDR);
+}
+static inline void spi_cs_write(uint32_t v) {
+	csr_write_simple(v, CSR_SPI_CS_ADDR);
+}
+static inline uint32_t spi_loopback_read(void) {
+	return csr_read_simple(CSR_SPI_LOOPBACK_ADDR);
+}
+static inline void spi_loopback_write(uint32_t v) {
+	csr_write_simple(v, CSR_SPI_LOOPBACK_ADDR);
+}
+
+/* LORA_RESET Access Functions */
+static inline uint32_t lora_reset_out_read(void) {
+	return csr_read_simple(CSR_LORA_RESET_OUT_ADDR);
+}
+static inline void lora_reset_out_write(uint32_t v) {
+	csr_write_simple(v, CSR_LORA_RESET_OUT_ADDR);
+}
+
+/* I2C Access Functions */
+static inline uint32_t i2c_w_read(void) {
+	return csr_read_simple(CSR_I2C_W_ADDR);
+}
+static inline void i2c_w_write(uint32_t v) {
+	csr_write_simple(v, CSR_I2C_W_ADDR);
+}
+static inline uint32_t i2c_r_read(void) {
+	return csr_read_simple(CSR_I2C_R_ADDR);
+}
+
+/* CTRL Access Functions */
+static inline void ctrl_reset_write(uint32_t v) {
+	csr_write_simple(v, CSR_CTRL_RESET_ADDR);
+}
+static inline uint32_t ctrl_scratch_read(void) {
+	return csr_read_simple(CSR_CTRL_SCRATCH_ADDR);
+}
+static inline void ctrl_scratch_write(uint32_t v) {
+	csr_write_simple(v, CSR_CTRL_SCRATCH_ADDR);
+}
+
+/* LEDS Access Functions */
+static inline uint32_t leds_out_read(void) {
+	return csr_read_simple(CSR_LEDS_OUT_ADDR);
+}
+static inline void leds_out_write(uint32_t v) {
+	csr_write_simple(v, CSR_LEDS_OUT_ADDR);
+}
+
+/* TIMER0 Access Functions */
+static inline void timer0_uptime_latch_write(uint32_t v) {
+	csr_write_simple(v, CSR_TIMER0_UPTIME_LATCH_ADDR);
+}
+static inline uint64_t timer0_uptime_cycles_read(void) {
+	return ((uint64_t)csr_read_simple(CSR_TIMER0_UPTIME_CYCLES_ADDR) << 32) |
+	       csr_read_simple(CSR_TIMER0_UPTIME_CYCLES_ADDR + 4);
+}
+
+#endif /* ! __GENERATED_CSR_H */
@@ -0,0 +1,16 @@
+// mem.h - regiões de memória do SoC para o build nativo (sim/)
+// A flash SPI mapeada em memória é um vetor do shim (spiflash.c).
+#ifndef __GENERATED_MEM_H
+#define __GENERATED_MEM_H
+
+#include <stdint.h>
+
+extern uint8_t sim_flash[];
+
+#define SPIFLASH_BASE ((uintptr_t)sim_flash)
+#define SPIFLASH_SIZE 0x00800000
+
+#define SRAM_SIZE     0x00002000
+#define MAIN_RAM_SIZE 0x00800000
+
+#endif
@@ -0,0 +1,27 @@
+// soc.h - constantes do SoC colorlight_i5 para o build nativo (sim/)
+// Mesmos valores de build/colorlight_i5/software/include/generated/soc.h
+// usados pelo firmware.
+#ifndef __GENERATED_SOC_H
+#define __GENERATED_SOC_H
+
+#define CONFIG_PLATFORM_NAME "colorlight_i5"
+#define CONFIG_CLOCK_FREQUENCY 60000000
+#define CONFIG_CPU_HAS_INTERRUPT
+#define CONFIG_CPU_TYPE_VEXRISCV
+#define CONFIG_CPU_FAMILY "riscv"
+#define CONFIG_CPU_NAME "vexriscv"
+#define CONFIG_IDENTIFIER "LiteX SoC on Colorlight I5 (sim nativo)"
+#define SPIFLASH_PHY_FREQUENCY 15000000
+#define SPIFLASH_MODULE_NAME "w25q64"
+#define SPIFLASH_MODULE_TOTAL_SIZE 8388608
+#define SPIFLASH_MODULE_PAGE_SIZE 256
+#define CONFIG_CSR_DATA_WIDTH 32
+#define CONFIG_CSR_ALIGNMENT 32
+#define CONFIG_CSR_ORDERING_BIG
+#define CONFIG_BUS_DATA_WIDTH 32
+#define CONFIG_CPU_INTERRUPTS 2
+#define TIMER0_INTERRUPT 1
+#define UART_INTERRUPT 0
+#define CONFIG_HAS_I2C
+
+#endif
@@ -0,0 +1,12 @@
+// common.h - acesso aos CSRs no build nativo (sim/)
+// Em vez de ponteiros para o barramento, cada acesso vai para o barramento
+// simulado (soc.c), que o despacha para os modelos de dispositivo.
+#ifndef __HW_COMMON_H
+#define __HW_COMMON_H
+
+#include <stdint.h>
+
+uint32_t csr_read_simple(unsigned long addr);
+void csr_write_simple(uint32_t value, unsigned long addr);
+
+#endif
@@ -0,0 +1,12 @@
+// spiflash.h - liblitespi para o build nativo (sim/): flash em sim_flash[]
+#ifndef __LITESPI_FLASH_H
+#define __LITESPI_FLASH_H
+
+#include <stdint.h>
+
+void spiflash_init(void);
+int spiflash_erase_4k_sector(uint32_t addr);
+void spiflash_erase_range(uint32_t addr, uint32_t len);
+int spiflash_write_stream(uint32_t addr, uint8_t *stream, uint32_t len);
+
+#endif
@@ -0,0 +1,14 @@
+// system.h - libbase (system.h) para o build nativo (sim/)
+#ifndef __SYSTEM_H
+#define __SYSTEM_H
+
+/** @brief Espera ativa: avança o tempo virtual em `us`. */
+void busy_wait_us(unsigned int us);
+void busy_wait(unsigned int ms);
+
+/* Sem caches no host */
+static inline void flush_cpu_icache(void) {}
+static inline void flush_cpu_dcache(void) {}
+static inline void flush_l2_cache(void) {}
+
+#endif
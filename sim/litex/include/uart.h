@@ -0,0 +1,11 @@
+// uart.h - libbase (uart.h) para o build nativo (sim/): stdin/stdout do processo
+#ifndef __UART_H
+#define __UART_H
+
+void uart_init(void);
+void uart_sync(void);
+void uart_write(char c);
+char uart_read(void);
+int uart_read_nonblock(void);
+
+#endif
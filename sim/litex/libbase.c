@@ -0,0 +1,185 @@
+// libbase.c - UART, console, esperas e CRC da libbase para o build nativo
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <uart.h>
+#include <console.h>
+#include <system.h>
+#include <crc.h>
+#include <generated/soc.h>
+
+#include "sim_soc.h"
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static bool     realtime;
+static uint64_t run_ns;
+static uint32_t baud = 115200;
+static bool     eof;
+static uint64_t wall_start_ns;
+
+static uint8_t  rx_buf[256];
+static size_t   rx_len, rx_pos;
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static uint64_t wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// stdout passa por aqui: printf() e uart_write() contam como bytes da UART
+static ssize_t uart_cookie_write(void *cookie, const char *buf, size_t len) {
+    size_t done = 0;
+    (void)cookie;
+
+    while (done < len) {
+        ssize_t n = write(STDOUT_FILENO, buf + done, len - done);
+        if (n <= 0) return done ? (ssize_t)done : -1;
+        done += (size_t)n;
+    }
+    // A UART da LiteX bloqueia com o FIFO cheio: o firmware anda no ritmo do baud
+    sim_soc_stats()->uart_tx += len;
+    if (baud) sim_soc_advance_ns((uint64_t)len * 10 * 1000000000ull / baud);
+    return (ssize_t)len;
+}
+
+// Lê o que houver no stdin sem bloquear
+static void rx_fill(void) {
+    struct pollfd p = { .fd = STDIN_FILENO, .events = POLLIN };
+    ssize_t n;
+
+    if (eof || rx_pos < rx_len) return;
+    if (poll(&p, 1, 0) <= 0) return;
+    n = read(STDIN_FILENO, rx_buf, sizeof(rx_buf));
+    if (n <= 0) {
+        eof = true;
+        return;
+    }
+    rx_len = (size_t)n;
+    rx_pos = 0;
+}
+
+// Sem entrada: sai, ou segue até run_ns; no modo realtime espera o relógio real
+static void rx_idle(void) {
+    uint64_t now = sim_time_ns();
+
+    fflush(stdout);
+    if (eof && now >= run_ns) sim_soc_exit(0);
+    if (realtime) {
+        uint64_t wall = wall_ns() - wall_start_ns;
+        if (now > wall + 1000000) {
+            struct timespec ts = { 0, (long)(now - wall) };
+            if (ts.tv_nsec > 10000000) ts.tv_nsec = 10000000;
+            nanosleep(&ts, NULL);
+        }
+    }
+}
+
+// ============================================
+// === Configuração ===
+// ============================================
+
+void sim_uart_config(uint32_t rate, bool rt, uint64_t run) {
+    baud = rate;
+    realtime = rt;
+    run_ns = run;
+}
+
+// ============================================
+// === uart.h / console.h ===
+// ============================================
+
+void uart_init(void) {
+    static const cookie_io_functions_t io = { .write = uart_cookie_write };
+    FILE *f = fopencookie(NULL, "w", io);
+
+    if (f) {
+        setvbuf(f, NULL, _IOFBF, 4096);
+        stdout = f;
+    }
+    wall_start_ns = wall_ns() - sim_time_ns();
+}
+
+void uart_sync(void) {
+    fflush(stdout);
+}
+
+void uart_write(char c) {
+    putchar((unsigned char)c);
+}
+
+int uart_read_nonblock(void) {
+    sim_soc_advance_ns(SIM_CSR_ACCESS_CYCLES * 1000ull / (CONFIG_CLOCK_FREQUENCY / 1000000));
+    rx_fill();
+    if (rx_pos < rx_len) return 1;
+    rx_idle();
+    return 0;
+}
+
+char uart_read(void) {
+    while (!uart_read_nonblock()) {
+    }
+    sim_soc_stats()->uart_rx++;
+    return (char)rx_buf[rx_pos++];
+}
+
+char readchar(void) {
+    return uart_read();
+}
+
+int readchar_nonblock(void) {
+    return uart_read_nonblock();
+}
+
+void putsnonl(const char *s) {
+    fputs(s, stdout);
+}
+
+// ============================================
+// === system.h ===
+// ============================================
+
+void busy_wait_us(unsigned int us) {
+    sim_soc_advance_ns((uint64_t)us * 1000);
+}
+
+void busy_wait(unsigned int ms) {
+    sim_soc_advance_ns((uint64_t)ms * 1000000);
+}
+
+// ============================================
+// === crc.h (mesmos polinômios da libbase) ===
+// ============================================
+
+unsigned short crc16(const unsigned char *buffer, int len) {
+    uint16_t crc = 0;
+
+    while (len-- > 0) {
+        crc ^= (uint16_t)(*buffer++) << 8;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+unsigned int crc32(const unsigned char *buffer, unsigned int len) {
+    uint32_t crc = 0xFFFFFFFFu;
+
+    while (len--) {
+        crc ^= *buffer++;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+    return ~crc;
+}
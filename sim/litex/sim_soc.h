@@ -0,0 +1,112 @@
+// sim_soc.h - SoC colorlight_i5 simulado no host: barramento de CSRs, relógio e dispositivos
+#ifndef SIM_SOC_H_
+#define SIM_SOC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sim_dev.h"
+
+// ============================================
+// === SoC simulado ===
+// ============================================
+//
+// O firmware é compilado para o host com os headers de include/ no lugar dos
+// gerados pela LiteX. Cada acesso a CSR cai em csr_read_simple()/
+// csr_write_simple() (soc.c), que o despacha para o periférico correspondente
+// (SPIMaster, I2CMaster bit-bang, GPIOs, uptime do timer0) e deste para os
+// modelos de dispositivo ligados com sim_soc_attach_*().
+//
+// Não há simulação de instruções: o tempo virtual (ciclos de 60 MHz) avança
+// SIM_CSR_ACCESS_CYCLES por acesso a CSR, pela duração das transferências SPI
+// e pelas esperas do firmware (busy_wait_us, flash). Dá a ordem de grandeza do
+// tempo de barramento dos drivers; a medida por ciclo fica com o litex_sim.
+
+#define SIM_CSR_ACCESS_CYCLES   8       // Acesso Wishbone → CSR (estimativa)
+#define SIM_SPI_CLK_HZ          1000000 // spi_clk_freq do colorlight_i5.py
+#define SIM_MAX_I2C_DEVS        4
+#define SIM_MAX_SOURCES         4
+
+typedef struct {
+    uint64_t csr_reads;
+    uint64_t csr_writes;
+    uint64_t spi_bytes;         // Transferências do SPIMaster
+    uint64_t spi_selects;       // Janelas de CS
+    uint64_t i2c_writes;        // Escritas em i2c_w (bordas do bit-bang)
+    uint64_t uart_tx;           // Bytes enviados pela UART
+    uint64_t uart_rx;
+    uint64_t flash_prog;        // Bytes programados na flash
+    uint64_t flash_erase;       // Setores apagados
+    uint32_t leds;              // Último valor de leds_out
+} sim_soc_stats_t;
+
+/**
+ * @brief Zera relógio, contadores e dispositivos; a flash começa apagada (0xFF).
+ */
+void sim_soc_init(void);
+
+/**
+ * @brief Liga o escravo do SPIMaster (CS0, com o pino lora_reset).
+ */
+void sim_soc_attach_spi(const sim_spi_dev_t *dev);
+
+/**
+ * @brief Acrescenta um escravo ao barramento I2C bit-bang.
+ */
+void sim_soc_attach_i2c(const sim_i2c_dev_t *dev);
+
+/**
+ * @brief Registra uma fonte de eventos, consultada sempre que o tempo virtual avança.
+ */
+void sim_soc_add_source(const sim_source_t *src);
+
+/**
+ * @brief Ciclos de clock do sistema desde o início (o mesmo que o uptime do timer0).
+ */
+uint64_t sim_soc_cycles(void);
+
+/**
+ * @brief Avança o tempo virtual.
+ */
+void sim_soc_advance_ns(uint64_t ns);
+
+/**
+ * @brief Contadores do barramento.
+ */
+sim_soc_stats_t *sim_soc_stats(void);
+
+/**
+ * @brief Imprime os contadores do barramento em `f`.
+ */
+void sim_soc_print_stats(FILE *f);
+
+// ============================================
+// === UART e flash (libbase.c, spiflash.c) ===
+// ============================================
+
+/**
+ * @brief Opções da UART (stdin/stdout).
+ * @param baud Taxa da UART: cada byte enviado custa 10 bits de tempo virtual (0 = sem custo).
+ * @param realtime Segura o tempo virtual no ritmo do relógio real enquanto ocioso.
+ * @param run_ns Após o fim do stdin, continua até este tempo virtual (0 = sai no EOF).
+ */
+void sim_uart_config(uint32_t baud, bool realtime, uint64_t run_ns);
+
+/**
+ * @brief Usa `path` como imagem da flash: lida no início e regravada a cada escrita.
+ * @return false se o arquivo não pôde ser aberto.
+ */
+bool sim_flash_attach(const char *path);
+
+/**
+ * @brief Encerra a simulação (reset do SoC, fim do stdin): grava saídas e chama exit().
+ */
+void sim_soc_exit(int code);
+
+/**
+ * @brief Função chamada por sim_soc_exit() antes de sair (relatórios).
+ */
+void sim_soc_on_exit(void (*fn)(void));
+
+#endif // SIM_SOC_H_
@@ -0,0 +1,292 @@
+// soc.c - barramento de CSRs do colorlight_i5 simulado
+#include "sim_soc.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <generated/csr.h>
+#include <generated/soc.h>
+#include <generated/mem.h>
+
+#include "fastmem.h"
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define CYCLES_PER_US   (CONFIG_CLOCK_FREQUENCY / 1000000)
+#define SPI_BIT_CYCLES  (CONFIG_CLOCK_FREQUENCY / SIM_SPI_CLK_HZ)
+
+#define SPI_CS_MODE_MANUAL (1u << CSR_SPI_CS_MODE_OFFSET)
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static uint64_t cycles;
+static sim_soc_stats_t stats;
+static void (*exit_fn)(void);
+
+// SPIMaster
+static struct {
+    sim_spi_dev_t dev;
+    bool     attached;
+    uint32_t cs;            // Valor de spi_cs
+    bool     selected;      // CS ativo no pino
+    uint32_t mosi, miso;
+    bool     loopback;
+    uint64_t done_at;       // Ciclo em que a transferência termina
+} spi;
+
+// GPIO lora_reset (GPIOOut: começa em 0, rádio em reset)
+static uint32_t lora_reset;
+
+// I2CMaster bit-bang
+static struct {
+    sim_i2c_dev_t devs[SIM_MAX_I2C_DEVS];
+    int      drive[SIM_MAX_I2C_DEVS];
+    int      count;
+    uint32_t w;
+} i2c;
+
+// Fontes de eventos (sincronismo com o canal virtual)
+static sim_source_t sources[SIM_MAX_SOURCES];
+static int          nsources;
+static uint64_t     source_due = UINT64_MAX;   // Menor next_ns() das fontes
+static bool         in_sources;
+
+static uint64_t uptime_latch;
+static uint32_t scratch = 0x12345678;
+
+// ============================================
+// === Fontes de eventos ===
+// ============================================
+
+static void update_due(void) {
+    source_due = UINT64_MAX;
+    for (int i = 0; i < nsources; i++) {
+        uint64_t t = sources[i].next_ns(sources[i].ctx);
+        if (t < source_due) source_due = t;
+    }
+}
+
+// O tempo avança em passos pequenos (acessos a CSR): aplica os eventos já vencidos
+static void run_sources(void) {
+    if (in_sources) return;
+    in_sources = true;
+    for (int i = 0; i < nsources; i++) sources[i].poll(sources[i].ctx);
+    update_due();
+    in_sources = false;
+}
+
+static inline void tick(uint64_t n) {
+    cycles += n;
+    if (cycles * 1000 / CYCLES_PER_US >= source_due) run_sources();
+}
+
+// ============================================
+// === Periféricos ===
+// ============================================
+
+static void spi_update_cs(void) {
+    // Modo manual: CS segue o bit sel; automático: só durante a transferência
+    bool sel = (spi.cs & SPI_CS_MODE_MANUAL) && (spi.cs & 1);
+
+    if (sel == spi.selected) return;
+    spi.selected = sel;
+    if (sel) stats.spi_selects++;
+    if (spi.attached && spi.dev.select) spi.dev.select(spi.dev.ctx, sel);
+}
+
+static void spi_start(uint32_t control) {
+    uint32_t bits = (control >> CSR_SPI_CONTROL_LENGTH_OFFSET) & 0xFF;
+    bool automatic = !(spi.cs & SPI_CS_MODE_MANUAL);
+
+    if (!(control & (1u << CSR_SPI_CONTROL_START_OFFSET))) return;
+    if (bits == 0) bits = 8;
+
+    if (spi.loopback) {
+        spi.miso = spi.mosi;
+    } else if (spi.attached) {
+        if (automatic && (spi.cs & 1) && spi.dev.select) spi.dev.select(spi.dev.ctx, true);
+        if (automatic || spi.selected) spi.miso = spi.dev.xfer(spi.dev.ctx, (uint8_t)spi.mosi);
+        else spi.miso = 0xFF;
+        if (automatic && (spi.cs & 1) && spi.dev.select) spi.dev.select(spi.dev.ctx, false);
+    } else {
+        spi.miso = 0xFF;                 // MISO em pull-up, sem escravo
+    }
+    stats.spi_bytes++;
+    spi.done_at = cycles + (uint64_t)bits * SPI_BIT_CYCLES;
+}
+
+static uint32_t spi_status(void) {
+    // O polling do firmware até o fim é colapsado: o relógio salta para o fim
+    if (cycles < spi.done_at) tick(spi.done_at - cycles);
+    return 1u << CSR_SPI_STATUS_DONE_OFFSET;
+}
+
+static void lora_reset_write(uint32_t v) {
+    bool was_active = !(lora_reset & 1);
+    bool active = !(v & 1);
+
+    lora_reset = v & 1;
+    if (active != was_active && spi.attached && spi.dev.reset)
+        spi.dev.reset(spi.dev.ctx, active);
+}
+
+static void i2c_write(uint32_t v) {
+    int scl = (v >> CSR_I2C_W_SCL_OFFSET) & 1;
+    int oe = (v >> CSR_I2C_W_OE_OFFSET) & 1;
+    int sda = oe ? (int)((v >> CSR_I2C_W_SDA_OFFSET) & 1) : 1;
+
+    i2c.w = v;
+    stats.i2c_writes++;
+    for (int i = 0; i < i2c.count; i++)
+        i2c.drive[i] = i2c.devs[i].line(i2c.devs[i].ctx, scl, sda);
+}
+
+static uint32_t i2c_read(void) {
+    int oe = (i2c.w >> CSR_I2C_W_OE_OFFSET) & 1;
+    int sda = oe ? (int)((i2c.w >> CSR_I2C_W_SDA_OFFSET) & 1) : 1;
+
+    for (int i = 0; i < i2c.count; i++) sda &= i2c.drive[i];
+    return (uint32_t)sda << CSR_I2C_R_SDA_OFFSET;
+}
+
+static void unknown_csr(const char *op, unsigned long addr) {
+    static unsigned long last = 0;
+    if (addr == last) return;
+    last = addr;
+    fprintf(stderr, "[sim] %s de CSR sem modelo: 0x%08lx\n", op, addr);
+}
+
+// ============================================
+// === Acesso aos CSRs (hw/common.h) ===
+// ============================================
+
+uint32_t csr_read_simple(unsigned long addr) {
+    tick(SIM_CSR_ACCESS_CYCLES);
+    stats.csr_reads++;
+
+    switch (addr) {
+    case CSR_SPI_STATUS_ADDR:               return spi_status();
+    case CSR_SPI_MISO_ADDR:                 return spi.miso;
+    case CSR_SPI_CS_ADDR:                   return spi.cs;
+    case CSR_SPI_LOOPBACK_ADDR:             return spi.loopback;
+    case CSR_LORA_RESET_OUT_ADDR:           return lora_reset;
+    case CSR_I2C_W_ADDR:                    return i2c.w;
+    case CSR_I2C_R_ADDR:                    return i2c_read();
+    case CSR_CTRL_SCRATCH_ADDR:             return scratch;
+    case CSR_LEDS_OUT_ADDR:                 return stats.leds;
+    case CSR_TIMER0_UPTIME_CYCLES_ADDR:     return (uint32_t)(uptime_latch >> 32);
+    case CSR_TIMER0_UPTIME_CYCLES_ADDR + 4: return (uint32_t)uptime_latch;
+    default:
+        unknown_csr("leitura", addr);
+        return 0;
+    }
+}
+
+void csr_write_simple(uint32_t value, unsigned long addr) {
+    tick(SIM_CSR_ACCESS_CYCLES);
+    stats.csr_writes++;
+
+    switch (addr) {
+    case CSR_SPI_CONTROL_ADDR:          spi_start(value); break;
+    case CSR_SPI_MOSI_ADDR:             spi.mosi = value; break;
+    case CSR_SPI_CS_ADDR:               spi.cs = value; spi_update_cs(); break;
+    case CSR_SPI_LOOPBACK_ADDR:         spi.loopback = value & 1; break;
+    case CSR_LORA_RESET_OUT_ADDR:       lora_reset_write(value); break;
+    case CSR_I2C_W_ADDR:                i2c_write(value); break;
+    case CSR_CTRL_RESET_ADDR:
+        if (value & 1) {
+            fprintf(stderr, "[sim] reset do SoC\n");
+            sim_soc_exit(0);
+        }
+        break;
+    case CSR_CTRL_SCRATCH_ADDR:         scratch = value; break;
+    case CSR_LEDS_OUT_ADDR:             stats.leds = value; break;
+    case CSR_TIMER0_UPTIME_LATCH_ADDR:  uptime_latch = cycles; break;
+    default:
+        unknown_csr("escrita", addr);
+        break;
+    }
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+uint64_t sim_time_ns(void) {
+    return cycles * 1000 / CYCLES_PER_US;
+}
+
+void sim_soc_init(void) {
+    cycles = 0;
+    memset(&stats, 0, sizeof(stats));
+    memset(&spi, 0, sizeof(spi));
+    memset(&i2c, 0, sizeof(i2c));
+    i2c.w = (1u << CSR_I2C_W_SCL_OFFSET) | (1u << CSR_I2C_W_SDA_OFFSET);
+    lora_reset = 0;
+    uptime_latch = 0;
+    nsources = 0;
+    source_due = UINT64_MAX;
+    memset(sim_flash, 0xFF, SPIFLASH_SIZE);
+}
+
+void sim_soc_attach_spi(const sim_spi_dev_t *dev) {
+    spi.dev = *dev;
+    spi.attached = true;
+    if (spi.dev.reset) spi.dev.reset(spi.dev.ctx, !(lora_reset & 1));
+}
+
+void sim_soc_attach_i2c(const sim_i2c_dev_t *dev) {
+    if (i2c.count >= SIM_MAX_I2C_DEVS) return;
+    i2c.devs[i2c.count] = *dev;
+    i2c.drive[i2c.count] = 1;
+    i2c.count++;
+}
+
+void sim_soc_add_source(const sim_source_t *src) {
+    if (nsources >= SIM_MAX_SOURCES) return;
+    sources[nsources++] = *src;
+    update_due();
+}
+
+uint64_t sim_soc_cycles(void) {
+    return cycles;
+}
+
+void sim_soc_advance_ns(uint64_t ns) {
+    tick(ns * CYCLES_PER_US / 1000);
+}
+
+sim_soc_stats_t *sim_soc_stats(void) {
+    return &stats;
+}
+
+void sim_soc_print_stats(FILE *f) {
+    fprintf(f, "Tempo virtual:   %.3f s (%llu ciclos)\n",
+            (double)cycles / CONFIG_CLOCK_FREQUENCY, (unsigned long long)cycles);
+    fprintf(f, "CSR:             %llu leituras, %llu escritas\n",
+            (unsigned long long)stats.csr_reads, (unsigned long long)stats.csr_writes);
+    fprintf(f, "SPI:             %llu bytes em %llu janelas de CS\n",
+            (unsigned long long)stats.spi_bytes, (unsigned long long)stats.spi_selects);
+    fprintf(f, "I2C:             %llu escritas em i2c_w\n", (unsigned long long)stats.i2c_writes);
+    fprintf(f, "UART:            %llu bytes enviados, %llu recebidos\n",
+            (unsigned long long)stats.uart_tx, (unsigned long long)stats.uart_rx);
+    fprintf(f, "Flash:           %llu bytes programados, %llu setores apagados\n",
+            (unsigned long long)stats.flash_prog, (unsigned long long)stats.flash_erase);
+}
+
+void sim_soc_on_exit(void (*fn)(void)) {
+    exit_fn = fn;
+}
+
+void sim_soc_exit(int code) {
+    fflush(stdout);
+    if (exit_fn) exit_fn();
+    exit(code);
+}
+
+// fastmem.c copia seções do linker.ld; no host tudo já está na RAM
+void fastmem_init(void) {
+}
@@ -0,0 +1,93 @@
+// spiflash.c - liblitespi para o build nativo: flash NOR em sim_flash[]
+#include <stdio.h>
+#include <string.h>
+#include <generated/mem.h>
+#include <generated/soc.h>
+#include <liblitespi/spiflash.h>
+
+#include "sim_soc.h"
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define SECTOR_SIZE     4096
+#define PAGE_PROG_NS    700000ull     // W25Q64: programação de página, típico
+#define SECTOR_ERASE_NS 45000000ull   // W25Q64: apagamento de 4 KB, típico
+
+// ============================================
+// === Estado ===
+// ============================================
+
+uint8_t sim_flash[SPIFLASH_SIZE];
+
+static FILE *image;   // Imagem persistente (opcional)
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static void image_sync(uint32_t addr, uint32_t len) {
+    if (!image) return;
+    fseek(image, (long)addr, SEEK_SET);
+    fwrite(sim_flash + addr, 1, len, image);
+    fflush(image);
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+bool sim_flash_attach(const char *path) {
+    size_t n;
+
+    image = fopen(path, "r+b");
+    if (!image) image = fopen(path, "w+b");
+    if (!image) return false;
+
+    memset(sim_flash, 0xFF, sizeof(sim_flash));
+    n = fread(sim_flash, 1, sizeof(sim_flash), image);
+    if (n < sizeof(sim_flash)) image_sync((uint32_t)n, (uint32_t)(sizeof(sim_flash) - n));
+    return true;
+}
+
+void spiflash_init(void) {
+}
+
+int spiflash_erase_4k_sector(uint32_t addr) {
+    addr &= ~(uint32_t)(SECTOR_SIZE - 1);
+    if (addr >= SPIFLASH_SIZE) return 1;
+
+    memset(sim_flash + addr, 0xFF, SECTOR_SIZE);
+    image_sync(addr, SECTOR_SIZE);
+    sim_soc_stats()->flash_erase++;
+    sim_soc_advance_ns(SECTOR_ERASE_NS);
+    return 0;
+}
+
+void spiflash_erase_range(uint32_t addr, uint32_t len) {
+    for (uint32_t a = addr & ~(uint32_t)(SECTOR_SIZE - 1); a < addr + len; a += SECTOR_SIZE)
+        spiflash_erase_4k_sector(a);
+}
+
+// Como a liblitespi: recusa gravar sobre bytes não apagados
+int spiflash_write_stream(uint32_t addr, uint8_t *stream, uint32_t len) {
+    uint32_t pages;
+
+    if (addr + len > SPIFLASH_SIZE) return 1;
+    for (uint32_t i = 0; i < len; i++) {
+        if (sim_flash[addr + i] != 0xFF) {
+            printf("Error: location 0x%08lx not erased (%02x)\n",
+                   (unsigned long)(addr + i), sim_flash[addr + i]);
+            return 1;
+        }
+    }
+
+    memcpy(sim_flash + addr, stream, len);
+    image_sync(addr, len);
+
+    pages = (addr + len - 1) / SPIFLASH_MODULE_PAGE_SIZE - addr / SPIFLASH_MODULE_PAGE_SIZE + 1;
+    sim_soc_stats()->flash_prog += len;
+    sim_soc_advance_ns(pages * PAGE_PROG_NS);
+    return 0;
+}
@@ -0,0 +1,167 @@
+// tx_bench.c - benchmark dos drivers do TX (bh1750.c, lora_RFM95.c) sobre os modelos
+//
+// Para cada operação mostra o custo em tempo virtual do SoC (acessos a CSR,
+// transferências SPI e esperas), o tráfego no barramento e o tempo de host.
+// Útil para comparar mudanças nos drivers sem a placa. Sai com 1 se algum envio
+// terminar em timeout, o LowDataRateOptimize não seguir o limite de 16 ms por
+// símbolo ou a leitura do sensor não bater com o modelo (ctest).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <generated/soc.h>
+
+#include "sim_soc.h"
+#include "rfm95_model.h"
+#include "bh1750_model.h"
+
+#include "bh1750.h"
+#include "lora_RFM95.h"
+#include "config.h"
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static rfm95_model_t  radio;
+static bh1750_model_t sensor;
+
+typedef struct {
+    uint64_t cycles, csr, spi, i2c;
+    uint64_t host_ns;
+} snap_t;
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static snap_t snap(void) {
+    const sim_soc_stats_t *s = sim_soc_stats();
+    return (snap_t){ sim_soc_cycles(), s->csr_reads + s->csr_writes,
+                     s->spi_bytes, s->i2c_writes, host_ns() };
+}
+
+static void row(const char *name, unsigned n, snap_t a, snap_t b) {
+    double us = (double)(b.cycles - a.cycles) / (CONFIG_CLOCK_FREQUENCY / 1e6) / n;
+    printf("%-26s %8u %12.1f %9.1f %9.1f %9.1f %10.0f\n", name, n, us,
+           (double)(b.csr - a.csr) / n, (double)(b.spi - a.spi) / n,
+           (double)(b.i2c - a.i2c) / n, (double)(b.host_ns - a.host_ns) / n);
+}
+
+// ============================================
+// === main ===
+// ============================================
+
+int main(int argc, char **argv) {
+    unsigned n = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 10000;
+    uint8_t payload[64];
+    volatile uint8_t sink = 0;
+    sim_spi_dev_t spi;
+    sim_i2c_dev_t i2c;
+    bh1750_dados d;
+    bool failed = false;
+    snap_t a;
+
+    sim_soc_init();
+    rfm95_model_init(&radio);
+    bh1750_model_init(&sensor, BH1750_MODEL_ADDR_LOW, 250.0);
+    spi = rfm95_model_dev(&radio);
+    i2c = bh1750_model_dev(&sensor);
+    sim_soc_attach_spi(&spi);
+    sim_soc_attach_i2c(&i2c);
+
+    config_load();
+    memset(payload, 0xA5, sizeof(payload));
+
+    printf("%-26s %8s %12s %9s %9s %9s %10s\n",
+           "operacao", "n", "us virt/op", "CSR/op", "SPI B/op", "I2C w/op", "ns host/op");
+
+    a = snap();
+    if (!lora_init()) { fprintf(stderr, "lora_init falhou\n"); return 1; }
+    row("lora_init", 1, a, snap());
+
+    a = snap();
+    for (unsigned i = 0; i < n; i++) sink ^= lora_read_reg(0x42);
+    row("lora_read_reg", n, a, snap());
+
+    a = snap();
+    for (unsigned i = 0; i < n; i++) lora_write_reg(0x39, 0x12);
+    row("lora_write_reg", n, a, snap());
+
+    a = snap();
+    for (unsigned i = 0; i < n / 100 + 1; i++) lora_configure();
+    row("lora_configure", n / 100 + 1, a, snap());
+
+    a = snap();
+    for (unsigned i = 0; i < n / 100 + 1; i++) { lora_sleep(); lora_wake(); }
+    row("lora_sleep + lora_wake", n / 100 + 1, a, snap());
+
+    // Envio: o tempo virtual inclui o tempo no ar; a sobra é o custo do driver
+    static const size_t lens[] = { 2, 16, 64 };
+    for (size_t j = 0; j < sizeof(lens) / sizeof(lens[0]); j++) {
+        size_t len = lens[j];
+        unsigned k = 20, ok = 0;
+        uint64_t air0 = radio.stats.tx_airtime_ns;
+        char name[32];
+        double over;
+
+        a = snap();
+        for (unsigned i = 0; i < k; i++) ok += lora_send_bytes(payload, len);
+        snprintf(name, sizeof(name), "lora_send_bytes(%zu)", len);
+        row(name, k, a, snap());
+        over = ((double)(sim_soc_cycles() - a.cycles) / (CONFIG_CLOCK_FREQUENCY / 1e6) -
+                (double)(radio.stats.tx_airtime_ns - air0) / 1e3) / k;
+        printf("%-26s %8s %12.1f   (tempo no ar %.1f ms/pacote", "  - sem o tempo no ar", "",
+               over, (double)(radio.stats.tx_airtime_ns - air0) / 1e6 / k);
+        if (ok < k) printf(", %u de %u com timeout", k - ok, k);
+        printf(")\n");
+        if (ok < k) failed = true;
+    }
+
+    // LowDataRateOptimize (RegModemConfig3 bit 3) nos limites de 16 ms por símbolo
+    static const struct { uint32_t sf, bw; bool ldro; } ldro_cases[] = {
+        { 10, 125000, false }, { 11, 125000, true }, { 12, 250000, true },
+        { 11, 250000, false }, { 7, 7800, true }, { 12, 125000, true },
+    };
+    for (size_t j = 0; j < sizeof(ldro_cases) / sizeof(ldro_cases[0]); j++) {
+        bool on;
+
+        config_set("lora.sf", ldro_cases[j].sf);
+        config_set("lora.bw", ldro_cases[j].bw);
+        lora_configure();
+        on = (lora_read_reg(0x26) & 0x08) != 0;
+        if (on != ldro_cases[j].ldro) {
+            fprintf(stderr, "SF%u/%u Hz: LowDataRateOptimize %s, esperado %s\n",
+                    (unsigned)ldro_cases[j].sf, (unsigned)ldro_cases[j].bw,
+                    on ? "ligado" : "desligado", ldro_cases[j].ldro ? "ligado" : "desligado");
+            failed = true;
+        }
+    }
+    config_load();
+    lora_configure();
+
+    a = snap();
+    if (bh1750_init() != 0) { fprintf(stderr, "bh1750_init falhou\n"); return 1; }
+    row("bh1750_init", 1, a, snap());
+
+    a = snap();
+    for (unsigned i = 0; i < n / 10 + 1; i++) sink ^= bh1750_get_data(&d);
+    row("bh1750_get_data", n / 10 + 1, a, snap());
+
+    printf("\nUltima leitura: %u.%02u lux (modelo: %.2f lux)\n",
+           d.luminosidade / 100, d.luminosidade % 100, sensor.lux);
+    if (fabs(d.luminosidade / 100.0 - sensor.lux) > sensor.lux * 0.01) {
+        fprintf(stderr, "leitura do BH1750 difere do modelo\n");
+        failed = true;
+    }
+    if (failed) fprintf(stderr, "tx_bench: FALHOU\n");
+    (void)sink;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+// tx_main.c - firmware do TX (tx-LoRa/firmware/main.c) rodando no host
+//
+//   tx_sim [opções] < comandos.txt > uart.bin
+//
+// O console do firmware é o stdin/stdout do processo (o stream binário de
+// telemetria sai misturado ao texto, como na UART). Os contadores do barramento
+// e dos modelos vão para o stderr ao sair. Com --expect-tx, sai com 1 se o
+// rádio concluiu menos transmissões que o esperado (testes do ctest).
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include "sim_soc.h"
+#include "rfm95_model.h"
+#include "bh1750_model.h"
+#include "sim_link.h"
+
+int firmware_main(void); // main() de tx-LoRa/firmware/main.c
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static rfm95_model_t  radio;
+static bh1750_model_t sensor;
+static bool           with_radio = true;
+static bool           with_sensor = true;
+static bool           quiet = false;
+static unsigned       expect_tx;
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s [opções]\n"
+        "  --lux <valor>        Luminosidade vista pelo BH1750 (padrão 250.0)\n"
+        "  --bh1750-addr <a>    Endereço I2C do sensor (padrão 0x23)\n"
+        "  --no-sensor          Sem BH1750 no barramento\n"
+        "  --no-radio           Sem RFM95 no SPI\n"
+        "  --flash <arquivo>    Imagem persistente da flash (journal e configuração)\n"
+        "  --baud <taxa>        Taxa da UART (padrão 115200; 0 = saída sem custo de tempo)\n"
+        "  --run-ms <ms>        Após o fim do stdin, continua até este tempo virtual\n"
+        "  --realtime           Tempo virtual no ritmo do relógio real (uso interativo)\n"
+        "  --link-fd <fd>       Nó do canal virtual (aberto pelo lora_link)\n"
+        "  --quiet              Sem relatório no stderr ao sair\n"
+        "  --expect-tx <n>      Falha (status 1) com menos de n TxDone no rádio\n", prog);
+}
+
+static void report(void) {
+    if (!quiet) {
+        fprintf(stderr, "\n=== tx_sim ===\n");
+        sim_soc_print_stats(stderr);
+        if (with_radio) rfm95_model_print_stats(&radio, stderr);
+        if (with_sensor) {
+            fprintf(stderr, "BH1750:          %u transações, %u comandos, %u leituras\n",
+                    sensor.starts, sensor.commands, sensor.reads);
+        }
+    }
+    if (expect_tx && (!with_radio || radio.stats.tx_packets < expect_tx)) {
+        fprintf(stderr, "tx_sim: %u transmissões concluídas, esperadas %u\n",
+                with_radio ? radio.stats.tx_packets : 0, expect_tx);
+        exit(1);
+    }
+}
+
+// ============================================
+// === main ===
+// ============================================
+
+int main(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "lux",         required_argument, NULL, 'l' },
+        { "bh1750-addr", required_argument, NULL, 'a' },
+        { "no-sensor",   no_argument,       NULL, 'S' },
+        { "no-radio",    no_argument,       NULL, 'R' },
+        { "flash",       required_argument, NULL, 'f' },
+        { "baud",        required_argument, NULL, 'b' },
+        { "run-ms",      required_argument, NULL, 't' },
+        { "realtime",    no_argument,       NULL, 'r' },
+        { "link-fd",     required_argument, NULL, 'k' },
+        { "quiet",       no_argument,       NULL, 'q' },
+        { "expect-tx",   required_argument, NULL, 'x' },
+        { "help",        no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    double lux = 250.0;
+    unsigned addr = BH1750_MODEL_ADDR_LOW;
+    const char *flash = NULL;
+    uint64_t run_ns = 0;
+    uint32_t baud = 115200;
+    bool realtime = false;
+    int link_fd = -1;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "h", opts, NULL)) != -1) {
+        switch (c) {
+        case 'l': lux = atof(optarg); break;
+        case 'a': addr = (unsigned)strtoul(optarg, NULL, 0); break;
+        case 'S': with_sensor = false; break;
+        case 'R': with_radio = false; break;
+        case 'f': flash = optarg; break;
+        case 'b': baud = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 't': run_ns = strtoull(optarg, NULL, 0) * 1000000ull; break;
+        case 'r': realtime = true; break;
+        case 'k': link_fd = atoi(optarg); break;
+        case 'q': quiet = true; break;
+        case 'x': expect_tx = (unsigned)strtoul(optarg, NULL, 0); break;
+        default:  usage(argv[0]); return c == 'h' ? 0 : 2;
+        }
+    }
+
+    sim_soc_init();
+    if (flash && !sim_flash_attach(flash)) {
+        fprintf(stderr, "Nao foi possivel abrir %s\n", flash);
+        return 1;
+    }
+    sim_uart_config(baud, realtime, run_ns);
+    sim_soc_on_exit(report);
+
+    if (with_radio) {
+        sim_spi_dev_t dev;
+        rfm95_model_init(&radio);
+        dev = rfm95_model_dev(&radio);
+        sim_soc_attach_spi(&dev);
+        if (link_fd >= 0) {
+            sim_source_t src = sim_link_source();
+            sim_link_open(link_fd, SIM_LINK_ROLE_TX, &radio);
+            sim_soc_add_source(&src);
+        }
+    }
+    if (with_sensor) {
+        sim_i2c_dev_t dev;
+        bh1750_model_init(&sensor, (uint8_t)addr, lux);
+        dev = bh1750_model_dev(&sensor);
+        sim_soc_attach_i2c(&dev);
+    }
+
+    firmware_main();
+    sim_soc_exit(0);
+    return 0;
+}
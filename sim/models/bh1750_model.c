@@ -0,0 +1,207 @@
+// bh1750_model.c
+#include "bh1750_model.h"
+
+#include <string.h>
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define CMD_POWER_DOWN      0x00
+#define CMD_POWER_ON        0x01
+#define CMD_RESET           0x07
+#define CMD_CONT_H          0x10
+#define CMD_CONT_H2         0x11
+#define CMD_CONT_L          0x13
+#define CMD_ONE_H           0x20
+#define CMD_ONE_H2          0x21
+#define CMD_ONE_L           0x23
+
+#define CONV_H_NS           120000000ull // Datasheet: 120 ms típico (H e H2)
+#define CONV_L_NS           16000000ull  // Datasheet: 16 ms típico
+
+// ============================================
+// === Sensor ===
+// ============================================
+
+// Resultado em contagens: lux * 1.2 (MTreg padrão), H2 com meia contagem
+static uint16_t lux_to_counts(const bh1750_model_t *m) {
+    double c = m->lux * 1.2;
+    if (m->mode == CMD_CONT_H2 || m->mode == CMD_ONE_H2) c *= 2.0;
+    if (m->mode == CMD_CONT_L || m->mode == CMD_ONE_L) c = (double)((uint32_t)c & ~3u);
+    if (c < 0.0) c = 0.0;
+    if (c > 65535.0) c = 65535.0;
+    return (uint16_t)c;
+}
+
+// Conclui conversões vencidas; no modo contínuo uma nova começa em seguida
+static void update(bh1750_model_t *m) {
+    uint64_t now = sim_time_ns();
+
+    if (!m->powered || !m->mode) return;
+    while (now - m->conv_start_ns >= m->conv_time_ns) {
+        m->data = lux_to_counts(m);
+        m->data_valid = true;
+        if (m->mode >= CMD_ONE_H) {      // One time: volta para power down
+            m->mode = 0;
+            m->powered = false;
+            return;
+        }
+        m->conv_start_ns += m->conv_time_ns;
+    }
+}
+
+static void command(bh1750_model_t *m, uint8_t cmd) {
+    update(m);
+    m->commands++;
+
+    switch (cmd) {
+    case CMD_POWER_DOWN:
+        m->powered = false;
+        m->mode = 0;
+        break;
+    case CMD_POWER_ON:
+        m->powered = true;
+        break;
+    case CMD_RESET:                      // Só tem efeito ligado
+        if (m->powered) { m->data = 0; m->data_valid = false; }
+        break;
+    case CMD_CONT_H: case CMD_CONT_H2: case CMD_CONT_L:
+    case CMD_ONE_H:  case CMD_ONE_H2:  case CMD_ONE_L:
+        m->powered = true;
+        m->mode = cmd;
+        m->conv_start_ns = sim_time_ns();
+        m->conv_time_ns = (cmd == CMD_CONT_L || cmd == CMD_ONE_L) ? CONV_L_NS : CONV_H_NS;
+        break;
+    default:
+        break;                           // MTreg e comandos desconhecidos: ignorados
+    }
+}
+
+static void load_output(bh1750_model_t *m) {
+    update(m);
+    m->out[0] = (uint8_t)(m->data >> 8);
+    m->out[1] = (uint8_t)(m->data & 0xFF);
+    m->out_idx = 0;
+    m->reads++;
+}
+
+// ============================================
+// === Máquina I2C (escravo) ===
+// ============================================
+
+static int next_bit(bh1750_model_t *m) {
+    uint8_t byte = m->out_idx < 2 ? m->out[m->out_idx] : 0xFF;
+    return (byte >> (7 - m->bits)) & 1;
+}
+
+static int line(void *ctx, int scl, int sda_master) {
+    bh1750_model_t *m = ctx;
+    int sda = sda_master & m->drive;
+
+    if (scl && m->scl && sda != m->sda) {
+        // SDA mudou com SCL alto: START (descida) ou STOP (subida)
+        if (!sda) {
+            m->state = BH1750_I2C_ADDR;
+            m->shift = 0;
+            m->bits = 0;
+            m->starts++;
+        } else {
+            m->state = BH1750_I2C_IDLE;
+        }
+        m->drive = 1;
+    } else if (scl && !m->scl) {
+        // Subida de SCL: amostra
+        switch (m->state) {
+        case BH1750_I2C_ADDR:
+        case BH1750_I2C_WRITE:
+            m->shift = (uint8_t)((m->shift << 1) | sda);
+            m->bits++;
+            break;
+        case BH1750_I2C_READ:
+            m->bits++;
+            break;
+        case BH1750_I2C_READ_ACK:
+            m->nack = sda;
+            break;
+        default:
+            break;
+        }
+    } else if (!scl && m->scl) {
+        // Descida de SCL: prepara o próximo bit
+        switch (m->state) {
+        case BH1750_I2C_ADDR:
+            if (m->bits < 8) break;
+            if ((m->shift >> 1) == m->addr) {
+                m->rw = m->shift & 1;
+                m->drive = 0;
+                m->state = BH1750_I2C_ADDR_ACK;
+            } else {
+                m->state = BH1750_I2C_IDLE;
+            }
+            break;
+        case BH1750_I2C_WRITE:
+            if (m->bits < 8) break;
+            command(m, m->shift);
+            m->drive = 0;
+            m->state = BH1750_I2C_WRITE_ACK;
+            break;
+        case BH1750_I2C_ADDR_ACK:
+        case BH1750_I2C_WRITE_ACK:
+            m->bits = 0;
+            m->shift = 0;
+            if (m->state == BH1750_I2C_ADDR_ACK && m->rw) {
+                load_output(m);
+                m->drive = next_bit(m);
+                m->state = BH1750_I2C_READ;
+            } else {
+                m->drive = 1;
+                m->state = BH1750_I2C_WRITE;
+            }
+            break;
+        case BH1750_I2C_READ:
+            if (m->bits < 8) {
+                m->drive = next_bit(m);
+            } else {
+                m->drive = 1;            // Solta SDA para o ACK do mestre
+                m->state = BH1750_I2C_READ_ACK;
+            }
+            break;
+        case BH1750_I2C_READ_ACK:
+            if (m->nack) {
+                m->state = BH1750_I2C_IDLE;
+            } else {
+                m->out_idx++;
+                m->bits = 0;
+                m->drive = next_bit(m);
+                m->state = BH1750_I2C_READ;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    m->scl = scl;
+    m->sda = sda_master & m->drive;
+    return m->drive;
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+void bh1750_model_init(bh1750_model_t *m, uint8_t addr, double lux) {
+    memset(m, 0, sizeof(*m));
+    m->addr = addr;
+    m->lux = lux;
+    m->scl = m->sda = m->drive = 1;
+}
+
+void bh1750_model_set_lux(bh1750_model_t *m, double lux) {
+    update(m);
+    m->lux = lux;
+}
+
+sim_i2c_dev_t bh1750_model_dev(bh1750_model_t *m) {
+    return (sim_i2c_dev_t){ .line = line, .ctx = m };
+}
@@ -0,0 +1,77 @@
+// bh1750_model.h - modelo comportamental do sensor de luminosidade BH1750 (escravo I2C)
+#ifndef BH1750_MODEL_H_
+#define BH1750_MODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sim_dev.h"
+
+// ============================================
+// === Modelo do BH1750 ===
+// ============================================
+//
+// Protocolo I2C no nível dos pinos (START/STOP, ACK, leitura de 2 bytes) e os
+// comandos de energia e de modo do datasheet. A medida só fica disponível ao
+// fim da conversão (120 ms em alta resolução, 16 ms em baixa); antes disso o
+// registrador de dados lê 0, como no sensor real logo após o power on.
+
+#define BH1750_MODEL_ADDR_LOW   0x23 // Pino ADDR em GND
+#define BH1750_MODEL_ADDR_HIGH  0x5C // Pino ADDR em VCC
+
+typedef enum {
+    BH1750_I2C_IDLE,
+    BH1750_I2C_ADDR,        // Recebendo o byte de endereço
+    BH1750_I2C_ADDR_ACK,
+    BH1750_I2C_WRITE,       // Recebendo um comando
+    BH1750_I2C_WRITE_ACK,
+    BH1750_I2C_READ,        // Enviando um byte de dados
+    BH1750_I2C_READ_ACK,    // Esperando ACK/NACK do mestre
+} bh1750_i2c_state_t;
+
+typedef struct {
+    // Configuração
+    uint8_t  addr;
+    double   lux;               // Luminosidade "real" no instante da conversão
+
+    // Sensor
+    bool     powered;
+    uint8_t  mode;              // Último comando de medida (0 = nenhum)
+    uint64_t conv_start_ns;
+    uint64_t conv_time_ns;
+    uint16_t data;              // Último resultado (contagens)
+    bool     data_valid;
+
+    // Máquina I2C
+    bh1750_i2c_state_t state;
+    int      scl, sda;          // Níveis anteriores no barramento
+    int      drive;             // Nível que o modelo impõe em SDA
+    uint8_t  shift;
+    int      bits;
+    bool     rw;                // Transação atual é leitura
+    bool     nack;
+    uint8_t  out[2];
+    int      out_idx;
+
+    // Contadores
+    uint32_t starts;
+    uint32_t commands;
+    uint32_t reads;             // Leituras de dados (2 bytes)
+} bh1750_model_t;
+
+/**
+ * @brief Inicializa o modelo desligado (estado após alimentar o chip).
+ */
+void bh1750_model_init(bh1750_model_t *m, uint8_t addr, double lux);
+
+/**
+ * @brief Altera a luminosidade vista pelo sensor (vale na próxima conversão).
+ */
+void bh1750_model_set_lux(bh1750_model_t *m, double lux);
+
+/**
+ * @brief Interface para ligar o modelo a um barramento I2C simulado.
+ */
+sim_i2c_dev_t bh1750_model_dev(bh1750_model_t *m);
+
+#endif // BH1750_MODEL_H_
@@ -0,0 +1,620 @@
+// rfm95_model.c
+#include "rfm95_model.h"
+
+#include <string.h>
+#include <math.h>
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define REG_FIFO                 0x00
+#define REG_OP_MODE              0x01
+#define REG_FRF_MSB              0x06
+#define REG_FRF_MID              0x07
+#define REG_FRF_LSB              0x08
+#define REG_FIFO_ADDR_PTR        0x0D
+#define REG_FIFO_TX_BASE_ADDR    0x0E
+#define REG_FIFO_RX_BASE_ADDR    0x0F
+#define REG_FIFO_RX_CURRENT_ADDR 0x10
+#define REG_IRQ_FLAGS_MASK       0x11
+#define REG_IRQ_FLAGS            0x12
+#define REG_RX_NB_BYTES          0x13
+#define REG_RX_HEADER_CNT_MSB    0x14
+#define REG_RX_PACKET_CNT_MSB    0x16
+#define REG_MODEM_STAT           0x18
+#define REG_PKT_SNR_VALUE        0x19
+#define REG_PKT_RSSI_VALUE       0x1A
+#define REG_RSSI_VALUE           0x1B
+#define REG_HOP_CHANNEL          0x1C
+#define REG_MODEM_CONFIG_1       0x1D
+#define REG_MODEM_CONFIG_2       0x1E
+#define REG_SYMB_TIMEOUT_LSB     0x1F
+#define REG_PREAMBLE_MSB         0x20
+#define REG_PREAMBLE_LSB         0x21
+#define REG_PAYLOAD_LENGTH       0x22
+#define REG_FIFO_RX_BYTE_ADDR    0x25
+#define REG_MODEM_CONFIG_3       0x26
+#define REG_SYNC_WORD            0x39
+#define REG_DIO_MAPPING_1        0x40
+#define REG_VERSION              0x42
+
+#define OP_LONG_RANGE            0x80
+#define OP_MODE_MASK             0x07
+#define MODE_SLEEP               0x00
+#define MODE_STDBY               0x01
+#define MODE_FSTX                0x02
+#define MODE_TX                  0x03
+#define MODE_FSRX                0x04
+#define MODE_RX_CONTINUOUS       0x05
+#define MODE_RX_SINGLE           0x06
+#define MODE_CAD                 0x07
+
+#define IRQ_RX_TIMEOUT           0x80
+#define IRQ_RX_DONE              0x40
+#define IRQ_PAYLOAD_CRC_ERROR    0x20
+#define IRQ_VALID_HEADER         0x10
+#define IRQ_TX_DONE              0x08
+#define IRQ_CAD_DONE             0x04
+#define IRQ_CAD_DETECTED         0x01
+
+// Flag ligada ao DIO0 por RegDioMapping1[7:6]
+static const uint8_t dio0_flag[4] = { IRQ_RX_DONE, IRQ_TX_DONE, IRQ_CAD_DONE, 0 };
+// Flag que aparece no DIO3 para cada valor de RegDioMapping1[1:0]
+static const uint8_t dio3_flag[4] = { IRQ_CAD_DONE, IRQ_VALID_HEADER, IRQ_PAYLOAD_CRC_ERROR, 0 };
+
+// Larguras de banda pelo código de RegModemConfig1[7:4]
+static const uint32_t bw_hz[] = {
+    7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000
+};
+
+// Valores de reset (datasheet do SX1276, coluna LoRa); o resto é 0x00
+static const struct { uint8_t reg, val; } reset_vals[] = {
+    { 0x01, 0x09 }, { 0x06, 0x6C }, { 0x07, 0x80 }, { 0x08, 0x00 },
+    { 0x09, 0x4F }, { 0x0A, 0x09 }, { 0x0B, 0x2B }, { 0x0C, 0x20 },
+    { 0x0E, 0x80 }, { 0x1D, 0x72 }, { 0x1E, 0x70 }, { 0x1F, 0x64 },
+    { 0x21, 0x08 }, { 0x22, 0x01 }, { 0x23, 0xFF }, { 0x26, 0x04 },
+    { 0x39, 0x12 }, { 0x42, RFM95_MODEL_VERSION }, { 0x4D, 0x84 },
+};
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static void reset_regs(rfm95_model_t *m) {
+    memset(m->regs, 0, sizeof(m->regs));
+    memset(m->fifo, 0, sizeof(m->fifo));
+    for (size_t i = 0; i < sizeof(reset_vals) / sizeof(reset_vals[0]); i++)
+        m->regs[reset_vals[i].reg] = reset_vals[i].val;
+    m->tx_busy = false;
+    m->rx_state = RFM95_RX_IDLE;
+    m->rx_timeout_ns = 0;
+    m->cad_end_ns = 0;
+    memset(m->irq_set_ns, 0, sizeof(m->irq_set_ns));
+}
+
+static inline uint8_t op_mode(const rfm95_model_t *m) {
+    return m->regs[REG_OP_MODE] & OP_MODE_MASK;
+}
+
+static inline bool lora_mode(const rfm95_model_t *m) {
+    return (m->regs[REG_OP_MODE] & OP_LONG_RANGE) != 0;
+}
+
+static inline bool rx_mode(uint8_t mode) {
+    return mode == MODE_RX_CONTINUOUS || mode == MODE_RX_SINGLE;
+}
+
+static void set_mode(rfm95_model_t *m, uint8_t mode) {
+    m->regs[REG_OP_MODE] = (uint8_t)((m->regs[REG_OP_MODE] & ~OP_MODE_MASK) | mode);
+}
+
+static inline uint32_t frf(const rfm95_model_t *m) {
+    return ((uint32_t)m->regs[REG_FRF_MSB] << 16) | ((uint32_t)m->regs[REG_FRF_MID] << 8) |
+           m->regs[REG_FRF_LSB];
+}
+
+static double symbol_s(uint8_t sf, uint8_t bw_code) {
+    if (bw_code >= sizeof(bw_hz) / sizeof(bw_hz[0])) bw_code = 7;
+    return (double)(1u << sf) / bw_hz[bw_code];
+}
+
+static void update_dio(rfm95_model_t *m) {
+    uint8_t map = m->regs[REG_DIO_MAPPING_1];
+    bool level0 = (m->regs[REG_IRQ_FLAGS] & dio0_flag[map >> 6]) != 0;
+    bool level3 = (m->regs[REG_IRQ_FLAGS] & dio3_flag[map & 0x03]) != 0;
+
+    if (level0 != m->dio0) {
+        m->dio0 = level0;
+        if (m->on_dio0) m->on_dio0(m->hook_arg, level0);
+    }
+    if (level3 != m->dio3) {
+        m->dio3 = level3;
+        if (m->on_dio3) m->on_dio3(m->hook_arg, level3);
+    }
+}
+
+// Flags mascaradas em RegIrqFlagsMask não sobem
+static void set_flags(rfm95_model_t *m, uint8_t flags, uint64_t at) {
+    flags &= (uint8_t)~m->regs[REG_IRQ_FLAGS_MASK];
+    for (int b = 0; b < 8; b++) {
+        uint8_t bit = (uint8_t)(1u << b);
+        if ((flags & bit) && !(m->regs[REG_IRQ_FLAGS] & bit)) m->irq_set_ns[b] = at ? at : 1;
+    }
+    m->regs[REG_IRQ_FLAGS] |= flags;
+}
+
+// Escrever 1 limpa a flag; mede quanto tempo ela ficou pendente
+static void clear_flags(rfm95_model_t *m, uint8_t flags) {
+    uint64_t now = sim_time_ns();
+
+    for (int b = 0; b < 8; b++) {
+        uint8_t bit = (uint8_t)(1u << b);
+        if (!(flags & bit) || !(m->regs[REG_IRQ_FLAGS] & bit)) continue;
+        if (now >= m->irq_set_ns[b]) {
+            uint64_t lat = now - m->irq_set_ns[b];
+            m->stats.irq_serviced++;
+            m->stats.irq_latency_ns += lat;
+            if (lat > m->stats.irq_latency_max_ns) m->stats.irq_latency_max_ns = lat;
+        }
+        m->irq_set_ns[b] = 0;
+    }
+    m->regs[REG_IRQ_FLAGS] &= (uint8_t)~flags;
+}
+
+static void bump16(rfm95_model_t *m, uint8_t reg_msb) {
+    uint16_t v = (uint16_t)((m->regs[reg_msb] << 8) | m->regs[reg_msb + 1]);
+    v++;
+    m->regs[reg_msb] = (uint8_t)(v >> 8);
+    m->regs[reg_msb + 1] = (uint8_t)v;
+}
+
+// --- Transmissão ---
+
+static void start_tx(rfm95_model_t *m) {
+    uint8_t len = m->regs[REG_PAYLOAD_LENGTH];
+    uint8_t base = m->regs[REG_FIFO_TX_BASE_ADDR];
+    rfm95_packet_t *p = &m->tx_pkt;
+
+    rfm95_model_make_packet(m, p, NULL, len);
+    for (unsigned i = 0; i < len; i++) p->data[i] = m->fifo[(uint8_t)(base + i)];
+
+    m->tx_busy = true;
+    m->tx_start_ns = p->start_ns;
+    m->tx_end_ns = p->start_ns + p->airtime_ns;
+    if (m->on_tx) m->on_tx(m->hook_arg, p);
+}
+
+static void abort_tx(rfm95_model_t *m) {
+    m->tx_busy = false;
+    m->stats.tx_aborted++;
+    m->stats.tx_airtime_ns += sim_time_ns() - m->tx_start_ns;
+}
+
+// --- Recepção ---
+
+static void rx_abort(rfm95_model_t *m) {
+    if (m->rx_state != RFM95_RX_IDLE) m->stats.rx_missed++;
+    m->rx_state = RFM95_RX_IDLE;
+}
+
+// Copia para o FIFO os bytes do payload já demodulados até `now`
+static void rx_fill(rfm95_model_t *m, uint64_t now) {
+    const rfm95_packet_t *p = &m->rx_pkt;
+    unsigned avail = p->len;
+
+    if (now < m->rx_end_ns) {
+        uint64_t span = m->rx_end_ns - m->rx_header_ns;
+        avail = span ? (unsigned)((now - m->rx_header_ns) * p->len / span) : p->len;
+    }
+    while (m->rx_written < avail) {
+        m->fifo[(uint8_t)(m->rx_start + m->rx_written)] = p->data[m->rx_written];
+        m->rx_written++;
+    }
+    m->regs[REG_FIFO_RX_BYTE_ADDR] = (uint8_t)(m->rx_start + m->rx_written);
+}
+
+static void rx_done(rfm95_model_t *m) {
+    const rfm95_packet_t *p = &m->rx_pkt;
+    int pkt_rssi = p->rssi_dbm + 157 - (p->snr_db < 0 ? (int)p->snr_db : 0);
+    uint8_t flags = IRQ_RX_DONE;
+
+    rx_fill(m, m->rx_end_ns);
+    m->regs[REG_FIFO_RX_CURRENT_ADDR] = m->rx_start;
+    m->regs[REG_RX_NB_BYTES] = p->len;
+    m->regs[REG_PKT_SNR_VALUE] = (uint8_t)(int8_t)lrintf(p->snr_db * 4.0f);
+    m->regs[REG_PKT_RSSI_VALUE] = (uint8_t)(pkt_rssi < 0 ? 0 : pkt_rssi > 255 ? 255 : pkt_rssi);
+    m->rx_wr = (uint8_t)(m->rx_start + p->len);
+    m->rx_state = RFM95_RX_IDLE;
+
+    if (p->corrupt && p->crc_on) {
+        flags |= IRQ_PAYLOAD_CRC_ERROR;
+        m->stats.rx_crc_errors++;
+    } else {
+        bump16(m, REG_RX_PACKET_CNT_MSB);
+        m->stats.rx_packets++;
+    }
+    set_flags(m, flags, m->rx_end_ns);
+    if (op_mode(m) == MODE_RX_SINGLE) set_mode(m, MODE_STDBY);
+}
+
+// --- Modos ---
+
+static void write_op_mode(rfm95_model_t *m, uint8_t val) {
+    uint8_t cur = m->regs[REG_OP_MODE];
+    uint8_t old = cur & OP_MODE_MASK;
+    uint8_t mode = val & OP_MODE_MASK;
+    uint64_t now = sim_time_ns();
+
+    // LongRangeMode só muda em SLEEP (ou junto com a ida para SLEEP)
+    if (((cur ^ val) & OP_LONG_RANGE) && old != MODE_SLEEP && mode != MODE_SLEEP)
+        val = (uint8_t)((val & ~OP_LONG_RANGE) | (cur & OP_LONG_RANGE));
+
+    if (m->tx_busy && mode != MODE_TX) abort_tx(m);
+    if (rx_mode(old) && !rx_mode(mode)) { rx_abort(m); m->rx_timeout_ns = 0; }
+    if (old == MODE_CAD && mode != MODE_CAD) m->cad_end_ns = 0;
+    m->regs[REG_OP_MODE] = val;
+
+    if (!(val & OP_LONG_RANGE)) return;     // Modo FSK/OOK não é modelado
+    switch (mode) {
+    case MODE_SLEEP:
+        memset(m->fifo, 0, sizeof(m->fifo));
+        break;
+    case MODE_TX:
+        if (!m->tx_busy) start_tx(m);
+        break;
+    case MODE_RX_CONTINUOUS:
+    case MODE_RX_SINGLE:
+        if (!rx_mode(old)) {
+            m->rx_wr = m->regs[REG_FIFO_RX_BASE_ADDR];
+            m->regs[REG_FIFO_RX_BYTE_ADDR] = m->rx_wr;
+        }
+        if (mode == MODE_RX_SINGLE) {
+            unsigned symbols = ((unsigned)(m->regs[REG_MODEM_CONFIG_2] & 0x03) << 8) |
+                               m->regs[REG_SYMB_TIMEOUT_LSB];
+            double tsym = symbol_s(m->regs[REG_MODEM_CONFIG_2] >> 4, m->regs[REG_MODEM_CONFIG_1] >> 4);
+            m->rx_timeout_ns = now + (uint64_t)(symbols * tsym * 1e9);
+        }
+        break;
+    case MODE_CAD: {
+        // Um símbolo de detecção mais ~32 chips de processamento
+        uint8_t sf = m->regs[REG_MODEM_CONFIG_2] >> 4;
+        uint8_t bw = m->regs[REG_MODEM_CONFIG_1] >> 4;
+        double tsym = symbol_s(sf, bw);
+        m->cad_end_ns = now + (uint64_t)((tsym + tsym * 32.0 / (1u << sf)) * 1e9);
+        m->cad_hit = m->rx_state != RFM95_RX_IDLE;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+// --- Registradores ---
+
+// Valor que uma leitura devolveria, sem efeitos colaterais
+static uint8_t reg_value(const rfm95_model_t *m, uint8_t reg) {
+    switch (reg) {
+    case REG_FIFO:
+        if (op_mode(m) == MODE_SLEEP) return 0;
+        return m->fifo[m->regs[REG_FIFO_ADDR_PTR]];
+    case REG_MODEM_STAT: {
+        uint8_t cr = (uint8_t)(m->rx_pkt.cr << 5);
+        if (m->rx_state == RFM95_RX_PREAMBLE) return 0x07;
+        if (m->rx_state == RFM95_RX_PAYLOAD) return (uint8_t)(cr | 0x0F);
+        return 0x10;                     // Modem livre
+    }
+    case REG_RSSI_VALUE: {
+        int rssi = m->rx_state != RFM95_RX_IDLE ? m->rx_pkt.rssi_dbm : RFM95_MODEL_NOISE_DBM;
+        rssi += 157;
+        return (uint8_t)(rssi < 0 ? 0 : rssi > 255 ? 255 : rssi);
+    }
+    default:
+        return m->regs[reg];
+    }
+}
+
+static uint8_t read_reg(rfm95_model_t *m, uint8_t reg) {
+    uint8_t v = reg_value(m, reg);
+
+    m->stats.reads_by_reg[reg]++;
+    switch (reg) {
+    case REG_FIFO:
+        m->stats.fifo_reads++;
+        if (op_mode(m) != MODE_SLEEP) m->regs[REG_FIFO_ADDR_PTR]++;
+        break;
+    case REG_MODEM_STAT:
+    case REG_RSSI_VALUE:
+        break;
+    default:
+        m->stats.reg_reads++;
+        break;
+    }
+    return v;
+}
+
+static void write_reg(rfm95_model_t *m, uint8_t reg, uint8_t val) {
+    m->stats.writes_by_reg[reg]++;
+
+    switch (reg) {
+    case REG_FIFO:
+        m->stats.fifo_writes++;
+        if (op_mode(m) != MODE_SLEEP) m->fifo[m->regs[REG_FIFO_ADDR_PTR]++] = val;
+        return;
+    case REG_OP_MODE:
+        write_op_mode(m, val);
+        break;
+    case REG_IRQ_FLAGS:
+        clear_flags(m, val);
+        break;
+    case REG_FIFO_RX_CURRENT_ADDR: case REG_RX_NB_BYTES:
+    case REG_RX_HEADER_CNT_MSB: case REG_RX_HEADER_CNT_MSB + 1:
+    case REG_RX_PACKET_CNT_MSB: case REG_RX_PACKET_CNT_MSB + 1:
+    case REG_MODEM_STAT: case REG_PKT_SNR_VALUE: case REG_PKT_RSSI_VALUE:
+    case REG_RSSI_VALUE: case REG_HOP_CHANNEL: case REG_FIFO_RX_BYTE_ADDR:
+    case REG_VERSION:
+        break;                           // Somente leitura
+    default:
+        m->regs[reg] = val;
+        break;
+    }
+    m->stats.reg_writes++;
+    update_dio(m);
+}
+
+// ============================================
+// === Interface SPI ===
+// ============================================
+
+static inline bool responding(const rfm95_model_t *m) {
+    return !m->in_reset && sim_time_ns() >= m->ready_ns;
+}
+
+static void spi_select(void *ctx, bool active) {
+    rfm95_model_t *m = ctx;
+    uint64_t now = sim_time_ns();
+
+    if (active && !m->selected) {
+        m->stats.transactions++;
+        m->cs_start_ns = now;
+    } else if (!active && m->selected) {
+        uint64_t d = now - m->cs_start_ns;
+        m->stats.cs_ns += d;
+        if (d > m->stats.cs_max_ns) m->stats.cs_max_ns = d;
+    }
+    m->selected = active;
+    m->have_addr = false;
+}
+
+static uint8_t spi_xfer(void *ctx, uint8_t mosi) {
+    rfm95_model_t *m = ctx;
+    uint8_t miso = 0;
+
+    m->stats.bytes++;
+    if (!m->selected || !responding(m)) return 0;
+    rfm95_model_poll(m);
+
+    if (!m->have_addr) {
+        m->have_addr = true;
+        m->write = (mosi & 0x80) != 0;
+        m->addr = mosi & 0x7F;
+        return 0;
+    }
+    // Rajada: o endereço avança, exceto no FIFO (avança o FifoAddrPtr)
+    if (m->write) write_reg(m, m->addr, mosi);
+    else          miso = read_reg(m, m->addr);
+    if (m->addr != REG_FIFO) m->addr = (m->addr + 1) & 0x7F;
+    return miso;
+}
+
+static uint8_t spi_peek(void *ctx) {
+    rfm95_model_t *m = ctx;
+
+    if (!m->selected || !responding(m) || !m->have_addr || m->write) return 0;
+    rfm95_model_poll(m);
+    return reg_value(m, m->addr);
+}
+
+static void spi_reset(void *ctx, bool active) {
+    rfm95_model_t *m = ctx;
+
+    if (active) {
+        reset_regs(m);
+        update_dio(m);
+    } else if (m->in_reset) {
+        m->ready_ns = sim_time_ns() + RFM95_MODEL_RESET_NS;
+    }
+    m->in_reset = active;
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+void rfm95_model_init(rfm95_model_t *m) {
+    memset(m, 0, sizeof(*m));
+    reset_regs(m);
+}
+
+uint64_t rfm95_packet_airtime_ns(const rfm95_packet_t *p) {
+    int sf = p->sf < 6 ? 6 : p->sf > 12 ? 12 : p->sf;
+    int cr = p->cr < 1 ? 1 : p->cr > 4 ? 4 : p->cr;
+    int de = (symbol_s((uint8_t)sf, p->bw_code) > 0.016) ? 1 : 0;
+    double tsym = symbol_s((uint8_t)sf, p->bw_code);
+    double payload;
+
+    payload = ceil((8.0 * p->len - 4.0 * sf + 28 + 16 * p->crc_on - 20 * p->implicit_header) /
+                   (4.0 * (sf - 2 * de)));
+    if (payload < 0) payload = 0;
+    payload = 8 + payload * (cr + 4);
+
+    return (uint64_t)(((p->preamble + 4.25) + payload) * tsym * 1e9);
+}
+
+void rfm95_model_make_packet(const rfm95_model_t *m, rfm95_packet_t *p,
+                             const uint8_t *data, uint8_t len) {
+    uint8_t c1 = m->regs[REG_MODEM_CONFIG_1];
+    uint8_t c2 = m->regs[REG_MODEM_CONFIG_2];
+
+    memset(p, 0, sizeof(*p));
+    if (data) memcpy(p->data, data, len);
+    p->len = len;
+    p->frf = frf(m);
+    p->bw_code = c1 >> 4;
+    p->cr = (c1 >> 1) & 0x07;
+    p->implicit_header = c1 & 0x01;
+    p->sf = c2 >> 4;
+    p->crc_on = (c2 >> 2) & 0x01;
+    p->sync_word = m->regs[REG_SYNC_WORD];
+    p->preamble = (uint16_t)((m->regs[REG_PREAMBLE_MSB] << 8) | m->regs[REG_PREAMBLE_LSB]);
+    p->start_ns = sim_time_ns();
+    p->airtime_ns = rfm95_packet_airtime_ns(p);
+    p->rssi_dbm = -80;
+    p->snr_db = 9.0f;
+}
+
+uint64_t rfm95_model_airtime_ns(const rfm95_model_t *m, uint8_t len) {
+    rfm95_packet_t p;
+    rfm95_model_make_packet(m, &p, NULL, len);
+    return p.airtime_ns;
+}
+
+bool rfm95_model_rx_begin(rfm95_model_t *m, const rfm95_packet_t *pkt) {
+    const rfm95_packet_t *p;
+    double tsym;
+
+    rfm95_model_poll(m);
+    if (!lora_mode(m) || !rx_mode(op_mode(m)) || m->rx_state != RFM95_RX_IDLE) {
+        m->stats.rx_missed++;
+        return false;
+    }
+    if (pkt->frf != frf(m) || pkt->sf != (m->regs[REG_MODEM_CONFIG_2] >> 4) ||
+        pkt->bw_code != (m->regs[REG_MODEM_CONFIG_1] >> 4) ||
+        pkt->sync_word != m->regs[REG_SYNC_WORD]) {
+        m->stats.rx_mismatch++;
+        return false;
+    }
+
+    m->rx_pkt = *pkt;
+    p = &m->rx_pkt;
+    tsym = symbol_s(p->sf, p->bw_code);
+    // Cabeçalho explícito: os 8 primeiros símbolos após o preâmbulo
+    m->rx_header_ns = p->start_ns + (uint64_t)((p->preamble + 4.25 + 8) * tsym * 1e9);
+    m->rx_end_ns = p->start_ns + p->airtime_ns;
+    if (m->rx_header_ns > m->rx_end_ns) m->rx_header_ns = m->rx_end_ns;
+    m->rx_start = m->rx_wr;
+    m->rx_written = 0;
+    m->rx_state = RFM95_RX_PREAMBLE;
+    m->rx_timeout_ns = 0;                // Preâmbulo detectado
+    m->regs[REG_HOP_CHANNEL] = p->crc_on ? 0x40 : 0x00;
+
+    rfm95_model_poll(m);
+    return true;
+}
+
+bool rfm95_model_rx_corrupt(rfm95_model_t *m) {
+    rfm95_model_poll(m);
+    if (m->rx_state == RFM95_RX_IDLE) return false;
+    m->rx_pkt.corrupt = true;
+    return true;
+}
+
+void rfm95_model_poll(rfm95_model_t *m) {
+    uint64_t now = sim_time_ns();
+
+    if (m->tx_busy && now >= m->tx_end_ns) {
+        m->tx_busy = false;
+        set_mode(m, MODE_STDBY);
+        m->stats.tx_packets++;
+        m->stats.tx_airtime_ns += m->tx_end_ns - m->tx_start_ns;
+        set_flags(m, IRQ_TX_DONE, m->tx_end_ns);
+    }
+
+    if (m->rx_state == RFM95_RX_PREAMBLE && now >= m->rx_header_ns) {
+        m->rx_state = RFM95_RX_PAYLOAD;
+        bump16(m, REG_RX_HEADER_CNT_MSB);
+        set_flags(m, IRQ_VALID_HEADER, m->rx_header_ns);
+    }
+    if (m->rx_state == RFM95_RX_PAYLOAD) {
+        if (now >= m->rx_end_ns) rx_done(m);
+        else rx_fill(m, now);
+    }
+
+    if (m->rx_timeout_ns && now >= m->rx_timeout_ns && m->rx_state == RFM95_RX_IDLE) {
+        m->rx_timeout_ns = 0;
+        m->stats.rx_timeouts++;
+        set_mode(m, MODE_STDBY);
+        set_flags(m, IRQ_RX_TIMEOUT, now);
+    }
+
+    if (m->cad_end_ns && now >= m->cad_end_ns) {
+        uint64_t at = m->cad_end_ns;
+        m->cad_end_ns = 0;
+        m->stats.cad_done++;
+        set_mode(m, MODE_STDBY);
+        set_flags(m, (uint8_t)(IRQ_CAD_DONE | (m->cad_hit ? IRQ_CAD_DETECTED : 0)), at);
+    }
+
+    update_dio(m);
+}
+
+uint64_t rfm95_model_next_event_ns(const rfm95_model_t *m) {
+    uint64_t t = UINT64_MAX;
+
+    if (m->tx_busy && m->tx_end_ns < t) t = m->tx_end_ns;
+    if (m->rx_state == RFM95_RX_PREAMBLE && m->rx_header_ns < t) t = m->rx_header_ns;
+    if (m->rx_state == RFM95_RX_PAYLOAD && m->rx_end_ns < t) t = m->rx_end_ns;
+    if (m->rx_timeout_ns && m->rx_timeout_ns < t) t = m->rx_timeout_ns;
+    if (m->cad_end_ns && m->cad_end_ns < t) t = m->cad_end_ns;
+    return t;
+}
+
+bool rfm95_model_dio0(rfm95_model_t *m) {
+    rfm95_model_poll(m);
+    return m->dio0;
+}
+
+sim_spi_dev_t rfm95_model_dev(rfm95_model_t *m) {
+    return (sim_spi_dev_t){ .select = spi_select, .xfer = spi_xfer, .reset = spi_reset,
+                            .peek = spi_peek, .ctx = m };
+}
+
+void rfm95_model_print_stats(const rfm95_model_t *m, FILE *f) {
+    const rfm95_stats_t *s = &m->stats;
+    uint8_t top[5] = { 0 };
+    uint32_t top_n[5] = { 0 };
+
+    fprintf(f, "RFM95 SPI:       %u transações, %u bytes (%.1f bytes/transação)\n",
+            s->transactions, s->bytes, s->transactions ? (double)s->bytes / s->transactions : 0.0);
+    fprintf(f, "                 %u leituras e %u escritas de registrador, FIFO %u lidos / %u escritos\n",
+            s->reg_reads, s->reg_writes, s->fifo_reads, s->fifo_writes);
+    fprintf(f, "                 CS ativo %.3f ms no total, maior janela %.1f us\n",
+            s->cs_ns / 1e6, s->cs_max_ns / 1e3);
+
+    // Registradores mais acessados
+    for (int r = 0; r < 0x80; r++) {
+        uint32_t n = s->reads_by_reg[r] + s->writes_by_reg[r];
+        for (int i = 0; i < 5; i++) {
+            if (n > top_n[i]) {
+                memmove(&top[i + 1], &top[i], (size_t)(4 - i));
+                memmove(&top_n[i + 1], &top_n[i], (size_t)(4 - i) * sizeof(top_n[0]));
+                top[i] = (uint8_t)r;
+                top_n[i] = n;
+                break;
+            }
+        }
+    }
+    fprintf(f, "                 mais acessados:");
+    for (int i = 0; i < 5 && top_n[i]; i++)
+        fprintf(f, " 0x%02X (%u L/%u E)", top[i], s->reads_by_reg[top[i]], s->writes_by_reg[top[i]]);
+    fprintf(f, "\n");
+
+    fprintf(f, "RFM95 radio:     TX %u (%u interrompidos, %.1f ms no ar), RX %u, CRC %u, "
+            "perdidos %u, incompatíveis %u, timeouts %u, CAD %u\n",
+            s->tx_packets, s->tx_aborted, s->tx_airtime_ns / 1e6, s->rx_packets,
+            s->rx_crc_errors, s->rx_missed, s->rx_mismatch, s->rx_timeouts, s->cad_done);
+    if (s->irq_serviced)
+        fprintf(f, "                 IRQ: %u atendidas, latência média %.1f us, máxima %.1f us\n",
+                s->irq_serviced, s->irq_latency_ns / 1e3 / s->irq_serviced,
+                s->irq_latency_max_ns / 1e3);
+}
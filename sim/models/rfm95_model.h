@@ -0,0 +1,209 @@
+// rfm95_model.h - modelo comportamental do rádio RFM95 (SX1276) em modo LoRa
+#ifndef RFM95_MODEL_H_
+#define RFM95_MODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sim_dev.h"
+
+// ============================================
+// === Modelo do RFM95 ===
+// ============================================
+//
+// Escravo SPI com o mapa de registradores do modo LoRa (valores de reset do
+// datasheet), FIFO de 256 bytes com ponteiros de acesso, TX base e RX base, e
+// os modos SLEEP (FIFO apagado, registradores mantidos), STDBY, FSTX/FSRX, TX,
+// RXCONTINUOUS, RXSINGLE e CAD:
+//
+// - TX volta sozinho para STDBY com TxDone após o tempo no ar calculado de
+//   SF/BW/CR/preâmbulo/cabeçalho/CRC (AN1200.13), e entrega o pacote a on_tx;
+// - um pacote recebido (rfm95_model_rx_begin) passa por ValidHeader ao fim do
+//   cabeçalho, chega ao FIFO byte a byte (RegFifoRxByteAddr avança) e termina
+//   com RxDone (e PayloadCrcError se corrompido), com RSSI/SNR do pacote;
+// - RXSINGLE gera RxTimeout após RegSymbTimeout símbolos sem preâmbulo;
+// - as flags respeitam RegIrqFlagsMask, o DIO0 segue RegDioMapping1[7:6] e o
+//   DIO3 segue RegDioMapping1[1:0] (CadDone, ValidHeader ou PayloadCrcError).
+//
+// O modelo não tem relógio: os eventos vencidos são aplicados a cada acesso SPI
+// e em rfm95_model_poll(), que a plataforma chama ao avançar o tempo
+// (rfm95_model_next_event_ns() diz até quando pode saltar).
+// O pino RESET volta tudo ao padrão; o chip só responde 5 ms após soltá-lo.
+
+#define RFM95_MODEL_VERSION     0x12
+#define RFM95_MODEL_RESET_NS    5000000ull // Datasheet: 5 ms até o SPI responder
+#define RFM95_MODEL_NOISE_DBM   (-120)     // RSSI sem sinal (RegRssiValue)
+
+/**
+ * Pacote no ar, com os parâmetros de quem transmitiu. O receptor só o demodula
+ * se frequência, SF, BW e sync word baterem com a sua configuração.
+ */
+typedef struct {
+    uint8_t  data[256];
+    uint8_t  len;
+    uint32_t frf;               // RegFrf (24 bits)
+    uint8_t  sf;                // 6..12
+    uint8_t  bw_code;           // RegModemConfig1[7:4]
+    uint8_t  cr;                // 1..4 (4/5..4/8)
+    uint8_t  sync_word;
+    uint16_t preamble;
+    bool     crc_on;
+    bool     implicit_header;
+    uint64_t start_ns;          // Início do preâmbulo
+    uint64_t airtime_ns;
+    // Preenchidos pelo canal
+    int16_t  rssi_dbm;
+    float    snr_db;
+    bool     corrupt;           // Chega com erro de CRC
+} rfm95_packet_t;
+
+/**
+ * Contadores de tráfego SPI e de eventos do rádio.
+ */
+typedef struct {
+    // SPI
+    uint32_t transactions;      // Janelas de CS
+    uint32_t bytes;             // Bytes no SPI (incluindo os de endereço)
+    uint32_t reg_reads;
+    uint32_t reg_writes;
+    uint32_t fifo_reads;        // Bytes lidos do FIFO
+    uint32_t fifo_writes;       // Bytes escritos no FIFO
+    uint32_t reads_by_reg[0x80];
+    uint32_t writes_by_reg[0x80];
+    uint64_t cs_ns;             // Tempo total com CS ativo
+    uint64_t cs_max_ns;         // Maior janela de CS
+    // Rádio
+    uint32_t tx_packets;        // Transmissões concluídas (TxDone)
+    uint32_t tx_aborted;        // Transmissões interrompidas por troca de modo
+    uint64_t tx_airtime_ns;     // Soma do tempo no ar (inclui o trecho das interrompidas)
+    uint32_t rx_packets;        // RxDone sem erro de CRC
+    uint32_t rx_crc_errors;
+    uint32_t rx_missed;         // Chegaram fora de RX (ou durante outro pacote)
+    uint32_t rx_mismatch;       // Frequência/SF/BW/sync diferentes
+    uint32_t rx_timeouts;       // RxTimeout em RXSINGLE
+    uint32_t cad_done;
+    // Latência do serviço de IRQ: flag ativa → limpa pelo driver
+    uint32_t irq_serviced;
+    uint64_t irq_latency_ns;
+    uint64_t irq_latency_max_ns;
+} rfm95_stats_t;
+
+typedef enum {
+    RFM95_RX_IDLE,              // Sem pacote
+    RFM95_RX_PREAMBLE,          // Preâmbulo/cabeçalho em curso
+    RFM95_RX_PAYLOAD,           // Cabeçalho válido, payload chegando
+} rfm95_rx_state_t;
+
+typedef struct rfm95_model {
+    uint8_t  regs[0x80];
+    uint8_t  fifo[256];
+
+    // Reset
+    bool     in_reset;
+    uint64_t ready_ns;          // Instante em que o SPI volta a responder
+
+    // Transação SPI
+    bool     selected;
+    bool     have_addr;
+    bool     write;
+    uint8_t  addr;
+    uint64_t cs_start_ns;
+
+    // Transmissão em curso
+    bool     tx_busy;
+    uint64_t tx_start_ns;
+    uint64_t tx_end_ns;
+    rfm95_packet_t tx_pkt;      // Último pacote transmitido
+
+    // Recepção
+    rfm95_rx_state_t rx_state;
+    rfm95_packet_t rx_pkt;
+    uint64_t rx_header_ns;      // ValidHeader
+    uint64_t rx_end_ns;         // RxDone
+    uint8_t  rx_start;          // Posição do pacote no FIFO
+    uint8_t  rx_written;        // Bytes do payload já no FIFO
+    uint8_t  rx_wr;             // Próxima posição de escrita (RegFifoRxByteAddr)
+    uint64_t rx_timeout_ns;     // RXSINGLE: fim da janela (0 = sem)
+
+    // CAD
+    uint64_t cad_end_ns;        // 0 = sem CAD em curso
+    bool     cad_hit;
+
+    // DIO0/DIO3 e latência das flags
+    bool     dio0;
+    bool     dio3;
+    uint64_t irq_set_ns[8];     // Quando cada flag subiu (0 = limpa)
+
+    // Ganchos da plataforma (opcionais)
+    void   (*on_tx)(void *arg, const rfm95_packet_t *pkt);  // Início de uma transmissão
+    void   (*on_dio0)(void *arg, bool level);                // Mudança no pino DIO0
+    void   (*on_dio3)(void *arg, bool level);                // Mudança no pino DIO3
+    void    *hook_arg;
+
+    rfm95_stats_t stats;
+} rfm95_model_t;
+
+/**
+ * @brief Inicializa o modelo no estado de power-on (igual ao fim de um reset).
+ */
+void rfm95_model_init(rfm95_model_t *m);
+
+/**
+ * @brief Tempo no ar de um pacote com a configuração atual dos registradores.
+ * @param len Tamanho do payload em bytes.
+ * @return Duração em nanossegundos.
+ */
+uint64_t rfm95_model_airtime_ns(const rfm95_model_t *m, uint8_t len);
+
+/**
+ * @brief Tempo no ar de um pacote com os parâmetros de `pkt` (AN1200.13 da Semtech).
+ */
+uint64_t rfm95_packet_airtime_ns(const rfm95_packet_t *pkt);
+
+/**
+ * @brief Monta um pacote com a configuração atual do rádio (para injetar no receptor).
+ */
+void rfm95_model_make_packet(const rfm95_model_t *m, rfm95_packet_t *pkt,
+                             const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Entrega ao receptor um pacote que começou no ar em pkt->start_ns (pode
+ * estar no passado). Só é recebido se o rádio está em RX e livre nesse instante.
+ * @return true se o rádio começou a demodular o pacote.
+ */
+bool rfm95_model_rx_begin(rfm95_model_t *m, const rfm95_packet_t *pkt);
+
+/**
+ * @brief Interferência sobre o pacote em demodulação (colisão vista pelo canal
+ * depois do rx_begin): o pacote termina com PayloadCrcError.
+ * @return false se não havia pacote em curso.
+ */
+bool rfm95_model_rx_corrupt(rfm95_model_t *m);
+
+/**
+ * @brief Aplica os eventos vencidos (TxDone, ValidHeader, RxDone, timeouts, CAD).
+ */
+void rfm95_model_poll(rfm95_model_t *m);
+
+/**
+ * @brief Instante do próximo evento agendado, ou UINT64_MAX.
+ */
+uint64_t rfm95_model_next_event_ns(const rfm95_model_t *m);
+
+/**
+ * @brief Nível atual do pino DIO0.
+ */
+bool rfm95_model_dio0(rfm95_model_t *m);
+
+/**
+ * @brief Interface para ligar o modelo a um barramento SPI simulado.
+ */
+sim_spi_dev_t rfm95_model_dev(rfm95_model_t *m);
+
+/**
+ * @brief Imprime os contadores (tráfego SPI, registradores mais acessados, rádio).
+ */
+void rfm95_model_print_stats(const rfm95_model_t *m, FILE *f);
+
+#endif // RFM95_MODEL_H_
@@ -0,0 +1,89 @@
+// sim_dev.h - interface entre os modelos de dispositivo e o barramento simulado
+#ifndef SIM_DEV_H_
+#define SIM_DEV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ============================================
+// === Base de tempo ===
+// ============================================
+//
+// Os modelos não têm relógio próprio: consultam o tempo virtual da plataforma
+// que os hospeda (shim LiteX, mocks do Pico). Cada plataforma implementa esta
+// função; o tempo só avança com acessos ao barramento e esperas do firmware.
+
+/**
+ * @brief Tempo virtual desde o início da simulação, em nanossegundos.
+ */
+uint64_t sim_time_ns(void);
+
+/**
+ * Fonte de eventos com horário (modelo de rádio, gerador de pacotes, canal).
+ * next_ns() diz quando é o próximo evento (UINT64_MAX = nenhum); poll() aplica
+ * os eventos vencidos no tempo atual. A plataforma chama poll() ao avançar o
+ * tempo até next_ns().
+ */
+typedef struct {
+    uint64_t (*next_ns)(void *ctx);
+    void     (*poll)(void *ctx);
+    void     *ctx;
+} sim_source_t;
+
+// ============================================
+// === Dispositivos SPI ===
+// ============================================
+
+/**
+ * Escravo SPI (modo 0, MSB primeiro). O barramento chama select() nas bordas
+ * do CS e xfer() a cada byte full-duplex com CS ativo. Um mestre que gera os
+ * bits nos pinos (PIO) precisa do MISO antes do fim do byte: peek() o dá sem
+ * efeitos colaterais, e o xfer() do fim do byte devolve o mesmo valor.
+ */
+typedef struct {
+    void    (*select)(void *ctx, bool active);  // CS ativo (pino em nível baixo)
+    uint8_t (*xfer)(void *ctx, uint8_t mosi);   // Um byte; retorna o MISO
+    void    (*reset)(void *ctx, bool active);   // Pino RESET ativo (nível baixo), opcional
+    uint8_t (*peek)(void *ctx);                 // MISO do próximo byte, opcional
+    void *ctx;
+} sim_spi_dev_t;
+
+/**
+ * @brief Troca `len` bytes full-duplex com o CS já ativo (controlado à parte,
+ * como um GPIO de CS).
+ * @param tx Bytes enviados (NULL = 0x00); rx recebe o MISO (NULL = descarta).
+ */
+static inline void sim_spi_xfer_buf(const sim_spi_dev_t *dev, const uint8_t *tx,
+                                    uint8_t *rx, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        uint8_t miso = dev->xfer(dev->ctx, tx ? tx[i] : 0x00);
+        if (rx) rx[i] = miso;
+    }
+}
+
+// ============================================
+// === Dispositivos I2C ===
+// ============================================
+
+/**
+ * Escravo I2C no nível dos pinos (para o bit-bang do LiteX). O barramento chama
+ * line() a cada mudança de SCL/SDA com os níveis impostos pelo mestre; o SDA lido
+ * pelo mestre é o wired-AND disso com o retorno de cada dispositivo.
+ */
+typedef struct {
+    int  (*line)(void *ctx, int scl, int sda);  // Retorna o nível imposto em SDA (1 = solto)
+    void *ctx;
+} sim_i2c_dev_t;
+
+/**
+ * Escravo I2C no nível de transação (para controladores I2C em hardware, como
+ * o do RP2040). Cada chamada é uma transação endereçada a este dispositivo.
+ */
+typedef struct {
+    int  (*write)(void *ctx, const uint8_t *src, size_t len); // Bytes aceitos (ACK); < len = NACK
+    int  (*read)(void *ctx, uint8_t *dst, size_t len);        // Bytes lidos, opcional
+    void *ctx;
+} sim_i2c_msg_dev_t;
+
+#endif // SIM_DEV_H_
@@ -0,0 +1,175 @@
+// ssd1306_model.c
+#include "ssd1306_model.h"
+
+#include <string.h>
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define CTRL_CO                 0x80 // Só um byte segue; depois vem outro byte de controle
+#define CTRL_DC                 0x40 // Dados (GDDRAM) em vez de comandos
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+// Argumentos de cada comando multi-byte (datasheet, tabela 9-1)
+static uint8_t cmd_nargs(uint8_t cmd) {
+    switch (cmd) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void exec_cmd(ssd1306_model_t *m) {
+    const uint8_t *a = m->cmd_args;
+    uint8_t c = m->cmd;
+
+    switch (c) {
+    case 0x20: m->addr_mode = a[0] & 0x03; break;
+    case 0x21:
+        m->col_start = m->col = a[0] & 0x7F;
+        m->col_end = a[1] & 0x7F;
+        break;
+    case 0x22:
+        m->page_start = m->page = a[0] & 0x07;
+        m->page_end = a[1] & 0x07;
+        break;
+    case 0x81: m->contrast = a[0]; break;
+    case 0xA4: case 0xA5: m->entire_on = c & 1; break;
+    case 0xA6: case 0xA7: m->inverted = c & 1; break;
+    case 0xAE: case 0xAF: m->display_on = c & 1; break;
+    default:
+        // Modo página: coluna inicial (nibbles) e página
+        if (c <= 0x0F)                  m->col = (uint8_t)((m->col & 0xF0) | c);
+        else if (c <= 0x1F)             m->col = (uint8_t)((m->col & 0x0F) | ((c & 0x07) << 4));
+        else if (c >= 0xB0 && c <= 0xB7) m->page = c & 0x07;
+        break;                          // Demais: só afetam o painel, não a GDDRAM
+    }
+}
+
+static void command_byte(ssd1306_model_t *m, uint8_t b) {
+    m->stats.cmd_bytes++;
+    if (m->cmd_got < m->cmd_nargs) {
+        m->cmd_args[m->cmd_got++] = b;
+        if (m->cmd_got == m->cmd_nargs) exec_cmd(m);
+        return;
+    }
+    m->cmd = b;
+    m->cmd_nargs = cmd_nargs(b);
+    m->cmd_got = 0;
+    if (!m->cmd_nargs) exec_cmd(m);
+}
+
+static void data_byte(ssd1306_model_t *m, uint8_t b) {
+    m->stats.data_bytes++;
+    m->gddram[m->page & 0x07][m->col & 0x7F] = b;
+
+    switch (m->addr_mode) {
+    case 0:                             // Horizontal
+        if (m->col++ >= m->col_end) {
+            m->col = m->col_start;
+            m->page = m->page >= m->page_end ? m->page_start : m->page + 1;
+        }
+        break;
+    case 1:                             // Vertical
+        if (m->page++ >= m->page_end) {
+            m->page = m->page_start;
+            m->col = m->col >= m->col_end ? m->col_start : m->col + 1;
+        }
+        break;
+    default:                            // Página: a coluna para no fim
+        if (m->col < 127) m->col++;
+        break;
+    }
+}
+
+static int i2c_write(void *ctx, const uint8_t *src, size_t len) {
+    ssd1306_model_t *m = ctx;
+    bool ctrl = true, data = false, any_data = false, single = false;
+
+    if (m->nack) {
+        m->nack--;
+        m->stats.nacks++;
+        return 0;
+    }
+    m->stats.transactions++;
+    for (size_t i = 0; i < len; i++) {
+        if (ctrl) {
+            m->stats.ctrl_bytes++;
+            single = (src[i] & CTRL_CO) != 0;
+            data = (src[i] & CTRL_DC) != 0;
+            ctrl = false;
+            continue;
+        }
+        if (data) { data_byte(m, src[i]); any_data = true; }
+        else      command_byte(m, src[i]);
+        if (single) ctrl = true;
+    }
+    if (any_data) {
+        m->stats.frames++;
+        if (m->on_frame) m->on_frame(m->hook_arg, m);
+    }
+    return (int)len;
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+void ssd1306_model_init(ssd1306_model_t *m) {
+    memset(m, 0, sizeof(*m));
+    m->contrast = 0x7F;
+    m->addr_mode = 2;
+    m->col_end = SSD1306_MODEL_WIDTH - 1;
+    m->page_end = SSD1306_MODEL_PAGES - 1;
+}
+
+sim_i2c_msg_dev_t ssd1306_model_dev(ssd1306_model_t *m) {
+    return (sim_i2c_msg_dev_t){ .write = i2c_write, .read = NULL, .ctx = m };
+}
+
+bool ssd1306_model_pixel(const ssd1306_model_t *m, unsigned x, unsigned y) {
+    bool on;
+
+    if (x >= SSD1306_MODEL_WIDTH || y >= SSD1306_MODEL_PAGES * 8) return false;
+    on = m->entire_on || ((m->gddram[y >> 3][x] >> (y & 7)) & 1);
+    return on != m->inverted;
+}
+
+bool ssd1306_model_write_pbm(const ssd1306_model_t *m, const char *path) {
+    FILE *f = fopen(path, "wb");
+
+    if (!f) return false;
+    fprintf(f, "P4\n%d %d\n", SSD1306_MODEL_WIDTH, SSD1306_MODEL_PAGES * 8);
+    for (unsigned y = 0; y < SSD1306_MODEL_PAGES * 8; y++) {
+        for (unsigned x = 0; x < SSD1306_MODEL_WIDTH; x += 8) {
+            uint8_t b = 0;
+            for (unsigned k = 0; k < 8; k++)
+                if (ssd1306_model_pixel(m, x + k, y)) b |= (uint8_t)(0x80 >> k);
+            fputc(b, f);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+void ssd1306_model_print(const ssd1306_model_t *m, FILE *f) {
+    static const char *cells[4] = { " ", "▀", "▄", "█" };
+
+    for (unsigned y = 0; y < SSD1306_MODEL_PAGES * 8; y += 2) {
+        fputc('|', f);
+        for (unsigned x = 0; x < SSD1306_MODEL_WIDTH; x++)
+            fputs(cells[ssd1306_model_pixel(m, x, y) | (ssd1306_model_pixel(m, x, y + 1) << 1)], f);
+        fputs("|\n", f);
+    }
+}
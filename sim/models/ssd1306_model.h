@@ -0,0 +1,89 @@
+// ssd1306_model.h - modelo do controlador de display OLED SSD1306 (escravo I2C)
+#ifndef SSD1306_MODEL_H_
+#define SSD1306_MODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sim_dev.h"
+
+// ============================================
+// === Modelo do SSD1306 ===
+// ============================================
+//
+// Recebe as transações I2C como o controlador real: o primeiro byte é o de
+// controle (Co, D/C#), seguido de comandos (com seus argumentos) ou de dados
+// para a GDDRAM. Os dados seguem o modo de endereçamento (página, horizontal ou
+// vertical) e as janelas de coluna/página, então a GDDRAM capturada é o que o
+// painel mostraria. Conta bytes de comando e de dados e chama on_frame ao fim
+// de cada transação com dados.
+
+#define SSD1306_MODEL_ADDR      0x3C
+#define SSD1306_MODEL_WIDTH     128
+#define SSD1306_MODEL_PAGES     8       // 64 linhas
+
+typedef struct {
+    uint32_t transactions;      // Escritas I2C endereçadas ao display
+    uint32_t cmd_bytes;         // Bytes de comando (incluindo argumentos)
+    uint32_t data_bytes;        // Bytes escritos na GDDRAM
+    uint32_t ctrl_bytes;        // Bytes de controle
+    uint32_t frames;            // Transações com dados
+    uint32_t nacks;             // Transações recusadas por ssd1306_model_t.nack
+} ssd1306_stats_t;
+
+typedef struct ssd1306_model {
+    uint8_t  gddram[SSD1306_MODEL_PAGES][SSD1306_MODEL_WIDTH];
+
+    // Estado do controlador
+    bool     display_on;
+    bool     inverted;
+    bool     entire_on;
+    uint8_t  contrast;
+    uint8_t  addr_mode;         // 0 horizontal, 1 vertical, 2 página (reset)
+    uint8_t  col, col_start, col_end;
+    uint8_t  page, page_start, page_end;
+
+    // Decodificação de comandos com argumentos
+    uint8_t  cmd;
+    uint8_t  cmd_args[6];
+    uint8_t  cmd_nargs;         // Argumentos esperados
+    uint8_t  cmd_got;
+
+    // Injeção de falha: as próximas `nack` transações levam NACK no endereço
+    uint32_t nack;
+
+    // Gancho da plataforma (opcional): fim de uma transação com dados
+    void   (*on_frame)(void *arg, const struct ssd1306_model *m);
+    void    *hook_arg;
+
+    ssd1306_stats_t stats;
+} ssd1306_model_t;
+
+/**
+ * @brief Inicializa o modelo no estado de reset (display desligado, modo página).
+ */
+void ssd1306_model_init(ssd1306_model_t *m);
+
+/**
+ * @brief Interface para ligar o modelo a um controlador I2C simulado.
+ */
+sim_i2c_msg_dev_t ssd1306_model_dev(ssd1306_model_t *m);
+
+/**
+ * @brief Estado de um pixel como o driver o desenha (x = coluna, y = linha).
+ */
+bool ssd1306_model_pixel(const ssd1306_model_t *m, unsigned x, unsigned y);
+
+/**
+ * @brief Grava a GDDRAM como imagem PBM (P4) de 128x64.
+ * @return false se não conseguiu escrever o arquivo.
+ */
+bool ssd1306_model_write_pbm(const ssd1306_model_t *m, const char *path);
+
+/**
+ * @brief Desenha a GDDRAM em texto (duas linhas de pixels por linha de texto).
+ */
+void ssd1306_model_print(const ssd1306_model_t *m, FILE *f);
+
+#endif // SSD1306_MODEL_H_
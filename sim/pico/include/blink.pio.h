@@ -0,0 +1,43 @@
+// blink.pio.h - equivalente à saída do pioasm para bitdoglab/blink.pio (não roda no host)
+#ifndef SIM_BLINK_PIO_H_
+#define SIM_BLINK_PIO_H_
+
+#include "hardware/pio.h"
+
+#define blink_wrap_target 2
+#define blink_wrap 7
+
+static const uint16_t blink_program_instructions[] = {
+    0x80a0, //  0: pull   block
+    0x6040, //  1: out    y, 32
+            //     .wrap_target
+    0xa022, //  2: mov    x, y
+    0xe001, //  3: set    pins, 1
+    0x0044, //  4: jmp    x--, 4
+    0xa022, //  5: mov    x, y
+    0xe000, //  6: set    pins, 0
+    0x0047, //  7: jmp    x--, 7
+            //     .wrap
+};
+
+static const struct pio_program blink_program = {
+    .instructions = blink_program_instructions,
+    .length = 8,
+    .origin = -1,
+};
+
+static inline pio_sm_config blink_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + blink_wrap_target, offset + blink_wrap);
+    return c;
+}
+
+static inline void blink_program_init(PIO pio, uint sm, uint offset, uint pin) {
+    pio_gpio_init(pio, pin);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin, 1, true);
+    pio_sm_config c = blink_program_get_default_config(offset);
+    sm_config_set_set_pins(&c, pin, 1);
+    pio_sm_init(pio, sm, offset, &c);
+}
+
+#endif // SIM_BLINK_PIO_H_
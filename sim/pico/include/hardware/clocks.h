@@ -0,0 +1,19 @@
+// hardware/clocks.h - frequências fixas dos relógios (configuração padrão do SDK)
+#ifndef SIM_HARDWARE_CLOCKS_H_
+#define SIM_HARDWARE_CLOCKS_H_
+
+#include "pico/types.h"
+
+enum clock_index { clk_gpout0 = 0, clk_gpout1, clk_gpout2, clk_gpout3, clk_ref, clk_sys, clk_peri, clk_usb, clk_adc, clk_rtc };
+
+static inline uint32_t clock_get_hz(enum clock_index clk) {
+    switch (clk) {
+    case clk_ref:  return 12000000;
+    case clk_usb:
+    case clk_adc:  return 48000000;
+    case clk_rtc:  return 46875;
+    default:       return 125000000;    // clk_sys e clk_peri
+    }
+}
+
+#endif // SIM_HARDWARE_CLOCKS_H_
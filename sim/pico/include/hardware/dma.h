@@ -0,0 +1,56 @@
+// hardware/dma.h - subconjunto do hardware_dma: canais com DREQ, encadeamento e IRQ
+#ifndef SIM_HARDWARE_DMA_H_
+#define SIM_HARDWARE_DMA_H_
+
+#include "pico/types.h"
+#include "hardware/regs/dreq.h"
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+// No SDK é o CTRL do canal; aqui os campos ficam separados
+typedef struct {
+    uint8_t size;
+    bool    read_incr;
+    bool    write_incr;
+    uint8_t dreq;
+    uint8_t chain_to;           // = o próprio canal: sem encadeamento
+} dma_channel_config;
+
+int  dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+dma_channel_config dma_channel_get_default_config(uint channel);
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c,
+                                                         enum dma_channel_transfer_size size) {
+    c->size = (uint8_t)size;
+}
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) { c->read_incr = incr; }
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) { c->write_incr = incr; }
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) { c->dreq = (uint8_t)dreq; }
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint chan) { c->chain_to = (uint8_t)chan; }
+
+/**
+ * @brief Configura endereços, contagem e CTRL; dispara se `trigger`.
+ */
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger);
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+void dma_start_channel_mask(uint32_t chan_mask);
+static inline void dma_channel_start(uint channel) { dma_start_channel_mask(1u << channel); }
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_wait_for_finish_blocking(uint channel);
+
+// IRQ de fim de transferência: cada canal pode sinalizar DMA_IRQ_0 e/ou DMA_IRQ_1
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+void dma_channel_set_irq1_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+bool dma_channel_get_irq1_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+void dma_channel_acknowledge_irq1(uint channel);
+
+#endif // SIM_HARDWARE_DMA_H_
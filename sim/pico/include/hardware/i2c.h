@@ -0,0 +1,46 @@
+// hardware/i2c.h - controladores I2C (DW_apb_i2c) do RP2040 ligados a modelos de dispositivo
+#ifndef SIM_HARDWARE_I2C_H_
+#define SIM_HARDWARE_I2C_H_
+
+#include "pico/types.h"
+#include "hardware/regs/dreq.h"
+
+typedef struct i2c_inst i2c_inst_t;
+
+// Endereços constantes, como os do SDK: servem em inicializadores estáticos
+extern i2c_inst_t sim_i2c0, sim_i2c1;
+#define i2c0 (&sim_i2c0)
+#define i2c1 (&sim_i2c1)
+
+// Registradores do DW_apb_i2c usados para mandar bytes por DMA: TAR (endereço do
+// escravo, com ENABLE em 0), DATA_CMD (byte + STOP/RESTART), STATUS (ACTIVITY) e
+// TX_ABRT_SOURCE. Um NACK aborta: o FIFO de TX descarta tudo até a leitura de
+// IC_CLR_TX_ABRT, que aqui vira uma chamada (hw->clr_tx_abrt continua valendo).
+#define clr_tx_abrt clr_tx_abrt_read()
+typedef struct {
+    volatile uint32_t con, tar, data_cmd, enable, status, txflr, dma_cr;
+    volatile uint32_t tx_abrt_source;
+    uint32_t (*clr_tx_abrt_read)(void);
+} i2c_hw_t;
+
+#define I2C_IC_DATA_CMD_STOP_BITS       0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS    0x00000400u
+#define I2C_IC_STATUS_ACTIVITY_BITS     0x00000001u
+#define I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS 0x00000001u
+#define I2C_IC_TX_ABRT_SOURCE_ABRT_TXDATA_NOACK_BITS  0x00000008u
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c);
+
+static inline uint i2c_hw_index(i2c_inst_t *i2c) { return i2c == i2c1 ? 1u : 0u; }
+
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return (i2c_hw_index(i2c) ? DREQ_I2C1_TX : DREQ_I2C0_TX) + (is_tx ? 0u : 1u);
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif // SIM_HARDWARE_I2C_H_
@@ -0,0 +1,26 @@
+// hardware/irq.h - tabela de IRQs do RP2040; a simulação despacha no núcleo que as habilitou
+#ifndef SIM_HARDWARE_IRQ_H_
+#define SIM_HARDWARE_IRQ_H_
+
+#include "pico/types.h"
+
+#define DMA_IRQ_0       11
+#define DMA_IRQ_1       12
+#define IO_IRQ_BANK0    13
+#define I2C0_IRQ        23
+#define I2C1_IRQ        24
+#define NUM_IRQS        32
+
+typedef void (*irq_handler_t)(void);
+
+/**
+ * @brief Instala o handler da IRQ `num` (um só por IRQ, como no SDK).
+ */
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+
+/**
+ * @brief Habilita a IRQ `num` no NVIC do núcleo que chama.
+ */
+void irq_set_enabled(uint num, bool enabled);
+
+#endif // SIM_HARDWARE_IRQ_H_
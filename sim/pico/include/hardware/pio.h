@@ -0,0 +1,129 @@
+// hardware/pio.h - blocos PIO do RP2040: máquinas de estados executadas pela simulação
+#ifndef SIM_HARDWARE_PIO_H_
+#define SIM_HARDWARE_PIO_H_
+
+#include "pico/types.h"
+#include "hardware/regs/dreq.h"
+
+#define NUM_PIOS                2
+#define NUM_PIO_STATE_MACHINES  4
+#define PIO_INSTRUCTION_COUNT   32
+
+// Só os FIFOs, para o DMA apontar para eles; a CPU usa pio_sm_put()/pio_sm_get()
+typedef struct pio_hw {
+    volatile uint32_t txf[NUM_PIO_STATE_MACHINES];
+    volatile uint32_t rxf[NUM_PIO_STATE_MACHINES];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+
+// Endereços constantes, como os do SDK: servem em inicializadores estáticos
+extern pio_hw_t sim_pio0, sim_pio1;
+#define pio0 (&sim_pio0)
+#define pio1 (&sim_pio1)
+
+enum pio_fifo_join { PIO_FIFO_JOIN_NONE = 0, PIO_FIFO_JOIN_TX = 1, PIO_FIFO_JOIN_RX = 2 };
+
+// No SDK são os registradores CLKDIV/EXECCTRL/SHIFTCTRL/PINCTRL; aqui os campos ficam separados
+typedef struct {
+    float   clkdiv;
+    uint8_t wrap_target, wrap;
+    uint8_t out_base, out_count;
+    uint8_t set_base, set_count;
+    uint8_t in_base;
+    uint8_t sideset_base;
+    uint8_t sideset_bits;       // Inclui o bit de habilitação quando opcional
+    bool    sideset_opt;
+    bool    sideset_pindirs;
+    bool    out_shift_right, autopull;
+    uint8_t pull_thresh;
+    bool    in_shift_right, autopush;
+    uint8_t push_thresh;
+    uint8_t fifo_join;
+} pio_sm_config;
+
+typedef struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;              // -1: qualquer posição livre
+} pio_program_t;
+
+static inline uint pio_get_index(PIO pio) { return pio == pio1 ? 1u : 0u; }
+
+static inline uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    return (pio_get_index(pio) ? DREQ_PIO1_TX0 : DREQ_PIO0_TX0) + sm + (is_tx ? 0u : NUM_PIO_STATE_MACHINES);
+}
+
+// === Configuração (mesmos padrões do SDK) ===
+
+static inline pio_sm_config pio_get_default_sm_config(void) {
+    return (pio_sm_config){ .clkdiv = 1.0f, .wrap = PIO_INSTRUCTION_COUNT - 1,
+                            .out_shift_right = true, .pull_thresh = 32,
+                            .in_shift_right = true, .push_thresh = 32 };
+}
+static inline void sm_config_set_wrap(pio_sm_config *c, uint wrap_target, uint wrap) {
+    c->wrap_target = (uint8_t)wrap_target;
+    c->wrap = (uint8_t)wrap;
+}
+static inline void sm_config_set_out_pins(pio_sm_config *c, uint base, uint count) {
+    c->out_base = (uint8_t)base;
+    c->out_count = (uint8_t)count;
+}
+static inline void sm_config_set_set_pins(pio_sm_config *c, uint base, uint count) {
+    c->set_base = (uint8_t)base;
+    c->set_count = (uint8_t)count;
+}
+static inline void sm_config_set_in_pins(pio_sm_config *c, uint base) { c->in_base = (uint8_t)base; }
+static inline void sm_config_set_sideset_pins(pio_sm_config *c, uint base) { c->sideset_base = (uint8_t)base; }
+static inline void sm_config_set_sideset(pio_sm_config *c, uint bit_count, bool optional, bool pindirs) {
+    c->sideset_bits = (uint8_t)bit_count;
+    c->sideset_opt = optional;
+    c->sideset_pindirs = pindirs;
+}
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float div) { c->clkdiv = div < 1.0f ? 1.0f : div; }
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold) {
+    c->out_shift_right = shift_right;
+    c->autopull = autopull;
+    c->pull_thresh = (uint8_t)(pull_threshold ? pull_threshold : 32);
+}
+static inline void sm_config_set_in_shift(pio_sm_config *c, bool shift_right, bool autopush, uint push_threshold) {
+    c->in_shift_right = shift_right;
+    c->autopush = autopush;
+    c->push_thresh = (uint8_t)(push_threshold ? push_threshold : 32);
+}
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join join) { c->fifo_join = (uint8_t)join; }
+
+// === Programas e máquinas de estados ===
+//
+// Executadas no ritmo clk_sys / clkdiv: JMP, WAIT (gpio/pin), IN, OUT, PUSH,
+// PULL, MOV e SET, com side-set, atrasos, autopush/autopull e os DREQs do DMA.
+// IRQ e WAIT irq não são modelados.
+
+uint pio_add_program(PIO pio, const pio_program_t *program);
+int  pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_unclaim(PIO pio, uint sm);
+
+/**
+ * @brief Aplica a configuração, esvazia os FIFOs e põe o PC em `initial_pc`; a máquina fica parada.
+ */
+int  pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+
+void pio_gpio_init(PIO pio, uint pin);
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values, uint32_t pin_mask);
+void pio_sm_set_pindirs_with_mask(PIO pio, uint sm, uint32_t pin_dirs, uint32_t pin_mask);
+int  pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out);
+
+// FIFOs pela CPU; as versões _blocking esperam a máquina de estados (CPU ocupada)
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm);
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm);
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm);
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm);
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm);
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+uint32_t pio_sm_get(PIO pio, uint sm);
+uint32_t pio_sm_get_blocking(PIO pio, uint sm);
+
+#endif // SIM_HARDWARE_PIO_H_
@@ -0,0 +1,19 @@
+// hardware/regs/dreq.h - números de DREQ do RP2040 usados pelos mocks
+#ifndef SIM_HARDWARE_REGS_DREQ_H_
+#define SIM_HARDWARE_REGS_DREQ_H_
+
+#define DREQ_PIO0_TX0   0       // + máquina de estados
+#define DREQ_PIO0_RX0   4
+#define DREQ_PIO1_TX0   8
+#define DREQ_PIO1_RX0   12
+#define DREQ_SPI0_TX    16
+#define DREQ_SPI0_RX    17
+#define DREQ_SPI1_TX    18
+#define DREQ_SPI1_RX    19
+#define DREQ_I2C0_TX    32
+#define DREQ_I2C0_RX    33
+#define DREQ_I2C1_TX    34
+#define DREQ_I2C1_RX    35
+#define DREQ_FORCE      63      // Sem DREQ: o canal corre livre
+
+#endif // SIM_HARDWARE_REGS_DREQ_H_
@@ -0,0 +1,41 @@
+// hardware/spi.h - controladores SPI (PL022) do RP2040 ligados a modelos de dispositivo
+#ifndef SIM_HARDWARE_SPI_H_
+#define SIM_HARDWARE_SPI_H_
+
+#include "pico/types.h"
+#include "hardware/regs/dreq.h"
+
+typedef struct spi_inst spi_inst_t;
+
+// Endereços constantes, como os do SDK: servem em inicializadores estáticos
+extern spi_inst_t sim_spi0, sim_spi1;
+#define spi0 (&sim_spi0)
+#define spi1 (&sim_spi1)
+
+typedef enum { SPI_CPHA_0 = 0, SPI_CPHA_1 = 1 } spi_cpha_t;
+typedef enum { SPI_CPOL_0 = 0, SPI_CPOL_1 = 1 } spi_cpol_t;
+typedef enum { SPI_LSB_FIRST = 0, SPI_MSB_FIRST = 1 } spi_order_t;
+
+// Registradores do PL022; para o DMA só o DR importa
+typedef struct {
+    volatile uint32_t cr0, cr1, dr, sr, cpsr, imsc, ris, mis, icr, dmacr;
+} spi_hw_t;
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi);
+
+static inline uint spi_get_index(const spi_inst_t *spi) { return spi == spi1 ? 1u : 0u; }
+
+static inline uint spi_get_dreq(spi_inst_t *spi, bool is_tx) {
+    return (spi_get_index(spi) ? DREQ_SPI1_TX : DREQ_SPI0_TX) + (is_tx ? 0u : 1u);
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+void spi_deinit(spi_inst_t *spi);
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate);
+uint spi_get_baudrate(const spi_inst_t *spi);
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len);
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len);
+
+#endif // SIM_HARDWARE_SPI_H_
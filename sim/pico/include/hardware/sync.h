@@ -0,0 +1,39 @@
+// hardware/sync.h - WFE/SEV e seções críticas do RP2040 sobre o tempo virtual
+#ifndef SIM_HARDWARE_SYNC_H_
+#define SIM_HARDWARE_SYNC_H_
+
+#include "pico/types.h"
+
+/**
+ * @brief Dorme até um evento: avança o tempo virtual até uma IRQ (GPIO,
+ * timer) ou um __sev(). Retorna na hora se o registrador de evento já estava
+ * ligado, e o limpa.
+ */
+void __wfe(void);
+
+/**
+ * @brief Liga o registrador de evento (acorda o próximo __wfe()).
+ */
+void __sev(void);
+
+/**
+ * @brief Como __wfe(), mas só uma IRQ acorda.
+ */
+void __wfi(void);
+
+/**
+ * @brief Núcleo que está executando (no SDK vem de pico/platform.h).
+ */
+uint get_core_num(void);
+
+/**
+ * @brief Seção crítica: bordas de GPIO e timers que vencem dentro dela ficam
+ * pendentes e são atendidos em restore_interrupts(). Aninha como no SDK.
+ */
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+// Barreira de memória: o host já vê as escritas em ordem dentro do processo
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+#endif // SIM_HARDWARE_SYNC_H_
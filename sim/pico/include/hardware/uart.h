@@ -0,0 +1,9 @@
+// hardware/uart.h - a UART do RP2040 não é usada diretamente (stdio vai para o stdout)
+#ifndef SIM_HARDWARE_UART_H_
+#define SIM_HARDWARE_UART_H_
+
+#include "pico/types.h"
+
+typedef struct uart_inst uart_inst_t;
+
+#endif // SIM_HARDWARE_UART_H_
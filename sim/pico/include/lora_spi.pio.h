@@ -0,0 +1,58 @@
+// lora_spi.pio.h - equivalente à saída do pioasm para bitdoglab/lora_spi.pio
+#ifndef SIM_LORA_SPI_PIO_H_
+#define SIM_LORA_SPI_PIO_H_
+
+#include "hardware/pio.h"
+
+#define lora_spi_wrap_target 0
+#define lora_spi_wrap 5
+
+static const uint16_t lora_spi_program_instructions[] = {
+            //     .wrap_target
+    0x88e0, //  0: pull   ifempty block   side 1
+    0x6820, //  1: out    x, 32           side 1
+    0x6101, //  2: out    pins, 1         side 0 [1]
+    0x5001, //  3: in     pins, 1         side 2
+    0x1042, //  4: jmp    x--, 2          side 2
+    0xa142, //  5: nop                    side 0 [1]
+            //     .wrap
+};
+
+static const struct pio_program lora_spi_program = {
+    .instructions = lora_spi_program_instructions,
+    .length = 6,
+    .origin = -1,
+};
+
+static inline pio_sm_config lora_spi_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + lora_spi_wrap_target, offset + lora_spi_wrap);
+    sm_config_set_sideset(&c, 2, false, false);
+    return c;
+}
+
+static inline void lora_spi_program_init(PIO pio, uint sm, uint offset, uint pin_cs,
+                                         uint pin_mosi, uint pin_miso, float clkdiv) {
+    pio_sm_config c = lora_spi_program_get_default_config(offset);
+    uint32_t outs = (3u << pin_cs) | (1u << pin_mosi);
+
+    sm_config_set_out_pins(&c, pin_mosi, 1);
+    sm_config_set_in_pins(&c, pin_miso);
+    sm_config_set_sideset_pins(&c, pin_cs);
+    sm_config_set_out_shift(&c, false, true, 8);
+    sm_config_set_in_shift(&c, false, true, 8);
+    sm_config_set_clkdiv(&c, clkdiv);
+
+    // CS alto e SCK baixo antes de a PIO assumir os pinos
+    pio_sm_set_pins_with_mask(pio, sm, 1u << pin_cs, outs);
+    pio_sm_set_pindirs_with_mask(pio, sm, outs, outs | (1u << pin_miso));
+    pio_gpio_init(pio, pin_cs);
+    pio_gpio_init(pio, pin_cs + 1);
+    pio_gpio_init(pio, pin_mosi);
+    pio_gpio_init(pio, pin_miso);
+
+    pio_sm_init(pio, sm, offset, &c);
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+#endif // SIM_LORA_SPI_PIO_H_
@@ -0,0 +1,8 @@
+// pico/binary_info.h - metadados do binário não existem no host
+#ifndef SIM_PICO_BINARY_INFO_H_
+#define SIM_PICO_BINARY_INFO_H_
+
+#define bi_decl(...)
+#define bi_decl_if_func_used(...)
+
+#endif // SIM_PICO_BINARY_INFO_H_
@@ -0,0 +1,38 @@
+// pico/multicore.h - pico_multicore: core1 e o FIFO entre núcleos do SIO
+#ifndef SIM_PICO_MULTICORE_H_
+#define SIM_PICO_MULTICORE_H_
+
+#include "pico/types.h"
+
+/**
+ * @brief Lança `entry` no core1 (na simulação, uma thread que alterna com o
+ * core0 nos pontos de espera).
+ */
+void multicore_launch_core1(void (*entry)(void));
+
+/**
+ * @brief Há palavra no FIFO de entrada deste núcleo.
+ */
+bool multicore_fifo_rvalid(void);
+
+/**
+ * @brief Cabe palavra no FIFO para o outro núcleo (8 palavras).
+ */
+bool multicore_fifo_wready(void);
+
+/**
+ * @brief Envia uma palavra ao outro núcleo; espera em __wfe() com o FIFO cheio.
+ */
+void multicore_fifo_push_blocking(uint32_t data);
+
+/**
+ * @brief Recebe uma palavra do outro núcleo; espera em __wfe() com o FIFO vazio.
+ */
+uint32_t multicore_fifo_pop_blocking(void);
+
+/**
+ * @brief Descarta o que houver no FIFO de entrada.
+ */
+void multicore_fifo_drain(void);
+
+#endif // SIM_PICO_MULTICORE_H_
@@ -0,0 +1,27 @@
+// pico/stdlib.h - subconjunto do pico_stdlib para o build no host
+#ifndef SIM_PICO_STDLIB_H_
+#define SIM_PICO_STDLIB_H_
+
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+
+/**
+ * @brief stdio do host; o stdout fica com buffer de linha.
+ */
+bool stdio_init_all(void);
+
+/**
+ * @brief Corpo de laço de espera ativa: avança o tempo virtual em 1 µs.
+ */
+void tight_loop_contents(void);
+
+/**
+ * @brief Como o hard_assert() do SDK (vale também em release): no host mostra
+ * a condição e termina o processo.
+ */
+#define hard_assert(cond) ((cond) ? (void)0 : sim_pico_hard_assert(#cond, __FILE__, __LINE__))
+void sim_pico_hard_assert(const char *cond, const char *file, int line);
+
+#endif // SIM_PICO_STDLIB_H_
@@ -0,0 +1,55 @@
+// pico/time.h - pico_time sobre o tempo virtual da simulação
+#ifndef SIM_PICO_TIME_H_
+#define SIM_PICO_TIME_H_
+
+#include "pico/types.h"
+
+absolute_time_t get_absolute_time(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+static inline uint64_t time_us_64(void) { return get_absolute_time(); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return delayed_by_ms(get_absolute_time(), ms); }
+
+// Timers repetitivos: o callback roda em contexto de IRQ no instante agendado
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+
+struct repeating_timer {
+    int64_t delay_us;
+    repeating_timer_callback_t callback;
+    void *user_data;
+    // Simulação
+    uint64_t next_ns;
+    bool active;
+    uint8_t sim_core;           // Núcleo que recebe a IRQ do alarme
+    struct repeating_timer *sim_next;
+};
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out);
+bool cancel_repeating_timer(repeating_timer_t *timer);
+
+// Pools de alarmes: a IRQ do pool é do núcleo que o criou (o pool padrão, usado
+// por add_repeating_timer_*, é do núcleo que chamou)
+typedef struct alarm_pool alarm_pool_t;
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers);
+bool alarm_pool_add_repeating_timer_us(alarm_pool_t *pool, int64_t delay_us, repeating_timer_callback_t callback,
+                                       void *user_data, repeating_timer_t *out);
+
+static inline bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback,
+                                          void *user_data, repeating_timer_t *out) {
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+#endif // SIM_PICO_TIME_H_
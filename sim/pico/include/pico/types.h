@@ -0,0 +1,22 @@
+// pico/types.h - tipos básicos do pico-sdk para o build no host
+#ifndef SIM_PICO_TYPES_H_
+#define SIM_PICO_TYPES_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+// Tempo absoluto em µs desde o boot (PICO_OPAQUE_ABSOLUTE_TIME_T desligado)
+typedef uint64_t absolute_time_t;
+
+enum pico_error_codes {
+    PICO_OK                 = 0,
+    PICO_ERROR_NONE         = 0,
+    PICO_ERROR_TIMEOUT      = -1,
+    PICO_ERROR_GENERIC      = -2,
+    PICO_ERROR_NO_DATA      = -3,
+};
+
+#endif // SIM_PICO_TYPES_H_
@@ -0,0 +1,1771 @@
+// pico_sim.c
+#include "pico_sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+
+// ============================================
+// === Estado ===
+// ============================================
+
+struct spi_inst {
+    uint            baud;
+    sim_spi_dev_t   dev;
+    bool            attached;
+    bool            selected;
+    int             cs_pin;
+    int             rst_pin;
+    spi_hw_t        hw;
+    uint64_t        dma_next_ns;    // Próximo byte puxado pelo DREQ de TX (UINT64_MAX = parado)
+    uint64_t        cs_t0;          // Descida do CS
+    // Fios SCK/MOSI/MISO do escravo, para mestres que geram os bits nos pinos (PIO)
+    bool            wired;
+    int             miso_pin, mosi_pin;
+    uint8_t         pin_bits;       // Bits do byte em curso
+    uint8_t         pin_mosi;
+    uint8_t         pin_miso;       // Byte que o escravo desloca no MISO
+};
+
+struct i2c_inst {
+    uint            baud;
+    i2c_hw_t        hw;
+    uint64_t        dma_next_ns;    // Fim do próximo byte puxado pelo DREQ de TX (UINT64_MAX = parado)
+    uint8_t         dma_msg[SIM_PICO_I2C_MSG_MAX]; // Transação em curso pelo DMA, até o STOP
+    size_t          dma_len;
+    struct {
+        uint8_t           addr;
+        sim_i2c_msg_dev_t dev;
+    } devs[SIM_PICO_MAX_I2C_DEVS];
+    int             ndevs;
+};
+
+spi_inst_t sim_spi0, sim_spi1;
+i2c_inst_t sim_i2c0, sim_i2c1;
+
+typedef struct {
+    uint8_t  func;
+    bool     out_en;
+    bool     out;
+    bool     pull_up;
+    bool     pull_down;
+    bool     ext;               // Um dispositivo (ou pull-up do módulo) impõe o nível
+    bool     ext_level;
+    bool     level;             // Nível atual no pino
+    uint32_t irq_mask;
+    uint32_t irq_pending;       // Bordas que chegaram com as IRQs desligadas
+    spi_inst_t *spi_cs;         // Pino é o CS deste controlador
+    spi_inst_t *spi_rst;        // Pino é o RESET do dispositivo deste controlador
+    spi_inst_t *spi_sck;        // Pino é o SCK do escravo deste controlador
+} pin_t;
+
+struct alarm_pool {
+    uint8_t core;               // Núcleo que recebe a IRQ do alarme
+};
+
+static pin_t               pins[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t irq_callback;
+
+static uint64_t            now_ns;
+static uint64_t            run_ns;
+static bool                in_advance;
+static sim_source_t        sources[SIM_PICO_MAX_SOURCES];
+static int                 nsources;
+static repeating_timer_t  *timers;          // Lista dos timers ativos
+static alarm_pool_t        alarm_pools[3];  // Os 4 alarmes do timer menos o do pool padrão
+static int                 nalarm_pools;
+static sim_pico_stats_t    stats;
+
+// Espera em que o núcleo está parado
+enum { CORE_RUN, CORE_SLEEP, CORE_SPIN, CORE_WFE, CORE_WFI };
+
+#define SIO_FIFO_DEPTH 8
+
+typedef struct {
+    bool     running;           // core1: lançado e ainda não retornou (core0: sempre)
+    bool     event_reg;         // Registrador de evento do WFE/SEV
+    bool     irqs_off;          // save_and_disable_interrupts() em curso
+    uint64_t irq_count;
+    int      wait;
+    uint64_t wake_ns;           // CORE_SLEEP/CORE_SPIN: fim da espera
+    uint64_t wait_irqs;         // CORE_WFI: irq_count ao dormir
+    uint64_t wait_t0;
+    uint32_t fifo[SIO_FIFO_DEPTH]; // FIFO do SIO que este núcleo lê
+    int      fifo_head;
+    int      fifo_count;
+} core_t;
+
+static core_t              cores[2];
+static int                 cur_core;        // Núcleo cujo código (ou IRQ) está executando
+static int                 baton;           // Núcleo cuja thread tem a vez
+static int                 gpio_irq_core;   // Núcleo que registrou o callback de GPIO
+static bool                multicore;
+static void              (*core1_entry)(void);
+static pthread_t           core1_thread;
+static pthread_mutex_t     core_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t      core_cv = PTHREAD_COND_INITIALIZER;
+
+// Canais de DMA e IRQs de periféricos (NVIC)
+typedef struct {
+    bool                claimed;
+    bool                busy;
+    dma_channel_config  cfg;
+    volatile void      *write_addr;
+    const volatile void *read_addr;
+    uint32_t            count;      // Contagem carregada (recarregada a cada disparo)
+    uint32_t            left;
+} dma_chan_t;
+
+static dma_chan_t          dma_ch[NUM_DMA_CHANNELS];
+static uint32_t            dma_inte[2], dma_ints[2];
+static irq_handler_t       irq_handlers[NUM_IRQS];
+static bool                irq_on[NUM_IRQS];
+static int                 irq_core[NUM_IRQS];      // Núcleo que habilitou a IRQ
+static uint32_t            irq_pending;             // IRQs retidas por seção crítica
+
+// Blocos PIO: memória de instruções, máquinas de estados e o que impõem nos pinos
+#define PIO_FIFO_MAX 8          // FIFO unido (JOIN_TX/JOIN_RX)
+
+typedef struct {
+    bool          claimed;
+    bool          enabled;
+    bool          stalled;      // Instrução atual esperando FIFO ou pino
+    bool          jumped;       // A instrução atual escreveu o PC
+    pio_sm_config cfg;
+    uint8_t       pc;
+    uint32_t      x, y, isr, osr;
+    uint8_t       isr_count, osr_count;
+    uint32_t      txf[PIO_FIFO_MAX], rxf[PIO_FIFO_MAX];
+    uint8_t       tx_head, tx_count, rx_head, rx_count;
+    uint64_t      cycle_ps;     // Período do relógio da máquina (clk_sys / clkdiv)
+    uint64_t      next_ps;      // Próximo ciclo (parada: o da tentativa que parou)
+} pio_sm_t;
+
+typedef struct {
+    uint16_t      instr[PIO_INSTRUCTION_COUNT];
+    uint32_t      used;         // Posições ocupadas da memória de instruções
+    uint32_t      out, oe;      // Níveis e direções impostos nos pinos
+    pio_sm_t      sm[NUM_PIO_STATE_MACHINES];
+} pio_block_t;
+
+pio_hw_t sim_pio0, sim_pio1;
+static pio_block_t         pio_blk[NUM_PIOS];
+
+// ============================================
+// === Relógio e eventos ===
+// ============================================
+
+uint64_t sim_time_ns(void) {
+    return now_ns;
+}
+
+static void account_wait(int c) {
+    core_t *k = &cores[c];
+
+    if (k->wait == CORE_SLEEP) stats.sleep_ns[c] += now_ns - k->wait_t0;
+    if (k->wait == CORE_WFE || k->wait == CORE_WFI) stats.wfe_ns[c] += now_ns - k->wait_t0;
+    k->wait_t0 = now_ns;
+}
+
+static void check_end(void) {
+    if (run_ns && now_ns >= run_ns) {
+        // Termina com os núcleos parados: conta o trecho da espera em curso
+        for (int c = 0; c < 2; c++) account_wait(c);
+        fflush(stdout);
+        exit(0);
+    }
+}
+
+// Uma IRQ atendida acorda o __wfe()/__wfi() do núcleo dela
+static void irq_taken(int core) {
+    cores[core].event_reg = true;
+    cores[core].irq_count++;
+}
+
+static uint64_t pio_next_ns(void);
+static void pio_poll(void);
+
+static uint64_t next_event_ns(void) {
+    uint64_t next = UINT64_MAX;
+
+    for (int i = 0; i < nsources; i++) {
+        uint64_t t = sources[i].next_ns(sources[i].ctx);
+        if (t < next) next = t;
+    }
+    for (repeating_timer_t *t = timers; t; t = t->sim_next)
+        if (t->next_ns < next) next = t->next_ns;
+    if (sim_spi0.dma_next_ns < next) next = sim_spi0.dma_next_ns;
+    if (sim_spi1.dma_next_ns < next) next = sim_spi1.dma_next_ns;
+    if (sim_i2c0.dma_next_ns < next) next = sim_i2c0.dma_next_ns;
+    if (sim_i2c1.dma_next_ns < next) next = sim_i2c1.dma_next_ns;
+    if (pio_next_ns() < next) next = pio_next_ns();
+    if (run_ns && run_ns < next) next = run_ns;
+    return next;
+}
+
+static void dma_poll(void);
+
+static void poll_timers(void) {
+    repeating_timer_t *t = timers, *next;
+
+    for (; t; t = next) {
+        int prev = cur_core;
+        uint64_t t0;
+        bool again;
+
+        next = t->sim_next;             // O callback pode cancelar o próprio timer
+        if (now_ns < t->next_ns) continue;
+        if (cores[t->sim_core].irqs_off) continue; // Dispara em restore_interrupts()
+        stats.timer_irqs++;
+        irq_taken(t->sim_core);
+        cur_core = t->sim_core;
+        t0 = now_ns;
+        again = t->callback(t);
+        stats.irq_ns[t->sim_core] += now_ns - t0;
+        cur_core = prev;
+        if (again) {
+            uint64_t period = (uint64_t)(t->delay_us < 0 ? -t->delay_us : t->delay_us) * 1000;
+            t->next_ns += period;
+            if (t->next_ns <= now_ns) t->next_ns = now_ns + period;
+        } else {
+            cancel_repeating_timer(t);
+        }
+    }
+}
+
+static void poll_sources(void) {
+    for (int i = 0; i < nsources; i++) sources[i].poll(sources[i].ctx);
+    dma_poll();
+    pio_poll();
+    poll_timers();
+}
+
+void sim_pico_advance_ns(uint64_t ns) {
+    uint64_t target = now_ns + ns;
+
+    // Callback de IRQ chamando o SPI: só acrescenta o tempo
+    if (in_advance) {
+        now_ns = target;
+        return;
+    }
+    in_advance = true;
+    for (;;) {
+        uint64_t next = next_event_ns();
+
+        if (target < next) next = target;
+        if (next > now_ns) now_ns = next;
+        poll_sources();
+        check_end();
+        if (now_ns >= target) break;
+    }
+    in_advance = false;
+}
+
+// ============================================
+// === Núcleos ===
+// ============================================
+//
+// Cada núcleo lançado roda numa thread do host, mas só uma executa por vez:
+// a vez passa nos pontos de espera (sleep, WFE/WFI, FIFO). Quando nenhum
+// núcleo pode seguir, o tempo avança até o próximo evento. As IRQs rodam no
+// instante em que ocorrem, seja qual for a thread que avançou o tempo.
+
+static bool core_ready(const core_t *k) {
+    switch (k->wait) {
+    case CORE_SLEEP:
+    case CORE_SPIN: return now_ns >= k->wake_ns;
+    case CORE_WFE:  return k->event_reg;
+    case CORE_WFI:  return k->irq_count != k->wait_irqs;
+    default:        return true;
+    }
+}
+
+// Passa a vez para o outro núcleo e espera que ela volte
+static void switch_to(int core) {
+    int me = baton;
+
+    baton = core;
+    pthread_cond_broadcast(&core_cv);
+    while (baton != me) pthread_cond_wait(&core_cv, &core_lock);
+    cur_core = me;
+}
+
+// Para o núcleo atual até a condição da espera
+static void core_block(int wait, uint64_t wake_ns) {
+    int me = cur_core, other = me ^ 1;
+    core_t *k = &cores[me];
+
+    k->wait = wait;
+    k->wake_ns = wake_ns;
+    k->wait_irqs = k->irq_count;
+    k->wait_t0 = now_ns;
+    while (!core_ready(k)) {
+        uint64_t next;
+
+        if (cores[other].running && core_ready(&cores[other])) {
+            switch_to(other);
+            continue;
+        }
+        next = next_event_ns();
+        for (int c = 0; c < 2; c++) {
+            const core_t *o = &cores[c];
+            if (o->running && (o->wait == CORE_SLEEP || o->wait == CORE_SPIN) && o->wake_ns < next)
+                next = o->wake_ns;
+        }
+        if (next == UINT64_MAX) {
+            fprintf(stderr, "pico_sim: CPU dormindo sem nenhum evento agendado\n");
+            exit(1);
+        }
+        sim_pico_advance_ns(next > now_ns ? next - now_ns : 0);
+    }
+    account_wait(me);
+    if (wait == CORE_WFE || wait == CORE_WFI) k->event_reg = false;
+    if (wait != CORE_SPIN) stats.wakeups[me]++;
+    k->wait = CORE_RUN;
+}
+
+static void *core1_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&core_lock);
+    while (baton != 1) pthread_cond_wait(&core_cv, &core_lock);
+    cur_core = 1;
+    core1_entry();
+
+    // A função do core1 retornou: ele para e devolve a vez de vez
+    cores[1].running = false;
+    baton = 0;
+    pthread_cond_broadcast(&core_cv);
+    pthread_mutex_unlock(&core_lock);
+    return NULL;
+}
+
+// Tempo de barramento: avança sem aplicar eventos (o modelo se atualiza a cada byte)
+static inline void bus_time(uint64_t ns) {
+    now_ns += ns;
+}
+
+void sim_pico_set_run_ns(uint64_t ns) {
+    run_ns = ns;
+}
+
+// ============================================
+// === pico_time / pico_stdlib ===
+// ============================================
+
+absolute_time_t get_absolute_time(void) {
+    return now_ns / 1000;
+}
+
+void sleep_us(uint64_t us) {
+    core_block(CORE_SLEEP, now_ns + us * 1000);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000);
+}
+
+void tight_loop_contents(void) {
+    core_block(CORE_SPIN, now_ns + 1000);
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+    uint64_t period = (uint64_t)(delay_us < 0 ? -delay_us : delay_us) * 1000;
+
+    if (!period) return false;
+    out->delay_us = delay_us;
+    out->callback = callback;
+    out->user_data = user_data;
+    out->next_ns = now_ns + period;
+    out->sim_core = (uint8_t)cur_core; // O alarme é do núcleo que criou o timer
+    // A struct vem sem inicializar (como no SDK): a lista é quem diz se está ativa
+    cancel_repeating_timer(out);
+    out->sim_next = timers;
+    timers = out;
+    out->active = true;
+    return true;
+}
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers) {
+    (void)max_timers;
+    if (nalarm_pools == (int)(sizeof(alarm_pools) / sizeof(alarm_pools[0]))) return NULL;
+    alarm_pools[nalarm_pools].core = (uint8_t)cur_core;
+    return &alarm_pools[nalarm_pools++];
+}
+
+bool alarm_pool_add_repeating_timer_us(alarm_pool_t *pool, int64_t delay_us, repeating_timer_callback_t callback,
+                                       void *user_data, repeating_timer_t *out) {
+    if (!add_repeating_timer_us(delay_us, callback, user_data, out)) return false;
+    out->sim_core = pool->core;
+    return true;
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    for (repeating_timer_t **p = &timers; *p; p = &(*p)->sim_next) {
+        if (*p == timer) {
+            *p = timer->sim_next;
+            timer->active = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================
+// === hardware_sync ===
+// ============================================
+
+void __wfe(void) {
+    core_block(CORE_WFE, 0);
+}
+
+void __wfi(void) {
+    core_block(CORE_WFI, 0);
+}
+
+// O SEV chega aos dois núcleos
+void __sev(void) {
+    cores[0].event_reg = true;
+    cores[1].event_reg = true;
+}
+
+static void dispatch_pending_irqs(void);
+
+uint32_t save_and_disable_interrupts(void) {
+    uint32_t was_off = cores[cur_core].irqs_off;
+
+    cores[cur_core].irqs_off = true;
+    return was_off;
+}
+
+void restore_interrupts(uint32_t status) {
+    if (status) return;
+    cores[cur_core].irqs_off = false;
+    dispatch_pending_irqs();
+    poll_timers();
+}
+
+// ============================================
+// === pico_multicore ===
+// ============================================
+
+void multicore_launch_core1(void (*entry)(void)) {
+    if (cores[1].running) return;
+    if (!multicore) {
+        pthread_mutex_lock(&core_lock); // A thread do core0 passa a disputar a vez
+        multicore = true;
+    }
+    memset(&cores[1], 0, sizeof(cores[1]));
+    cores[1].running = true;
+    stats.core1_launch_ns = now_ns;
+    core1_entry = entry;
+    if (pthread_create(&core1_thread, NULL, core1_main, NULL) != 0) {
+        fprintf(stderr, "pico_sim: não foi possível criar a thread do core1\n");
+        exit(1);
+    }
+    pthread_detach(core1_thread);
+}
+
+bool multicore_fifo_rvalid(void) {
+    return cores[cur_core].fifo_count > 0;
+}
+
+bool multicore_fifo_wready(void) {
+    return cores[cur_core ^ 1].fifo_count < SIO_FIFO_DEPTH;
+}
+
+void multicore_fifo_push_blocking(uint32_t data) {
+    core_t *to;
+
+    while (!multicore_fifo_wready()) __wfe();
+    to = &cores[cur_core ^ 1];
+    to->fifo[(to->fifo_head + to->fifo_count) % SIO_FIFO_DEPTH] = data;
+    to->fifo_count++;
+    __sev();
+}
+
+uint32_t multicore_fifo_pop_blocking(void) {
+    core_t *k = &cores[cur_core];
+    uint32_t data;
+
+    while (!multicore_fifo_rvalid()) __wfe();
+    data = k->fifo[k->fifo_head];
+    k->fifo_head = (k->fifo_head + 1) % SIO_FIFO_DEPTH;
+    k->fifo_count--;
+    __sev();
+    return data;
+}
+
+void multicore_fifo_drain(void) {
+    cores[cur_core].fifo_count = 0;
+}
+
+uint get_core_num(void) {
+    return (uint)cur_core;
+}
+
+void sim_pico_hard_assert(const char *cond, const char *file, int line) {
+    fprintf(stderr, "pico_sim: hard_assert(%s) falhou em %s:%d (core%d)\n", cond, file, line, cur_core);
+    abort();
+}
+
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+// ============================================
+// === GPIO ===
+// ============================================
+
+static bool pin_level(const pin_t *p) {
+    uint gpio = (uint)(p - pins);
+
+    if (p->func == GPIO_FUNC_SIO && p->out_en) return p->out;
+    if (p->func == GPIO_FUNC_PIO0 || p->func == GPIO_FUNC_PIO1) {
+        const pio_block_t *b = &pio_blk[p->func - GPIO_FUNC_PIO0];
+        if (b->oe & (1u << gpio)) return (b->out >> gpio) & 1u;
+    }
+    if (p->ext) return p->ext_level;
+    return p->pull_up ? true : false;
+}
+
+static void spi_pins_select(spi_inst_t *spi, bool active);
+static void spi_pins_clock(spi_inst_t *spi, bool level);
+static void pio_pins_changed(void);
+
+static void pin_update(uint gpio) {
+    pin_t *p = &pins[gpio];
+    bool level = pin_level(p);
+    uint32_t event;
+
+    if (level == p->level) return;
+    p->level = level;
+
+    if (p->spi_cs) {
+        spi_inst_t *s = p->spi_cs;
+        if (!level) s->cs_t0 = now_ns;
+        else if (s->selected) stats.spi_cs_ns += now_ns - s->cs_t0;
+        s->selected = !level;
+        if (s->dev.select) s->dev.select(s->dev.ctx, !level);
+        spi_pins_select(s, !level);
+    }
+    if (p->spi_rst && p->spi_rst->dev.reset) p->spi_rst->dev.reset(p->spi_rst->dev.ctx, !level);
+    if (p->spi_sck) spi_pins_clock(p->spi_sck, level);
+    pio_pins_changed();
+
+    event = level ? (GPIO_IRQ_EDGE_RISE | GPIO_IRQ_LEVEL_HIGH) : (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_LEVEL_LOW);
+    if (!(p->irq_mask & event) || !irq_callback) return;
+    p->irq_pending |= p->irq_mask & event;
+    if (!cores[gpio_irq_core].irqs_off) dispatch_pending_irqs();
+}
+
+// IRQ de periférico (DMA...): roda o handler no núcleo que a habilitou
+static void raise_irq(uint num) {
+    int prev = cur_core;
+    uint64_t t0;
+
+    if (!irq_on[num] || !irq_handlers[num]) return;
+    if (cores[irq_core[num]].irqs_off) {
+        irq_pending |= 1u << num;
+        return;
+    }
+    if (num == DMA_IRQ_0 || num == DMA_IRQ_1) stats.dma_irqs++;
+    irq_taken(irq_core[num]);
+    cur_core = irq_core[num];
+    t0 = now_ns;
+    irq_handlers[num]();
+    stats.irq_ns[cur_core] += now_ns - t0;
+    cur_core = prev;
+}
+
+// Atende as bordas pendentes no núcleo dono do callback; as que chegaram numa
+// seção crítica dele esperam o restore_interrupts()
+static void dispatch_pending_irqs(void) {
+    int prev = cur_core;
+
+    for (uint num = 0; num < NUM_IRQS; num++) {
+        if (!(irq_pending & (1u << num)) || cores[irq_core[num]].irqs_off) continue;
+        irq_pending &= ~(1u << num);
+        raise_irq(num);
+    }
+    if (!irq_callback || cores[gpio_irq_core].irqs_off) return;
+    cur_core = gpio_irq_core;
+    uint64_t t0;
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++) {
+        uint32_t events = pins[gpio].irq_pending;
+
+        if (!events) continue;
+        pins[gpio].irq_pending = 0;
+        stats.gpio_irqs++;
+        irq_taken(gpio_irq_core);
+        t0 = now_ns;
+        irq_callback(gpio, events);
+        stats.irq_ns[gpio_irq_core] += now_ns - t0;
+    }
+    cur_core = prev;
+}
+
+void gpio_init(uint gpio) {
+    pins[gpio].out_en = false;
+    pins[gpio].out = false;
+    pins[gpio].func = GPIO_FUNC_SIO;
+    pin_update(gpio);
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    pins[gpio].func = (uint8_t)fn;
+    pin_update(gpio);
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    pins[gpio].out_en = out;
+    pin_update(gpio);
+}
+
+void gpio_put(uint gpio, bool value) {
+    pins[gpio].out = value;
+    pin_update(gpio);
+}
+
+bool gpio_get(uint gpio) {
+    return pins[gpio].level;
+}
+
+void gpio_set_pulls(uint gpio, bool up, bool down) {
+    pins[gpio].pull_up = up;
+    pins[gpio].pull_down = down;
+    pin_update(gpio);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (enabled) pins[gpio].irq_mask |= event_mask;
+    else         pins[gpio].irq_mask &= ~event_mask;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled,
+                                        gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    if (enabled) {
+        irq_callback = callback;
+        gpio_irq_core = cur_core; // IO_IRQ_BANK0 habilitada neste núcleo
+    }
+}
+
+void sim_pico_gpio_drive(unsigned pin, bool level) {
+    pins[pin].ext = true;
+    pins[pin].ext_level = level;
+    pin_update(pin);
+}
+
+// ============================================
+// === hardware_spi ===
+// ============================================
+
+// Mesma busca de prescaler/postdiv do SDK: a maior taxa <= a pedida
+uint spi_set_baudrate(spi_inst_t *spi, uint baudrate) {
+    uint32_t freq_in = SIM_PICO_CLK_PERI_HZ;
+    uint prescale, postdiv;
+
+    for (prescale = 2; prescale <= 254; prescale += 2)
+        if (freq_in < (prescale + 2) * 256 * (uint64_t)baudrate) break;
+    for (postdiv = 256; postdiv > 1; --postdiv)
+        if (freq_in / (prescale * (postdiv - 1)) > baudrate) break;
+
+    spi->baud = freq_in / (prescale * postdiv);
+    return spi->baud;
+}
+
+uint spi_init(spi_inst_t *spi, uint baudrate) {
+    return spi_set_baudrate(spi, baudrate);
+}
+
+void spi_deinit(spi_inst_t *spi) {
+    spi->baud = 0;
+}
+
+uint spi_get_baudrate(const spi_inst_t *spi) {
+    return spi->baud;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order) {
+    (void)spi; (void)data_bits; (void)cpol; (void)cpha; (void)order; // Modelos: modo 0, 8 bits
+}
+
+static uint8_t spi_byte(spi_inst_t *spi, uint8_t mosi) {
+    uint64_t byte_ns = spi->baud ? 8000000000ull / spi->baud : 0;
+
+    bus_time(byte_ns);
+    stats.spi_bytes++;
+    stats.spi_ns += byte_ns;
+    if (!spi->attached || !spi->selected) return 0xFF;
+    return spi->dev.xfer(spi->dev.ctx, mosi);
+}
+
+int spi_write_read_blocking(spi_inst_t *spi, const uint8_t *src, uint8_t *dst, size_t len) {
+    stats.spi_calls++;
+    for (size_t i = 0; i < len; i++) dst[i] = spi_byte(spi, src[i]);
+    sim_pico_advance_ns(0);
+    return (int)len;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+    stats.spi_calls++;
+    for (size_t i = 0; i < len; i++) spi_byte(spi, src[i]);
+    sim_pico_advance_ns(0);
+    return (int)len;
+}
+
+int spi_read_blocking(spi_inst_t *spi, uint8_t repeated_tx_data, uint8_t *dst, size_t len) {
+    stats.spi_calls++;
+    for (size_t i = 0; i < len; i++) dst[i] = spi_byte(spi, repeated_tx_data);
+    sim_pico_advance_ns(0);
+    return (int)len;
+}
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi) {
+    return &spi->hw;
+}
+
+// Escravo pelos pinos (modo 0, MSB primeiro): o MISO de cada byte vem do
+// peek() no início do byte e muda na descida do SCK; o xfer() roda na 8ª subida
+static void spi_pins_miso(spi_inst_t *spi, bool drive) {
+    pin_t *p = &pins[spi->miso_pin];
+
+    p->ext = drive;             // Com CS inativo o rádio solta o MISO
+    p->ext_level = (spi->pin_miso >> (7 - spi->pin_bits)) & 1u;
+    pin_update((uint)spi->miso_pin);
+}
+
+static void spi_pins_select(spi_inst_t *spi, bool active) {
+    if (!spi->wired) return;
+    spi->pin_bits = 0;
+    spi->pin_mosi = 0;
+    spi->pin_miso = active && spi->attached && spi->dev.peek ? spi->dev.peek(spi->dev.ctx) : 0;
+    spi_pins_miso(spi, active);
+}
+
+static void spi_pins_clock(spi_inst_t *spi, bool level) {
+    if (!spi->selected) return;
+    if (!level) {
+        spi_pins_miso(spi, true);
+        return;
+    }
+    spi->pin_mosi = (uint8_t)(spi->pin_mosi << 1 | pins[spi->mosi_pin].level);
+    if (++spi->pin_bits < 8) return;
+
+    stats.spi_pin_bytes++;
+    if (spi->attached) spi->dev.xfer(spi->dev.ctx, spi->pin_mosi);
+    spi->pin_bits = 0;
+    spi->pin_mosi = 0;
+    spi->pin_miso = spi->attached && spi->dev.peek ? spi->dev.peek(spi->dev.ctx) : 0;
+}
+
+// ============================================
+// === hardware_irq ===
+// ============================================
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num < NUM_IRQS) irq_handlers[num] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num >= NUM_IRQS) return;
+    irq_on[num] = enabled;
+    irq_core[num] = cur_core;
+    // Nível já ativo ao habilitar
+    if (enabled && (num == DMA_IRQ_0 || num == DMA_IRQ_1) &&
+        (dma_ints[num - DMA_IRQ_0] & dma_inte[num - DMA_IRQ_0]))
+        raise_irq(num);
+}
+
+// ============================================
+// === hardware_dma ===
+// ============================================
+//
+// Canais com DREQ de SPI andam no ritmo do barramento: cada byte que o SPI
+// desloca lê um item do canal de TX ativo e entrega o MISO ao canal de RX
+// ativo, se houver. Com DREQ de TX do I2C cada item é uma palavra de DATA_CMD
+// entregue no fim do seu byte; o STOP fecha a transação. Com DREQ da PIO o canal enche o FIFO de TX (ou esvazia o
+// de RX) assim que há espaço (ou dado). DREQ_FORCE copia memória na hora. Ao zerar a contagem o
+// canal dispara o encadeado e sinaliza DMA_IRQ_0/1 conforme a máscara.
+
+static void dma_trigger(uint ch);
+static void pio_dma_service(void);
+static void i2c_dma_start(uint dreq);
+static void i2c_dma_step(i2c_inst_t *i2c);
+
+static spi_inst_t *dma_spi(uint dreq, bool *is_tx) {
+    if (dreq < DREQ_SPI0_TX || dreq > DREQ_SPI1_RX) return NULL;
+    *is_tx = ((dreq - DREQ_SPI0_TX) & 1) == 0;
+    return dreq <= DREQ_SPI0_RX ? &sim_spi0 : &sim_spi1;
+}
+
+static dma_chan_t *dma_busy_on(uint dreq) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+        if (dma_ch[ch].busy && dma_ch[ch].cfg.dreq == dreq) return &dma_ch[ch];
+    return NULL;
+}
+
+static uint32_t dma_read_item(dma_chan_t *c) {
+    const volatile uint8_t *p = c->read_addr;
+    uint32_t v = c->cfg.size == DMA_SIZE_32 ? *(const volatile uint32_t *)p :
+                 c->cfg.size == DMA_SIZE_16 ? *(const volatile uint16_t *)p : *p;
+
+    if (c->cfg.read_incr) c->read_addr = p + (1u << c->cfg.size);
+    return v;
+}
+
+static void dma_write_item(dma_chan_t *c, uint32_t v) {
+    volatile uint8_t *p = c->write_addr;
+
+    if (c->cfg.size == DMA_SIZE_32)      *(volatile uint32_t *)p = v;
+    else if (c->cfg.size == DMA_SIZE_16) *(volatile uint16_t *)p = (uint16_t)v;
+    else                                 *p = (uint8_t)v;
+    if (c->cfg.write_incr) c->write_addr = p + (1u << c->cfg.size);
+}
+
+static void dma_finish(uint ch) {
+    dma_chan_t *c = &dma_ch[ch];
+
+    c->busy = false;
+    if (c->cfg.chain_to != ch) dma_trigger(c->cfg.chain_to);
+    for (int n = 0; n < 2; n++) {
+        if (!(dma_inte[n] & (1u << ch))) continue;
+        dma_ints[n] |= 1u << ch;
+        raise_irq(DMA_IRQ_0 + n);
+    }
+}
+
+// Um item conta contra o canal; zerou, termina
+static void dma_count(dma_chan_t *c) {
+    if (--c->left == 0) dma_finish((uint)(c - dma_ch));
+}
+
+static void dma_trigger(uint ch) {
+    dma_chan_t *c = &dma_ch[ch];
+    spi_inst_t *spi;
+    bool is_tx;
+
+    c->left = c->count;
+    c->busy = true;
+    stats.dma_transfers++;
+    if (!c->left) {
+        dma_finish(ch);
+        return;
+    }
+    if (c->cfg.dreq == DREQ_FORCE) {
+        while (c->busy) {
+            dma_write_item(c, dma_read_item(c));
+            stats.dma_bytes += 1u << c->cfg.size;
+            dma_count(c);
+        }
+        return;
+    }
+    if (c->cfg.dreq < DREQ_SPI0_TX) {
+        pio_dma_service();
+        return;
+    }
+    if (c->cfg.dreq == DREQ_I2C0_TX || c->cfg.dreq == DREQ_I2C1_TX) {
+        i2c_dma_start(c->cfg.dreq);
+        return;
+    }
+    spi = dma_spi(c->cfg.dreq, &is_tx);
+    if (spi && is_tx && spi->dma_next_ns == UINT64_MAX) {
+        spi->dma_next_ns = now_ns + (spi->baud ? 8000000000ull / spi->baud : 0);
+    }
+}
+
+// Um byte do SPI puxado pelo DMA
+static void spi_dma_step(spi_inst_t *spi) {
+    uint dreq_tx = spi == &sim_spi1 ? DREQ_SPI1_TX : DREQ_SPI0_TX;
+    dma_chan_t *tx = dma_busy_on(dreq_tx), *rx = dma_busy_on(dreq_tx + 1);
+    uint64_t byte_ns = spi->baud ? 8000000000ull / spi->baud : 0;
+    uint8_t mosi, miso;
+
+    if (!tx) {
+        spi->dma_next_ns = UINT64_MAX;
+        return;
+    }
+    mosi = (uint8_t)dma_read_item(tx);
+    miso = spi->attached && spi->selected ? spi->dev.xfer(spi->dev.ctx, mosi) : 0xFF;
+    stats.spi_bytes++;
+    stats.spi_ns += byte_ns;
+    stats.dma_bytes++;
+    if (rx) {
+        dma_write_item(rx, miso);
+        dma_count(rx);
+    }
+    dma_count(tx);
+    spi->dma_next_ns = dma_busy_on(dreq_tx) ? now_ns + byte_ns : UINT64_MAX;
+}
+
+static void dma_poll(void) {
+    while (sim_spi0.dma_next_ns <= now_ns) spi_dma_step(&sim_spi0);
+    while (sim_spi1.dma_next_ns <= now_ns) spi_dma_step(&sim_spi1);
+    while (sim_i2c0.dma_next_ns <= now_ns) i2c_dma_step(&sim_i2c0);
+    while (sim_i2c1.dma_next_ns <= now_ns) i2c_dma_step(&sim_i2c1);
+}
+
+int dma_claim_unused_channel(bool required) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+        if (!dma_ch[ch].claimed) {
+            dma_ch[ch].claimed = true;
+            return (int)ch;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "pico_sim: nenhum canal de DMA livre\n");
+        exit(1);
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) {
+    dma_ch[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    return (dma_channel_config){ .size = DMA_SIZE_32, .read_incr = true, .write_incr = false,
+                                 .dreq = DREQ_FORCE, .chain_to = (uint8_t)channel };
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    dma_chan_t *c = &dma_ch[channel];
+
+    c->cfg = *config;
+    c->write_addr = write_addr;
+    c->read_addr = read_addr;
+    c->count = transfer_count;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger) {
+    dma_ch[channel].read_addr = read_addr;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger) {
+    dma_ch[channel].write_addr = write_addr;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+    dma_ch[channel].count = trans_count;
+    if (trigger) dma_trigger(channel);
+}
+
+void dma_start_channel_mask(uint32_t chan_mask) {
+    for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++)
+        if (chan_mask & (1u << ch)) dma_trigger(ch);
+}
+
+void dma_channel_abort(uint channel) {
+    dma_ch[channel].busy = false;
+    dma_ch[channel].left = 0;
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return dma_ch[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel) {
+    while (dma_ch[channel].busy) tight_loop_contents();
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled) {
+    if (enabled) dma_inte[0] |= 1u << channel;
+    else         dma_inte[0] &= ~(1u << channel);
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled) {
+    if (enabled) dma_inte[1] |= 1u << channel;
+    else         dma_inte[1] &= ~(1u << channel);
+}
+
+bool dma_channel_get_irq0_status(uint channel) {
+    return dma_ints[0] & (1u << channel);
+}
+
+bool dma_channel_get_irq1_status(uint channel) {
+    return dma_ints[1] & (1u << channel);
+}
+
+void dma_channel_acknowledge_irq0(uint channel) {
+    dma_ints[0] &= ~(1u << channel);
+}
+
+void dma_channel_acknowledge_irq1(uint channel) {
+    dma_ints[1] &= ~(1u << channel);
+}
+
+// ============================================
+// === hardware_pio ===
+// ============================================
+//
+// Cada máquina de estados habilitada executa uma instrução por ciclo do seu
+// relógio (mais os atrasos) como uma fonte de eventos. Parada num FIFO ou num
+// WAIT, ela sai da agenda até a CPU, o DMA ou um pino mudarem algo. As saídas
+// vão para os pinos com função PIO; o side-set vence OUT/SET no mesmo ciclo.
+
+static pio_block_t *pio_block(PIO pio) {
+    return &pio_blk[pio_get_index(pio)];
+}
+
+static uint fifo_depth(const pio_sm_t *s, bool tx) {
+    if (s->cfg.fifo_join == (tx ? PIO_FIFO_JOIN_TX : PIO_FIFO_JOIN_RX)) return PIO_FIFO_MAX;
+    return s->cfg.fifo_join ? 0 : PIO_FIFO_MAX / 2;
+}
+
+static inline uint32_t rotl32(uint32_t v, uint n) {
+    n &= 31;
+    return n ? (v << n) | (v >> (32 - n)) : v;
+}
+
+static inline uint32_t bits_mask(uint n) {
+    return n >= 32 ? ~0u : (1u << n) - 1;
+}
+
+static uint32_t gpio_levels(void) {
+    uint32_t v = 0;
+
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++)
+        if (pins[gpio].level) v |= 1u << gpio;
+    return v;
+}
+
+// Uma escrita nos níveis (ou direções) do bloco; atualiza os pinos que mudaram
+static void pio_drive(pio_block_t *b, uint32_t values, uint32_t mask, bool dirs) {
+    uint32_t *reg = dirs ? &b->oe : &b->out;
+    uint32_t changed = (*reg ^ values) & mask;
+
+    *reg = (*reg & ~mask) | (values & mask);
+    while (changed) {
+        uint gpio = (uint)__builtin_ctz(changed);
+        changed &= changed - 1;
+        if (gpio < NUM_BANK0_GPIOS) pin_update(gpio);
+    }
+}
+
+static void pio_drive_range(pio_block_t *b, uint base, uint count, uint32_t v, bool dirs) {
+    pio_drive(b, rotl32(v, base), rotl32(bits_mask(count), base), dirs);
+}
+
+// A CPU ou o DMA mexeu num FIFO: a máquina parada tenta de novo no próximo ciclo
+static void sm_wake(pio_sm_t *s) {
+    uint64_t now_ps = now_ns * 1000;
+
+    if (!s->enabled || !s->stalled) return;
+    s->stalled = false;
+    if (s->next_ps <= now_ps) s->next_ps += ((now_ps - s->next_ps) / s->cycle_ps + 1) * s->cycle_ps;
+}
+
+static void sm_tx_put(pio_sm_t *s, uint32_t v) {
+    s->txf[(s->tx_head + s->tx_count) % PIO_FIFO_MAX] = v;
+    s->tx_count++;
+    sm_wake(s);
+}
+
+static uint32_t sm_rx_get(pio_sm_t *s) {
+    uint32_t v = s->rxf[s->rx_head];
+
+    s->rx_head = (uint8_t)((s->rx_head + 1) % PIO_FIFO_MAX);
+    s->rx_count--;
+    sm_wake(s);
+    return v;
+}
+
+// OSR <- FIFO de TX
+static bool sm_pull(pio_sm_t *s) {
+    if (!s->tx_count) return false;
+    s->osr = s->txf[s->tx_head];
+    s->tx_head = (uint8_t)((s->tx_head + 1) % PIO_FIFO_MAX);
+    s->tx_count--;
+    s->osr_count = 0;
+    return true;
+}
+
+// ISR -> FIFO de RX
+static bool sm_push(pio_sm_t *s) {
+    if (s->rx_count >= fifo_depth(s, false)) return false;
+    s->rxf[(s->rx_head + s->rx_count) % PIO_FIFO_MAX] = s->isr;
+    s->rx_count++;
+    s->isr = 0;
+    s->isr_count = 0;
+    return true;
+}
+
+static uint32_t sm_shift_out(pio_sm_t *s, uint n) {
+    uint32_t v;
+
+    if (n >= 32)                     { v = s->osr; s->osr = 0; }
+    else if (s->cfg.out_shift_right) { v = s->osr & bits_mask(n); s->osr >>= n; }
+    else                             { v = s->osr >> (32 - n); s->osr <<= n; }
+    s->osr_count = (uint8_t)(s->osr_count + n > 32 ? 32 : s->osr_count + n);
+    return v;
+}
+
+static void sm_shift_in(pio_sm_t *s, uint32_t v, uint n) {
+    v &= bits_mask(n);
+    if (n >= 32)                    s->isr = v;
+    else if (s->cfg.in_shift_right) s->isr = (s->isr >> n) | (v << (32 - n));
+    else                            s->isr = (s->isr << n) | v;
+    s->isr_count = (uint8_t)(s->isr_count + n > 32 ? 32 : s->isr_count + n);
+}
+
+static uint32_t bit_reverse(uint32_t v) {
+    uint32_t r = 0;
+
+    for (int i = 0; i < 32; i++, v >>= 1) r = (r << 1) | (v & 1u);
+    return r;
+}
+
+// Executa uma instrução; false = parada (tenta de novo no próximo ciclo)
+static bool sm_exec(pio_block_t *b, pio_sm_t *s, uint16_t ins) {
+    uint op = ins >> 13, arg1 = (ins >> 5) & 7u, idx = ins & 0x1Fu;
+    uint n = idx ? idx : 32;
+    uint32_t v = 0;
+
+    s->jumped = false;
+    switch (op) {
+    case 0: // JMP
+        switch (arg1) {
+        case 0: v = 1; break;
+        case 1: v = !s->x; break;
+        case 2: v = s->x != 0; s->x--; break;
+        case 3: v = !s->y; break;
+        case 4: v = s->y != 0; s->y--; break;
+        case 5: v = s->x != s->y; break;
+        case 6: v = (gpio_levels() >> s->cfg.in_base) & 1u; break;    // Sem EXECCTRL_JMP_PIN: base do IN
+        default: v = s->osr_count < s->cfg.pull_thresh; break;       // !OSRE
+        }
+        if (v) {
+            s->pc = (uint8_t)idx;
+            s->jumped = true;
+        }
+        return true;
+    case 1: { // WAIT
+        bool polarity = (ins >> 7) & 1u;
+        switch ((ins >> 5) & 3u) {
+        case 0:  v = (gpio_levels() >> idx) & 1u; break;
+        case 1:  v = (gpio_levels() >> ((s->cfg.in_base + idx) & 31u)) & 1u; break;
+        default: return true;       // WAIT irq: não modelado
+        }
+        return v == polarity;
+    }
+    case 2: // IN
+        if (s->cfg.autopush && s->isr_count >= s->cfg.push_thresh && !sm_push(s)) return false;
+        switch (arg1) {
+        case 0:  v = rotl32(gpio_levels(), 32 - s->cfg.in_base); break;
+        case 1:  v = s->x; break;
+        case 2:  v = s->y; break;
+        case 6:  v = s->isr; break;
+        case 7:  v = s->osr; break;
+        default: v = 0; break;
+        }
+        sm_shift_in(s, v, n);
+        // RX cheio: o push fica pendente e a próxima IN espera
+        if (s->cfg.autopush && s->isr_count >= s->cfg.push_thresh) sm_push(s);
+        return true;
+    case 3: // OUT
+        if (s->cfg.autopull && s->osr_count >= s->cfg.pull_thresh && !sm_pull(s)) return false;
+        v = sm_shift_out(s, n);
+        switch (arg1) {
+        case 0: pio_drive_range(b, s->cfg.out_base, n < s->cfg.out_count ? n : s->cfg.out_count, v, false); break;
+        case 1: s->x = v; break;
+        case 2: s->y = v; break;
+        case 4: pio_drive_range(b, s->cfg.out_base, n < s->cfg.out_count ? n : s->cfg.out_count, v, true); break;
+        case 5: s->pc = (uint8_t)(v & 31u); s->jumped = true; break;
+        case 6: s->isr = v; s->isr_count = (uint8_t)n; break;
+        default: break;             // null; exec não modelado
+        }
+        return true;
+    case 4: { // PUSH / PULL
+        bool cond = (ins >> 6) & 1u, block = (ins >> 5) & 1u;
+        if (!(ins & 0x80u)) {
+            if (cond && s->isr_count < s->cfg.push_thresh) return true;
+            if (sm_push(s)) return true;
+            if (block) return false;
+            s->isr = 0;             // Sem block e RX cheio: descarta
+            s->isr_count = 0;
+            return true;
+        }
+        if (cond && s->osr_count < s->cfg.pull_thresh) return true;
+        if (sm_pull(s)) return true;
+        if (block) return false;
+        s->osr = s->x;              // Sem block e TX vazio: copia X
+        s->osr_count = 0;
+        return true;
+    }
+    case 5: // MOV
+        switch (idx & 7u) {
+        case 0:  v = rotl32(gpio_levels(), 32 - s->cfg.in_base); break;
+        case 1:  v = s->x; break;
+        case 2:  v = s->y; break;
+        case 6:  v = s->isr; break;
+        case 7:  v = s->osr; break;
+        default: v = 0; break;      // null; STATUS não modelado
+        }
+        if (((idx >> 3) & 3u) == 1) v = ~v;
+        if (((idx >> 3) & 3u) == 2) v = bit_reverse(v);
+        switch (arg1) {
+        case 0: pio_drive_range(b, s->cfg.out_base, s->cfg.out_count, v, false); break;
+        case 1: s->x = v; break;
+        case 2: s->y = v; break;
+        case 5: s->pc = (uint8_t)(v & 31u); s->jumped = true; break;
+        case 6: s->isr = v; s->isr_count = 0; break;
+        case 7: s->osr = v; s->osr_count = 0; break;
+        default: break;
+        }
+        return true;
+    case 6: // IRQ: não modelado
+        return true;
+    default: // SET
+        switch (arg1) {
+        case 0: pio_drive_range(b, s->cfg.set_base, s->cfg.set_count, idx, false); break;
+        case 1: s->x = idx; break;
+        case 2: s->y = idx; break;
+        case 4: pio_drive_range(b, s->cfg.set_base, s->cfg.set_count, idx, true); break;
+        default: break;
+        }
+        return true;
+    }
+}
+
+// Um ciclo da máquina: instrução, side-set (mesmo parada) e atraso
+static void sm_step(pio_block_t *b, pio_sm_t *s) {
+    uint16_t ins = b->instr[s->pc];
+    uint field = (ins >> 8) & 0x1Fu;
+    uint ss_bits = s->cfg.sideset_bits;
+    uint delay = field & bits_mask(5 - ss_bits);
+    bool done = sm_exec(b, s, ins);
+
+    stats.pio_cycles++;
+    if (ss_bits && (!s->cfg.sideset_opt || (field & 0x10u))) {
+        uint vbits = ss_bits - (s->cfg.sideset_opt ? 1u : 0u);
+        pio_drive_range(b, s->cfg.sideset_base, vbits, (field >> (5 - ss_bits)) & bits_mask(vbits),
+                        s->cfg.sideset_pindirs);
+    }
+    if (!done) {
+        s->stalled = true;
+        return;
+    }
+    if (!s->jumped) s->pc = s->pc == s->cfg.wrap ? s->cfg.wrap_target : (uint8_t)((s->pc + 1) & 31u);
+    // Autopull em segundo plano: o OSR vazio se recarrega assim que há dado
+    if (s->cfg.autopull && s->osr_count >= s->cfg.pull_thresh) sm_pull(s);
+    s->next_ps += (1 + delay) * s->cycle_ps;
+}
+
+static uint64_t pio_next_ns(void) {
+    uint64_t next = UINT64_MAX;
+
+    for (int i = 0; i < NUM_PIOS; i++) {
+        for (int j = 0; j < NUM_PIO_STATE_MACHINES; j++) {
+            const pio_sm_t *s = &pio_blk[i].sm[j];
+            uint64_t t = (s->next_ps + 999) / 1000;
+            if (s->enabled && !s->stalled && t < next) next = t;
+        }
+    }
+    return next;
+}
+
+// Executa, em ordem de tempo, os ciclos vencidos de todas as máquinas
+static void pio_poll(void) {
+    uint64_t now_ps = now_ns * 1000;
+
+    for (;;) {
+        pio_block_t *b = NULL;
+        pio_sm_t *due = NULL;
+
+        for (int i = 0; i < NUM_PIOS; i++) {
+            for (int j = 0; j < NUM_PIO_STATE_MACHINES; j++) {
+                pio_sm_t *s = &pio_blk[i].sm[j];
+                if (!s->enabled || s->stalled || s->next_ps > now_ps) continue;
+                if (!due || s->next_ps < due->next_ps) {
+                    due = s;
+                    b = &pio_blk[i];
+                }
+            }
+        }
+        if (!due) return;
+        sm_step(b, due);
+        pio_dma_service();
+    }
+}
+
+// Um pino mudou: as máquinas paradas num WAIT tentam de novo
+static void pio_pins_changed(void) {
+    for (int i = 0; i < NUM_PIOS; i++) {
+        for (int j = 0; j < NUM_PIO_STATE_MACHINES; j++) {
+            pio_sm_t *s = &pio_blk[i].sm[j];
+            if (s->stalled && (pio_blk[i].instr[s->pc] >> 13) == 1) sm_wake(s);
+        }
+    }
+}
+
+// Canais de DMA com DREQ da PIO: enchem o FIFO de TX e esvaziam o de RX
+static void pio_dma_service(void) {
+    static bool busy;           // dma_count() pode encadear um canal e voltar aqui
+    bool moved = true;
+
+    if (busy) return;
+    busy = true;
+    while (moved) {
+        moved = false;
+        for (uint i = 0; i < NUM_PIOS; i++) {
+            for (uint j = 0; j < NUM_PIO_STATE_MACHINES; j++) {
+                pio_sm_t *s = &pio_blk[i].sm[j];
+                uint dreq = (i ? DREQ_PIO1_TX0 : DREQ_PIO0_TX0) + j;
+                dma_chan_t *tx = dma_busy_on(dreq);
+                dma_chan_t *rx = dma_busy_on(dreq + NUM_PIO_STATE_MACHINES);
+
+                if (tx && s->tx_count < fifo_depth(s, true)) {
+                    uint32_t v = dma_read_item(tx);
+                    // Escrita estreita no FIFO: o byte (ou a meia palavra) se repete na palavra
+                    if (tx->cfg.size == DMA_SIZE_8)       v = (v & 0xFFu) * 0x01010101u;
+                    else if (tx->cfg.size == DMA_SIZE_16) v = (v & 0xFFFFu) * 0x00010001u;
+                    sm_tx_put(s, v);
+                    if (!rx) stats.dma_bytes += 1u << tx->cfg.size; // Com par TX/RX conta o RX, como no SPI
+                    dma_count(tx);
+                    moved = true;
+                }
+                if (rx && s->rx_count) {
+                    dma_write_item(rx, sm_rx_get(s));
+                    stats.dma_bytes += 1u << rx->cfg.size;
+                    dma_count(rx);
+                    moved = true;
+                }
+            }
+        }
+    }
+    busy = false;
+}
+
+// Espera ocupada da CPU por um FIFO: como no SPI bloqueante, só as máquinas
+// de estados andam; os eventos das fontes ficam para o fim da chamada
+static void pio_wait_step(void) {
+    uint64_t next = pio_next_ns();
+
+    if (next == UINT64_MAX) {
+        fprintf(stderr, "pico_sim: CPU esperando o FIFO de uma máquina de estados parada\n");
+        exit(1);
+    }
+    if (next > now_ns) now_ns = next;
+    pio_poll();
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program) {
+    pio_block_t *b = pio_block(pio);
+    uint32_t mask = bits_mask(program->length);
+    int offset = -1;
+
+    // Como o SDK: na origem fixa ou na posição livre mais alta
+    if (program->origin >= 0) {
+        if (!(b->used & (mask << program->origin))) offset = program->origin;
+    } else {
+        for (int o = PIO_INSTRUCTION_COUNT - program->length; o >= 0 && offset < 0; o--)
+            if (!(b->used & (mask << o))) offset = o;
+    }
+    if (offset < 0) {
+        fprintf(stderr, "pico_sim: sem espaço na memória de instruções da PIO\n");
+        exit(1);
+    }
+    for (uint i = 0; i < program->length; i++) {
+        uint16_t ins = program->instructions[i];
+        if ((ins >> 13) == 0) ins = (uint16_t)(ins + offset); // Destino do JMP é relativo ao programa
+        b->instr[offset + i] = ins;
+    }
+    b->used |= mask << offset;
+    return (uint)offset;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    pio_block_t *b = pio_block(pio);
+
+    for (int sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++) {
+        if (!b->sm[sm].claimed) {
+            b->sm[sm].claimed = true;
+            return sm;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "pico_sim: nenhuma máquina de estados livre na PIO%u\n", pio_get_index(pio));
+        exit(1);
+    }
+    return -1;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm) {
+    pio_block(pio)->sm[sm].claimed = false;
+}
+
+int pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config *config) {
+    pio_sm_t *s = &pio_block(pio)->sm[sm];
+
+    s->enabled = false;
+    s->stalled = false;
+    s->cfg = *config;
+    s->cycle_ps = (uint64_t)(1e12 / SIM_PICO_CLK_PERI_HZ * config->clkdiv + 0.5);
+    pio_sm_clear_fifos(pio, sm);
+    s->x = s->y = s->isr = s->osr = 0;
+    s->isr_count = 0;
+    s->osr_count = 32;          // OSR vazio
+    s->pc = (uint8_t)initial_pc;
+    return PICO_OK;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+    pio_sm_t *s = &pio_block(pio)->sm[sm];
+
+    if (enabled && !s->enabled) {
+        s->stalled = false;
+        s->next_ps = now_ns * 1000 + s->cycle_ps;
+    }
+    s->enabled = enabled;
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm) {
+    pio_sm_t *s = &pio_block(pio)->sm[sm];
+
+    s->tx_head = s->tx_count = 0;
+    s->rx_head = s->rx_count = 0;
+}
+
+void pio_gpio_init(PIO pio, uint pin) {
+    gpio_set_function(pin, pio_get_index(pio) ? GPIO_FUNC_PIO1 : GPIO_FUNC_PIO0);
+}
+
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values, uint32_t pin_mask) {
+    (void)sm;
+    pio_drive(pio_block(pio), pin_values, pin_mask, false);
+}
+
+void pio_sm_set_pindirs_with_mask(PIO pio, uint sm, uint32_t pin_dirs, uint32_t pin_mask) {
+    (void)sm;
+    pio_drive(pio_block(pio), pin_dirs, pin_mask, true);
+}
+
+int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) {
+    (void)sm;
+    pio_drive_range(pio_block(pio), pin_base, pin_count, is_out ? ~0u : 0u, true);
+    return PICO_OK;
+}
+
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm) {
+    const pio_sm_t *s = &pio_block(pio)->sm[sm];
+    return s->tx_count >= fifo_depth(s, true);
+}
+
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm) {
+    return pio_block(pio)->sm[sm].tx_count == 0;
+}
+
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm) {
+    return pio_block(pio)->sm[sm].rx_count == 0;
+}
+
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm) {
+    return pio_block(pio)->sm[sm].rx_count;
+}
+
+uint pio_sm_get_tx_fifo_level(PIO pio, uint sm) {
+    return pio_block(pio)->sm[sm].tx_count;
+}
+
+// FIFO cheio: a escrita se perde (TXOVER), como no hardware
+void pio_sm_put(PIO pio, uint sm, uint32_t data) {
+    if (!pio_sm_is_tx_fifo_full(pio, sm)) sm_tx_put(&pio_block(pio)->sm[sm], data);
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) {
+    bool waited = false;
+
+    while (pio_sm_is_tx_fifo_full(pio, sm)) {
+        pio_wait_step();
+        waited = true;
+    }
+    sm_tx_put(&pio_block(pio)->sm[sm], data);
+    if (waited) sim_pico_advance_ns(0);
+}
+
+// FIFO vazio: lê 0 (RXUNDER), como no hardware
+uint32_t pio_sm_get(PIO pio, uint sm) {
+    return pio_sm_is_rx_fifo_empty(pio, sm) ? 0 : sm_rx_get(&pio_block(pio)->sm[sm]);
+}
+
+uint32_t pio_sm_get_blocking(PIO pio, uint sm) {
+    bool waited = false;
+    uint32_t v;
+
+    while (pio_sm_is_rx_fifo_empty(pio, sm)) {
+        pio_wait_step();
+        waited = true;
+    }
+    v = sm_rx_get(&pio_block(pio)->sm[sm]);
+    if (waited) sim_pico_advance_ns(0);
+    return v;
+}
+
+// ============================================
+// === hardware_i2c ===
+// ============================================
+
+// Mesmo arredondamento do SDK para o período do SCL
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate) {
+    uint32_t freq_in = SIM_PICO_CLK_PERI_HZ;
+    uint32_t period = (freq_in + baudrate / 2) / baudrate;
+
+    i2c->baud = freq_in / period;
+    return i2c->baud;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+void i2c_deinit(i2c_inst_t *i2c) {
+    i2c->baud = 0;
+}
+
+// START + endereço + len bytes (9 bits cada, com ACK) + STOP
+static void i2c_time(i2c_inst_t *i2c, size_t len, bool nostop) {
+    uint64_t bits = 1 + 9 * (uint64_t)(len + 1) + (nostop ? 0 : 1);
+    uint64_t ns = i2c->baud ? bits * 1000000000ull / i2c->baud : 0;
+
+    bus_time(ns);
+    stats.i2c_ns += ns;
+    stats.i2c_transactions++;
+}
+
+static const sim_i2c_msg_dev_t *i2c_find(i2c_inst_t *i2c, uint8_t addr) {
+    for (int i = 0; i < i2c->ndevs; i++)
+        if (i2c->devs[i].addr == addr) return &i2c->devs[i].dev;
+    return NULL;
+}
+
+i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return &i2c->hw;
+}
+
+static uint64_t i2c_bits_ns(const i2c_inst_t *i2c, uint64_t bits) {
+    return i2c->baud ? bits * 1000000000ull / i2c->baud : 0;
+}
+
+// Bits até o fim do próximo byte: START + endereço antes do primeiro da transação
+static uint64_t i2c_dma_byte_ns(const i2c_inst_t *i2c) {
+    return i2c_bits_ns(i2c, i2c->dma_len ? 9 : 1 + 9 + 9);
+}
+
+static void i2c_dma_start(uint dreq) {
+    i2c_inst_t *i2c = dreq == DREQ_I2C1_TX ? &sim_i2c1 : &sim_i2c0;
+
+    if (i2c->dma_next_ns != UINT64_MAX) return;
+    i2c->hw.status |= I2C_IC_STATUS_ACTIVITY_BITS;
+    i2c->dma_next_ns = now_ns + i2c_dma_byte_ns(i2c);
+}
+
+// Transação montada pelo DMA: vai inteira ao dispositivo no STOP. Um NACK
+// aborta como no DW_apb_i2c: TX_ABRT_SOURCE diz a causa e o FIFO fica vazio
+// até a leitura de IC_CLR_TX_ABRT
+static void i2c_dma_deliver(i2c_inst_t *i2c) {
+    const sim_i2c_msg_dev_t *dev = i2c_find(i2c, (uint8_t)(i2c->hw.tar & 0x7F));
+    int n = dev ? dev->write(dev->ctx, i2c->dma_msg, i2c->dma_len) : 0;
+
+    stats.i2c_transactions++;
+    stats.i2c_bytes += (uint64_t)n;
+    stats.i2c_ns += i2c_bits_ns(i2c, 1 + 9 * (uint64_t)(i2c->dma_len + 1) + 1);
+    if ((size_t)n < i2c->dma_len) {
+        stats.i2c_nacks++;
+        i2c->hw.tx_abrt_source = n ? I2C_IC_TX_ABRT_SOURCE_ABRT_TXDATA_NOACK_BITS
+                                   : I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS;
+    }
+    i2c->dma_len = 0;
+}
+
+static uint32_t i2c_clr_tx_abrt(i2c_inst_t *i2c) {
+    i2c->hw.tx_abrt_source = 0;
+    return 0;
+}
+
+static uint32_t i2c0_clr_tx_abrt(void) { return i2c_clr_tx_abrt(&sim_i2c0); }
+static uint32_t i2c1_clr_tx_abrt(void) { return i2c_clr_tx_abrt(&sim_i2c1); }
+
+// Um byte do I2C puxado pelo DMA; o STOP acrescenta um bit antes do próximo START
+static void i2c_dma_step(i2c_inst_t *i2c) {
+    uint dreq = i2c == &sim_i2c1 ? DREQ_I2C1_TX : DREQ_I2C0_TX;
+    dma_chan_t *tx = dma_busy_on(dreq);
+    uint32_t cmd;
+    uint64_t gap = 0;
+
+    if (!tx) {
+        i2c->dma_next_ns = UINT64_MAX;
+        return;
+    }
+    cmd = dma_read_item(tx);
+    stats.dma_bytes += 1u << tx->cfg.size;
+    if (i2c->hw.tx_abrt_source) {
+        // FIFO em flush: a escrita do DMA some sem ir ao barramento
+        dma_count(tx);
+        i2c->dma_next_ns = dma_busy_on(dreq) ? now_ns : UINT64_MAX;
+        if (!dma_busy_on(dreq)) i2c->hw.status &= ~I2C_IC_STATUS_ACTIVITY_BITS;
+        return;
+    }
+    if (i2c->dma_len < sizeof(i2c->dma_msg)) i2c->dma_msg[i2c->dma_len++] = (uint8_t)cmd;
+    if (cmd & I2C_IC_DATA_CMD_STOP_BITS) {
+        i2c_dma_deliver(i2c);
+        gap = i2c_bits_ns(i2c, 1);
+    }
+    dma_count(tx);
+    if (dma_busy_on(dreq)) {
+        i2c->dma_next_ns = now_ns + gap + i2c_dma_byte_ns(i2c);
+    } else {
+        i2c->dma_next_ns = UINT64_MAX;
+        if (!i2c->dma_len) i2c->hw.status &= ~I2C_IC_STATUS_ACTIVITY_BITS;
+    }
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    const sim_i2c_msg_dev_t *dev = i2c_find(i2c, addr);
+    int n;
+
+    if (!dev) {
+        i2c_time(i2c, 0, nostop);
+        stats.i2c_nacks++;
+        sim_pico_advance_ns(0);
+        return PICO_ERROR_GENERIC;
+    }
+    n = dev->write(dev->ctx, src, len);
+    i2c_time(i2c, (size_t)n, nostop);
+    stats.i2c_bytes += (uint64_t)n;
+    sim_pico_advance_ns(0);
+    if ((size_t)n < len) {
+        stats.i2c_nacks++;
+        return PICO_ERROR_GENERIC;
+    }
+    return n;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    const sim_i2c_msg_dev_t *dev = i2c_find(i2c, addr);
+    int n;
+
+    if (!dev || !dev->read) {
+        i2c_time(i2c, 0, nostop);
+        stats.i2c_nacks++;
+        sim_pico_advance_ns(0);
+        return PICO_ERROR_GENERIC;
+    }
+    n = dev->read(dev->ctx, dst, len);
+    i2c_time(i2c, len, nostop);
+    stats.i2c_bytes += len;
+    sim_pico_advance_ns(0);
+    return n;
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+void sim_pico_init(void) {
+    memset(pins, 0, sizeof(pins));
+    memset(&sim_spi0, 0, sizeof(sim_spi0));
+    memset(&sim_spi1, 0, sizeof(sim_spi1));
+    sim_spi0.dma_next_ns = sim_spi1.dma_next_ns = UINT64_MAX;
+    memset(dma_ch, 0, sizeof(dma_ch));
+    memset(dma_inte, 0, sizeof(dma_inte));
+    memset(dma_ints, 0, sizeof(dma_ints));
+    memset(irq_handlers, 0, sizeof(irq_handlers));
+    memset(irq_on, 0, sizeof(irq_on));
+    irq_pending = 0;
+    memset(pio_blk, 0, sizeof(pio_blk));
+    memset(&sim_i2c0, 0, sizeof(sim_i2c0));
+    memset(&sim_i2c1, 0, sizeof(sim_i2c1));
+    sim_i2c0.dma_next_ns = sim_i2c1.dma_next_ns = UINT64_MAX;
+    sim_i2c0.hw.clr_tx_abrt_read = i2c0_clr_tx_abrt;
+    sim_i2c1.hw.clr_tx_abrt_read = i2c1_clr_tx_abrt;
+    memset(&stats, 0, sizeof(stats));
+    memset(cores, 0, sizeof(cores));
+    cores[0].running = true;
+    cur_core = baton = gpio_irq_core = 0;
+    irq_callback = NULL;
+    timers = NULL;
+    nalarm_pools = 0;
+    now_ns = 0;
+    run_ns = 0;
+    nsources = 0;
+}
+
+void sim_pico_attach_spi(spi_inst_t *spi, const sim_spi_dev_t *dev, int cs_pin, int rst_pin) {
+    spi->dev = *dev;
+    spi->attached = true;
+    spi->cs_pin = cs_pin;
+    spi->rst_pin = rst_pin;
+
+    // CS e RESET com pull-up no módulo: soltos = inativos
+    pins[cs_pin].spi_cs = spi;
+    sim_pico_gpio_drive((unsigned)cs_pin, true);
+    if (rst_pin >= 0) {
+        pins[rst_pin].spi_rst = spi;
+        sim_pico_gpio_drive((unsigned)rst_pin, true);
+    }
+}
+
+void sim_pico_wire_spi(spi_inst_t *spi, int sck_pin, int mosi_pin, int miso_pin) {
+    spi->wired = true;
+    spi->mosi_pin = mosi_pin;
+    spi->miso_pin = miso_pin;
+    pins[sck_pin].spi_sck = spi;
+}
+
+void sim_pico_attach_i2c(i2c_inst_t *i2c, uint8_t addr, const sim_i2c_msg_dev_t *dev) {
+    if (i2c->ndevs >= SIM_PICO_MAX_I2C_DEVS) return;
+    i2c->devs[i2c->ndevs].addr = addr;
+    i2c->devs[i2c->ndevs].dev = *dev;
+    i2c->ndevs++;
+}
+
+void sim_pico_add_source(const sim_source_t *src) {
+    if (nsources < SIM_PICO_MAX_SOURCES) sources[nsources++] = *src;
+}
+
+const sim_pico_stats_t *sim_pico_stats(void) {
+    return &stats;
+}
+
+void sim_pico_print_stats(FILE *f) {
+    double secs = now_ns / 1e9;
+
+    fprintf(f, "Tempo virtual:   %.3f s\n", secs);
+    for (int c = 0; c < (multicore ? 2 : 1); c++) {
+        uint64_t up = now_ns - (c ? stats.core1_launch_ns : 0);
+
+        fprintf(f, "%-17s", multicore ? (c ? "CPU core1:" : "CPU core0:") : "CPU:");
+        fprintf(f, "dormindo %.1f%% (%.3f s em sleep, %.3f s em WFE), %llu despertares (%.1f/s), %.3f ms em IRQ\n",
+                up ? 100.0 * (stats.sleep_ns[c] + stats.wfe_ns[c]) / up : 0.0,
+                stats.sleep_ns[c] / 1e9, stats.wfe_ns[c] / 1e9, (unsigned long long)stats.wakeups[c],
+                up ? stats.wakeups[c] / (up / 1e9) : 0.0, stats.irq_ns[c] / 1e6);
+    }
+    fprintf(f, "SPI:             %llu chamadas, %llu bytes, %.3f ms no barramento, %.3f ms com CS ativo\n",
+            (unsigned long long)stats.spi_calls, (unsigned long long)stats.spi_bytes, stats.spi_ns / 1e6,
+            stats.spi_cs_ns / 1e6);
+    if (stats.pio_cycles)
+        fprintf(f, "PIO:             %llu ciclos de máquina de estados, %llu bytes SPI pelos pinos\n",
+                (unsigned long long)stats.pio_cycles, (unsigned long long)stats.spi_pin_bytes);
+    fprintf(f, "I2C:             %llu transações (%llu NACK), %llu bytes, %.3f ms no barramento\n",
+            (unsigned long long)stats.i2c_transactions, (unsigned long long)stats.i2c_nacks,
+            (unsigned long long)stats.i2c_bytes, stats.i2c_ns / 1e6);
+    fprintf(f, "IRQs:            %llu de GPIO, %llu de timer, %llu de DMA\n",
+            (unsigned long long)stats.gpio_irqs, (unsigned long long)stats.timer_irqs,
+            (unsigned long long)stats.dma_irqs);
+    if (stats.dma_transfers)
+        fprintf(f, "DMA:             %llu transferências, %llu bytes\n",
+                (unsigned long long)stats.dma_transfers, (unsigned long long)stats.dma_bytes);
+}
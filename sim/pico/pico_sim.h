@@ -0,0 +1,125 @@
+// pico_sim.h - RP2040 simulado no host: tempo virtual, GPIOs, SPI e I2C ligados a modelos
+#ifndef PICO_SIM_H_
+#define PICO_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sim_dev.h"
+#include "hardware/spi.h"
+#include "hardware/i2c.h"
+
+// ============================================
+// === RP2040 simulado ===
+// ============================================
+//
+// O firmware do receptor é compilado para o host com os headers de include/
+// no lugar dos do pico-sdk. As chamadas de hardware_spi e hardware_i2c vão para
+// os modelos de dispositivo ligados com sim_pico_attach_*(); CS, RESET e DIO0
+// são GPIOs comuns, como na placa.
+//
+// O tempo virtual avança pela duração das transferências (na taxa devolvida
+// por spi_init()/i2c_init(), calculada como no SDK), por sleep_*(), por
+// tight_loop_contents() e por __wfe() até a próxima IRQ. Não há simulação das
+// instruções da CPU: o custo entre chamadas não conta. Os eventos agendados
+// das fontes (rádio, gerador de pacotes) e dos timers repetitivos são
+// aplicados em ordem enquanto o tempo avança; as bordas nos GPIOs e os timers
+// chamam os callbacks de IRQ do firmware no instante em que ocorrem.
+//
+// Os programas da PIO executam instrução a instrução no relógio de cada máquina
+// de estados, com os pinos e o DMA ligados; um escravo SPI com os fios
+// declarados em sim_pico_wire_spi() recebe os bits que ela gera.
+//
+// O DMA com DREQ de TX do I2C escreve palavras de DATA_CMD: cada uma é um byte
+// no ritmo do barramento, sem ocupar a CPU, e a transação vai ao dispositivo do
+// endereço em TAR quando chega o bit de STOP.
+//
+// multicore_launch_core1() roda o core1 numa thread do host, alternando com o
+// core0 nos pontos de espera; as IRQs vão para o núcleo que as registrou e o
+// FIFO do SIO liga os dois. Como os barramentos avançam o mesmo relógio, um
+// acesso SPI numa IRQ do core1 também atrasa uma transferência do core0.
+
+#define SIM_PICO_CLK_PERI_HZ    125000000 // clk_peri padrão (= clk_sys)
+#define SIM_PICO_MAX_SOURCES    4
+#define SIM_PICO_MAX_I2C_DEVS   4
+#define SIM_PICO_I2C_MSG_MAX    2048 // Maior transação I2C montada pelo DMA
+
+typedef struct {
+    uint64_t spi_calls;         // spi_*_blocking()
+    uint64_t spi_bytes;
+    uint64_t spi_ns;            // Tempo com o SPI transferindo
+    uint64_t spi_cs_ns;         // Tempo com o CS de um escravo ativo (qualquer mestre)
+    uint64_t spi_pin_bytes;     // Bytes que chegaram a escravos pelos pinos (PIO)
+    uint64_t pio_cycles;        // Ciclos executados pelas máquinas de estados
+    uint64_t i2c_transactions;
+    uint64_t i2c_bytes;         // Dados (sem o byte de endereço)
+    uint64_t i2c_nacks;
+    uint64_t i2c_ns;
+    uint64_t gpio_irqs;         // Chamadas do callback de IRQ de GPIO
+    uint64_t timer_irqs;        // Callbacks de timers repetitivos
+    uint64_t dma_irqs;          // Handlers de DMA_IRQ_0/1
+    uint64_t dma_transfers;     // Disparos de canal de DMA
+    uint64_t dma_bytes;         // Bytes movidos pelo DMA (SPI incluído também em spi_bytes)
+    uint64_t sleep_ns[2];       // Tempo em sleep_*(), por núcleo
+    uint64_t wfe_ns[2];         // Tempo dormindo em __wfe()/__wfi()
+    uint64_t wakeups[2];        // Saídas de sleep_*() e __wfe(): vezes que o núcleo acordou
+    uint64_t irq_ns[2];         // Tempo dentro de handlers de IRQ (barramentos bloqueantes)
+    uint64_t core1_launch_ns;   // multicore_launch_core1()
+} sim_pico_stats_t;
+
+/**
+ * @brief Zera relógio, GPIOs, contadores e dispositivos.
+ */
+void sim_pico_init(void);
+
+/**
+ * @brief Liga um escravo SPI ao controlador, com os GPIOs de CS e RESET (ativos em 0).
+ * @param rst_pin GPIO do RESET, ou -1.
+ */
+void sim_pico_attach_spi(spi_inst_t *spi, const sim_spi_dev_t *dev, int cs_pin, int rst_pin);
+
+/**
+ * @brief Fios de SCK, MOSI e MISO do escravo ligado ao controlador. O bloco SPI
+ * não precisa deles; com eles, um mestre que gera os bits nos pinos (a PIO)
+ * também fala com o dispositivo.
+ */
+void sim_pico_wire_spi(spi_inst_t *spi, int sck_pin, int mosi_pin, int miso_pin);
+
+/**
+ * @brief Acrescenta um escravo ao barramento do controlador I2C.
+ */
+void sim_pico_attach_i2c(i2c_inst_t *i2c, uint8_t addr, const sim_i2c_msg_dev_t *dev);
+
+/**
+ * @brief Registra uma fonte de eventos.
+ */
+void sim_pico_add_source(const sim_source_t *src);
+
+/**
+ * @brief Nível imposto por um dispositivo num GPIO (DIO0, botões...). Dispara a
+ * IRQ do firmware se a borda estiver habilitada.
+ */
+void sim_pico_gpio_drive(unsigned pin, bool level);
+
+/**
+ * @brief Avança o tempo virtual aplicando os eventos das fontes; encerra em run_ns.
+ */
+void sim_pico_advance_ns(uint64_t ns);
+
+/**
+ * @brief Encerra a simulação quando o tempo virtual chegar a run_ns (0 = nunca).
+ */
+void sim_pico_set_run_ns(uint64_t run_ns);
+
+/**
+ * @brief Contadores acumulados.
+ */
+const sim_pico_stats_t *sim_pico_stats(void);
+
+/**
+ * @brief Imprime tempo virtual e contadores dos barramentos.
+ */
+void sim_pico_print_stats(FILE *f);
+
+#endif // PICO_SIM_H_
@@ -0,0 +1,181 @@
+// rx_bench.c - benchmark do driver do rádio do receptor (bitdoglab/inc/lora_RFM95.c)
+//
+//   rx_bench [n]        SPI de hardware
+//   rx_bench_pio [n]    o mesmo driver com LORA_SPI_PIO=1 (lora_spi.pio)
+//   rx_bench_stream [n] o mesmo driver com LORA_RX_STREAM=1 (payload lido desde o ValidHeader)
+//
+// Para cada operação mostra o tempo virtual (nas capturas, do RxDone no DIO0
+// até o pacote na fila), o tempo de CPU fora de WFE/sleep, o tempo com o CS
+// ativo, os bytes pelo bloco SPI e pelos pinos e o tempo de host.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pico_sim.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "rfm95_model.h"
+
+#include "inc/lora_RFM95.h"
+
+// Pinagem da placa (igual a bitdoglab_tarefa5.c)
+#define PIN_MISO    16
+#define PIN_CS      17
+#define PIN_SCK     18
+#define PIN_MOSI    19
+#define PIN_RST     20
+#define PIN_DIO0    8
+#define PIN_DIO3    9
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static rfm95_model_t radio;
+static uint64_t      dio0_ns;       // Última subida do DIO0
+
+typedef struct {
+    uint64_t now, idle, irq, cs, spi, pins;
+    uint64_t host_ns;
+} snap_t;
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static snap_t snap(void) {
+    const sim_pico_stats_t *s = sim_pico_stats();
+    return (snap_t){ sim_time_ns(), s->sleep_ns[0] + s->wfe_ns[0], s->irq_ns[0], s->spi_cs_ns,
+                     s->spi_bytes, s->spi_pin_bytes, host_ns() };
+}
+
+// virt_ns: tempo virtual da operação (0 = o intervalo todo). CPU: fora de
+// WFE/sleep, mais as IRQs atendidas durante o WFE
+static void row(const char *name, unsigned n, snap_t a, snap_t b, uint64_t virt_ns) {
+    uint64_t span = b.now - a.now;
+    uint64_t cpu = span - (b.idle - a.idle) + (b.irq - a.irq);
+
+    printf("%-22s %6u %11.2f %10.2f %9.2f %9.1f %10.1f %10.0f\n", name, n,
+           (virt_ns ? virt_ns : span) / 1e3 / n, cpu / 1e3 / n,
+           (b.cs - a.cs) / 1e3 / n, (double)(b.spi - a.spi) / n, (double)(b.pins - a.pins) / n,
+           (double)(b.host_ns - a.host_ns) / n);
+}
+
+static uint64_t radio_next(void *ctx) {
+    return rfm95_model_next_event_ns(ctx);
+}
+
+static void radio_poll(void *ctx) {
+    rfm95_model_poll(ctx);
+}
+
+static void on_dio0(void *arg, bool level) {
+    (void)arg;
+    if (level) dio0_ns = sim_time_ns();
+    sim_pico_gpio_drive(PIN_DIO0, level);
+}
+
+static void on_dio3(void *arg, bool level) {
+    (void)arg;
+    sim_pico_gpio_drive(PIN_DIO3, level);
+}
+
+// n pacotes de `len` bytes, um de cada vez; soma a latência DIO0 → fila
+static uint64_t capture(unsigned n, uint8_t len) {
+    uint8_t data[LORA_MAX_PAYLOAD];
+    uint64_t sum = 0;
+
+    for (unsigned i = 0; i < len; i++) data[i] = (uint8_t)(i * 7 + 1);
+    for (unsigned i = 0; i < n; i++) {
+        rfm95_packet_t pkt;
+        const lora_packet_t *got;
+
+        rfm95_model_make_packet(&radio, &pkt, data, len);
+        pkt.rssi_dbm = -80;
+        pkt.snr_db = 9.0f;
+        rfm95_model_rx_begin(&radio, &pkt);
+        while ((got = lora_rx_peek()) == NULL) __wfe();
+        sum += sim_time_ns() - dio0_ns;
+        if (got->len != len || memcmp(got->data, data, len) != 0) {
+            fprintf(stderr, "captura de %u bytes: payload diferente do enviado\n", len);
+            exit(1);
+        }
+        lora_rx_release();
+    }
+    return sum;
+}
+
+// ============================================
+// === main ===
+// ============================================
+
+int main(int argc, char **argv) {
+    unsigned n = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 10000;
+    static const lora_config_t cfg = {
+        .spi_instance = spi0,
+        .pin_miso = PIN_MISO,
+        .pin_cs = PIN_CS,
+        .pin_sck = PIN_SCK,
+        .pin_mosi = PIN_MOSI,
+        .pin_rst = PIN_RST,
+        .pin_dio0 = PIN_DIO0,
+        .pin_dio3 = PIN_DIO3,
+        .frequency = 915000000
+    };
+    volatile int sink = 0;
+    sim_spi_dev_t spi_dev;
+    sim_source_t src;
+    snap_t a;
+
+    sim_pico_init();
+    rfm95_model_init(&radio);
+    radio.on_dio0 = on_dio0;
+    radio.on_dio3 = on_dio3;
+    spi_dev = rfm95_model_dev(&radio);
+    sim_pico_attach_spi(spi0, &spi_dev, PIN_CS, PIN_RST);
+    sim_pico_wire_spi(spi0, PIN_SCK, PIN_MOSI, PIN_MISO);
+    src = (sim_source_t){ radio_next, radio_poll, &radio };
+    sim_pico_add_source(&src);
+
+    printf("Barramento do rádio: %s, %u Hz pedidos; payload lido %s\n\n",
+           LORA_SPI_PIO ? "PIO (lora_spi.pio)" : "SPI de hardware", LORA_SPI_HZ,
+           LORA_RX_STREAM ? "desde o ValidHeader" : "no RxDone");
+    printf("%-22s %6s %11s %10s %9s %9s %10s %10s\n",
+           "operacao", "n", "us virt/op", "us CPU/op", "us CS/op", "B SPI/op", "B pinos/op", "ns host/op");
+
+    a = snap();
+    if (!lora_init(cfg)) { fprintf(stderr, "lora_init falhou\n"); return 1; }
+    row("lora_init", 1, a, snap(), 0);
+
+    a = snap();
+    for (unsigned i = 0; i < n; i++) sink ^= lora_get_rssi();
+    row("lora_get_rssi", n, a, snap(), 0);
+
+    // Captura em RX contínuo: IRQ do DIO0 + DMA do FIFO; a CPU espera em WFE
+    lora_start_rx_continuous();
+    static const uint8_t lens[] = { 2, 64, 255 };
+    for (size_t j = 0; j < sizeof(lens) / sizeof(lens[0]); j++) {
+        unsigned k = n / 500 + 1;
+        char name[32];
+        uint64_t lat;
+
+        a = snap();
+        lat = capture(k, lens[j]);
+        snprintf(name, sizeof(name), "captura %u B", lens[j]);
+        row(name, k, a, snap(), lat);
+    }
+
+    lora_rx_stats_t rs;
+    lora_rx_get_stats(&rs);
+    printf("\nFila: %u pacotes, %u bytes de payload lidos antes do RxDone\n\n", rs.captured, rs.streamed);
+    sim_pico_print_stats(stdout);
+    (void)sink;
+    return 0;
+}
@@ -0,0 +1,295 @@
+// rx_main.c - receptor da BitDogLab (bitdoglab/bitdoglab_tarefa5.c) rodando no host
+//
+//   rx_sim [opções] > console.txt
+//
+// O rádio recebe um pacote de iluminância a cada --period-ms, como se viesse
+// do TX; o display é o modelo do SSD1306. O printf do firmware vai para o
+// stdout; os contadores e a tela final vão para o stderr ao sair.
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "pico_sim.h"
+#include "rfm95_model.h"
+#include "ssd1306_model.h"
+#include "sim_link.h"
+
+#include "inc/ssd1306.h"
+
+int firmware_main(void); // main() de bitdoglab/bitdoglab_tarefa5.c
+
+// Pinagem da placa (igual a bitdoglab_tarefa5.c)
+#define PIN_MISO    16
+#define PIN_CS      17
+#define PIN_SCK     18
+#define PIN_MOSI    19
+#define PIN_RST     20
+#define PIN_DIO0    8
+#define PIN_DIO3    9
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static rfm95_model_t   radio;
+static ssd1306_model_t display;
+
+static struct {
+    uint64_t next_ns;           // Próximo pacote
+    uint64_t period_ns;
+    double   lux;
+    int16_t  rssi_dbm;
+    float    snr_db;
+    uint8_t  payload;           // Tamanho do pacote (>= 2: lux e enchimento)
+    uint32_t sent;
+} gen;
+
+// Latência DIO0 (RxDone) → GDDRAM igual ao quadro do show seguinte
+static struct {
+    bool     pending;
+    const ssd1306_t *disp;      // Display do último show com quadro ainda a caminho
+    uint32_t seq;               // Pacote do canal virtual (com --link-fd)
+    uint64_t dio0_ns;
+    uint32_t count;
+    uint64_t sum_ns, min_ns, max_ns;
+} lat;
+
+static const char *frames_dir;
+static bool        show_screen;
+static bool        linked;
+
+// ============================================
+// === Fontes de eventos ===
+// ============================================
+
+static uint64_t radio_next(void *ctx) {
+    return rfm95_model_next_event_ns(ctx);
+}
+
+static void radio_poll(void *ctx) {
+    rfm95_model_poll(ctx);
+}
+
+static uint64_t gen_next(void *ctx) {
+    (void)ctx;
+    return gen.next_ns;
+}
+
+// Payload igual ao do TX: bh1750_dados { uint16_t iluminancia = lux * 100 }
+static void gen_poll(void *ctx) {
+    rfm95_packet_t pkt;
+    uint16_t v;
+    uint8_t data[255];
+
+    (void)ctx;
+    if (sim_time_ns() < gen.next_ns) return;
+    v = (uint16_t)(gen.lux * 100.0 + 0.5);
+    data[0] = (uint8_t)v;
+    data[1] = (uint8_t)(v >> 8);
+    for (unsigned i = 2; i < gen.payload; i++) data[i] = (uint8_t)i;
+
+    // Mesma configuração do receptor: o TX usa os mesmos parâmetros
+    rfm95_model_make_packet(&radio, &pkt, data, gen.payload);
+    pkt.rssi_dbm = gen.rssi_dbm;
+    pkt.snr_db = gen.snr_db;
+    rfm95_model_rx_begin(&radio, &pkt);
+    gen.sent++;
+    gen.next_ns = gen.period_ns ? gen.next_ns + gen.period_ns : UINT64_MAX;
+}
+
+// ============================================
+// === Ganchos dos modelos ===
+// ============================================
+
+static void on_dio0(void *arg, bool level) {
+    (void)arg;
+    if (level && (radio.regs[0x12] & 0x60) == 0x40) { // RxDone sem erro de CRC
+        lat.pending = true;
+        lat.seq = linked ? sim_link_rx_seq() : 0;
+        lat.dio0_ns = sim_time_ns();
+    }
+    sim_pico_gpio_drive(PIN_DIO0, level);
+}
+
+static void on_dio3(void *arg, bool level) {
+    (void)arg;
+    sim_pico_gpio_drive(PIN_DIO3, level);
+}
+
+// O quadro está visível quando a GDDRAM do modelo é igual à cópia que o driver
+// guarda do que mandou (shadow): vale para o show bloqueante, para o show por
+// DMA (que volta antes dos bytes saírem) e para um valor igual ao da tela, que
+// não gera escrita nenhuma
+static void check_shown(const ssd1306_model_t *m) {
+    uint64_t d;
+
+    if (!lat.disp || memcmp(m->gddram, lat.disp->shadow, sizeof(m->gddram)) != 0) return;
+    lat.disp = NULL;
+    if (!lat.pending) return;
+    d = sim_time_ns() - lat.dio0_ns;
+    lat.pending = false;
+    lat.count++;
+    lat.sum_ns += d;
+    if (!lat.min_ns || d < lat.min_ns) lat.min_ns = d;
+    if (d > lat.max_ns) lat.max_ns = d;
+    if (linked) sim_link_shown(lat.seq);
+}
+
+void __real_ssd1306_show(ssd1306_t *p);
+bool __real_ssd1306_show_async(ssd1306_t *p);
+
+void __wrap_ssd1306_show(ssd1306_t *p) {
+    __real_ssd1306_show(p);
+    lat.disp = p;
+    check_shown(&display);
+}
+
+bool __wrap_ssd1306_show_async(ssd1306_t *p) {
+    bool queued = __real_ssd1306_show_async(p);
+    if (queued) {
+        lat.disp = p;
+        check_shown(&display);
+    }
+    return queued;
+}
+
+static void on_frame(void *arg, const ssd1306_model_t *m) {
+    (void)arg;
+    check_shown(m);
+    if (frames_dir) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/frame_%05u.pbm", frames_dir, m->stats.frames);
+        if (!ssd1306_model_write_pbm(m, path)) fprintf(stderr, "Não foi possível gravar %s\n", path);
+    }
+}
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "Uso: %s [opções]\n"
+        "  --run-ms <ms>        Tempo virtual simulado (padrão 60000)\n"
+        "  --period-ms <ms>     Intervalo entre pacotes (padrão 10000, como o TX; 0 = um só)\n"
+        "  --first-ms <ms>      Chegada do primeiro pacote (padrão 8000)\n"
+        "  --lux <valor>        Iluminância enviada (padrão 250.0)\n"
+        "  --rssi <dBm>         RSSI dos pacotes (padrão -80)\n"
+        "  --payload <bytes>    Tamanho dos pacotes, 2..255 (padrão 2; acima disso o\n"
+        "                       firmware os trata como brutos)\n"
+        "  --snr <dB>           SNR dos pacotes (padrão 9)\n"
+        "  --frames <dir>       Grava cada quadro do display como PBM em <dir>\n"
+        "  --screen             Desenha a tela final no stderr\n"
+        "  --link-fd <fd>       Nó do canal virtual (aberto pelo lora_link); sem gerador\n"
+        "  --quiet              Sem relatório no stderr ao sair\n", prog);
+}
+
+static void report(void) {
+    const sim_pico_stats_t *s = sim_pico_stats();
+    uint32_t n = lat.count ? lat.count : 1;
+
+    fprintf(stderr, "\n=== rx_sim ===\n");
+    sim_pico_print_stats(stderr);
+    rfm95_model_print_stats(&radio, stderr);
+    const ssd1306_stats_t *d = &display.stats;
+    uint32_t bus = d->transactions + d->ctrl_bytes + d->cmd_bytes + d->data_bytes; // Com o byte de endereço
+    fprintf(stderr, "SSD1306:         %u transações, %u quadros, %u bytes de comando, %u de dados\n",
+            d->transactions, d->frames, d->cmd_bytes, d->data_bytes);
+    fprintf(stderr, "                 %u bytes no barramento, %.0f por quadro\n",
+            bus, d->frames ? (double)bus / d->frames : 0.0);
+    fprintf(stderr, "Pacotes:         %u enviados, %u mostrados no display\n", gen.sent, lat.count);
+    if (lat.count) {
+        fprintf(stderr, "Latência:        DIO0 → display  mín %.2f ms, média %.2f ms, máx %.2f ms\n",
+                lat.min_ns / 1e6, lat.sum_ns / 1e6 / n, lat.max_ns / 1e6);
+        fprintf(stderr, "Por pacote:      %.0f bytes SPI, %.0f bytes I2C (média sobre toda a execução)\n",
+                (double)s->spi_bytes / n, (double)s->i2c_bytes / n);
+    }
+    if (show_screen) ssd1306_model_print(&display, stderr);
+}
+
+// ============================================
+// === main ===
+// ============================================
+
+int main(int argc, char **argv) {
+    static const struct option opts[] = {
+        { "run-ms",    required_argument, NULL, 't' },
+        { "period-ms", required_argument, NULL, 'p' },
+        { "first-ms",  required_argument, NULL, 'F' },
+        { "lux",       required_argument, NULL, 'l' },
+        { "rssi",      required_argument, NULL, 'r' },
+        { "snr",       required_argument, NULL, 's' },
+        { "payload",   required_argument, NULL, 'P' },
+        { "frames",    required_argument, NULL, 'f' },
+        { "screen",    no_argument,       NULL, 'S' },
+        { "link-fd",   required_argument, NULL, 'k' },
+        { "quiet",     no_argument,       NULL, 'q' },
+        { "help",      no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    uint64_t run_ns = 60000ull * 1000000ull;
+    uint64_t first_ns = 8000ull * 1000000ull;
+    bool quiet = false;
+    int link_fd = -1;
+    sim_source_t src;
+    sim_spi_dev_t spi_dev;
+    sim_i2c_msg_dev_t i2c_dev;
+    int c;
+
+    gen.period_ns = 10000ull * 1000000ull;
+    gen.lux = 250.0;
+    gen.rssi_dbm = -80;
+    gen.snr_db = 9.0f;
+    gen.payload = 2;
+
+    while ((c = getopt_long(argc, argv, "h", opts, NULL)) != -1) {
+        switch (c) {
+        case 't': run_ns = strtoull(optarg, NULL, 0) * 1000000ull; break;
+        case 'p': gen.period_ns = strtoull(optarg, NULL, 0) * 1000000ull; break;
+        case 'F': first_ns = strtoull(optarg, NULL, 0) * 1000000ull; break;
+        case 'l': gen.lux = atof(optarg); break;
+        case 'r': gen.rssi_dbm = (int16_t)atoi(optarg); break;
+        case 's': gen.snr_db = (float)atof(optarg); break;
+        case 'P': gen.payload = (uint8_t)(atoi(optarg) < 2 ? 2 : atoi(optarg) > 255 ? 255 : atoi(optarg)); break;
+        case 'f': frames_dir = optarg; break;
+        case 'S': show_screen = true; break;
+        case 'k': link_fd = atoi(optarg); break;
+        case 'q': quiet = true; break;
+        default:  usage(argv[0]); return c == 'h' ? 0 : 2;
+        }
+    }
+    gen.next_ns = first_ns;
+
+    sim_pico_init();
+    sim_pico_set_run_ns(run_ns);
+    if (!quiet) atexit(report);
+
+    rfm95_model_init(&radio);
+    radio.on_dio0 = on_dio0;
+    radio.on_dio3 = on_dio3;
+    spi_dev = rfm95_model_dev(&radio);
+    sim_pico_attach_spi(spi0, &spi_dev, PIN_CS, PIN_RST);
+    sim_pico_wire_spi(spi0, PIN_SCK, PIN_MOSI, PIN_MISO);
+
+    ssd1306_model_init(&display);
+    display.on_frame = on_frame;
+    i2c_dev = ssd1306_model_dev(&display);
+    sim_pico_attach_i2c(i2c1, SSD1306_MODEL_ADDR, &i2c_dev);
+
+    src = (sim_source_t){ radio_next, radio_poll, &radio };
+    sim_pico_add_source(&src);
+    if (link_fd >= 0) {
+        // Pacotes vêm do canal virtual, dos tx_sim
+        linked = true;
+        sim_link_open(link_fd, SIM_LINK_ROLE_RX, &radio);
+        src = sim_link_source();
+    } else {
+        src = (sim_source_t){ gen_next, gen_poll, NULL };
+    }
+    sim_pico_add_source(&src);
+
+    firmware_main();
+    return 0;
+}
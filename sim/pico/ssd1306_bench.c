@@ -0,0 +1,235 @@
+// ssd1306_bench.c - benchmark do texto do driver do display (bitdoglab/inc/ssd1306.c)
+//
+//   ssd1306_bench [n]
+//
+// Compara ssd1306_draw_char_with_font() com a versão anterior, que desenhava
+// um ssd1306_draw_square() por pixel da fonte: primeiro confere que as duas
+// deixam o framebuffer igual (todos os caracteres, escalas 1 a 4, linhas
+// alinhadas ou não às páginas e cortes na borda), depois mede glifos por
+// segundo no host, por escala e com a linha do show_lux(). Confere também
+// que, depois de um NACK no meio do DMA do show_async(), o driver avisa o
+// callback e o próximo quadro deixa a GDDRAM igual ao framebuffer, e que o
+// limite de quadros acorda quem espera em __wfe() quando termina.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pico_sim.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "ssd1306_model.h"
+
+#include "inc/ssd1306.h"
+
+extern const uint8_t font_8x5[];
+
+// ============================================
+// === Estado ===
+// ============================================
+
+static ssd1306_model_t display;
+static ssd1306_t       disp;
+static unsigned        frames_ok, frames_failed;   // Contados pelo callback do show_async()
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static uint64_t host_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// O desenho anterior: um quadrado de scale x scale por pixel aceso
+static void draw_char_ref(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const uint8_t *font, char c) {
+    if (c < font[3] || c > font[4]) return;
+
+    uint32_t parts_per_line = (font[0] >> 3) + ((font[0] & 7) > 0);
+    for (uint8_t w = 0; w < font[1]; ++w) {
+        uint32_t pp = (c - font[3]) * font[1] * parts_per_line + w * parts_per_line + 5;
+        for (uint32_t lp = 0; lp < parts_per_line; ++lp) {
+            uint8_t line = font[pp];
+            for (int8_t j = 0; j < 8; ++j, line >>= 1) {
+                if (line & 1) ssd1306_draw_square(p, x + w * scale, y + ((lp << 3) + j) * scale, scale, scale);
+            }
+            ++pp;
+        }
+    }
+}
+
+static void draw_string_ref(ssd1306_t *p, uint32_t x, uint32_t y, uint32_t scale, const char *s) {
+    for (int32_t x_n = x; *s; x_n += (font_8x5[1] + font_8x5[2]) * scale)
+        draw_char_ref(p, x_n, y, scale, font_8x5, *(s++));
+}
+
+// Cada glifo desenhado nos dois caminhos sobre o mesmo fundo
+static bool check(void) {
+    static uint8_t want[1024];
+    static const uint32_t xs[] = { 0, 3, 61, 120, 125, 127 };
+    unsigned cases = 0;
+
+    for (uint32_t scale = 1; scale <= 4; scale++)
+        for (uint32_t y = 0; y < 64; y += (y < 16 ? 1 : 5))
+            for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); i++)
+                for (int c = 31; c <= 127; c++) {
+                    ssd1306_clear(&disp);
+                    ssd1306_draw_pixel(&disp, 64, 32);
+                    draw_char_ref(&disp, xs[i], y, scale, font_8x5, (char)c);
+                    memcpy(want, disp.buffer, disp.bufsize);
+
+                    ssd1306_clear(&disp);
+                    ssd1306_draw_pixel(&disp, 64, 32);
+                    ssd1306_draw_char(&disp, xs[i], y, scale, (char)c);
+                    if (memcmp(want, disp.buffer, disp.bufsize) != 0) {
+                        fprintf(stderr, "'%c' escala %u em (%u, %u): framebuffer diferente da referência\n",
+                                c, scale, xs[i], y);
+                        return false;
+                    }
+                    cases++;
+                }
+    printf("Conferidos %u glifos: framebuffer igual ao do desenho por pixel\n\n", cases);
+    return true;
+}
+
+static void async_done(ssd1306_t *p, bool ok, void *arg) {
+    (void)p;
+    (void)arg;
+    if (ok) frames_ok++;
+    else    frames_failed++;
+}
+
+static bool gddram_matches(void) {
+    for (unsigned y = 0; y < disp.height; y++)
+        for (unsigned x = 0; x < disp.width; x++)
+            if (ssd1306_model_pixel(&display, x, y) != ((disp.buffer[x + disp.width * (y >> 3)] >> (y & 7)) & 1))
+                return false;
+    return true;
+}
+
+// O display recusa a transação da primeira janela (nack=1): o resto do quadro,
+// e o da fila atrás dele, some no flush do FIFO. O show seguinte manda a tela toda.
+static bool check_nack(bool queue_behind) {
+    unsigned failed = frames_failed;
+
+    ssd1306_clear(&disp);
+    ssd1306_draw_string(&disp, 0, 0, 2, "NACK");
+    ssd1306_draw_string(&disp, 0, 40, 1, queue_behind ? "com fila" : "sem fila");
+    display.nack = 1;
+    ssd1306_show_async(&disp);
+    if (queue_behind) {
+        ssd1306_draw_string(&disp, 64, 20, 1, "atras");
+        ssd1306_show_async(&disp);
+    }
+    ssd1306_async_wait(&disp);
+    if (frames_failed == failed) {
+        fprintf(stderr, "NACK (%s) não chegou ao callback\n", queue_behind ? "com fila" : "sem fila");
+        return false;
+    }
+
+    ssd1306_draw_pixel(&disp, 127, 63);
+    ssd1306_show_async(&disp);
+    ssd1306_async_wait(&disp);
+    if (!gddram_matches() || frames_failed != failed + 1) {
+        fprintf(stderr, "NACK (%s): GDDRAM diferente do framebuffer depois do reenvio\n",
+                queue_behind ? "com fila" : "sem fila");
+        return false;
+    }
+    return true;
+}
+
+// Com o limite de quadros, o segundo show é recusado e ssd1306_async_busy() fica
+// true até o fim do intervalo; o timer do driver acorda o __wfe() nessa hora
+static bool check_rate_limit(uint32_t min_frame_us) {
+    uint64_t queued_us, woke_us;
+
+    ssd1306_clear(&disp);
+    ssd1306_draw_string(&disp, 0, 0, 1, "limite");
+    if (!ssd1306_show_async(&disp)) { fprintf(stderr, "limite: primeiro quadro recusado\n"); return false; }
+    queued_us = time_us_64();
+    ssd1306_draw_string(&disp, 0, 16, 1, "de quadros");
+    if (ssd1306_show_async(&disp)) { fprintf(stderr, "limite: segundo quadro aceito antes do intervalo\n"); return false; }
+
+    while (ssd1306_async_busy(&disp)) __wfe();
+    woke_us = time_us_64();
+    if (woke_us < queued_us + min_frame_us || woke_us > queued_us + min_frame_us + 1000) {
+        fprintf(stderr, "limite: acordou %lld us depois do primeiro quadro (limite %u us)\n",
+                (long long)(woke_us - queued_us), min_frame_us);
+        return false;
+    }
+    if (!ssd1306_show_async(&disp)) { fprintf(stderr, "limite: quadro recusado depois do intervalo\n"); return false; }
+    ssd1306_async_wait(&disp);
+    if (!gddram_matches()) { fprintf(stderr, "limite: GDDRAM diferente do framebuffer\n"); return false; }
+    printf("Limite de quadros: acordou %llu us depois do quadro anterior (limite %u us)\n\n",
+           (unsigned long long)(woke_us - queued_us), min_frame_us);
+    return true;
+}
+
+static void row(const char *name, unsigned glyphs, uint64_t ref_ns, uint64_t new_ns) {
+    printf("%-24s %14.0f %14.0f %8.1fx\n", name,
+           glyphs / (ref_ns / 1e9), glyphs / (new_ns / 1e9), (double)ref_ns / new_ns);
+}
+
+// n vezes a mesma linha nos dois caminhos; o desenho só faz OR, então não precisa limpar
+static void bench_text(const char *name, unsigned n, uint32_t x, uint32_t y, uint32_t scale, const char *s) {
+    unsigned glyphs = n * (unsigned)strlen(s);
+    uint64_t t0, ref_ns, new_ns;
+
+    ssd1306_clear(&disp);
+    t0 = host_ns();
+    for (unsigned i = 0; i < n; i++) draw_string_ref(&disp, x, y, scale, s);
+    ref_ns = host_ns() - t0;
+
+    ssd1306_clear(&disp);
+    t0 = host_ns();
+    for (unsigned i = 0; i < n; i++) ssd1306_draw_string(&disp, x, y, scale, s);
+    new_ns = host_ns() - t0;
+
+    row(name, glyphs, ref_ns, new_ns);
+}
+
+// ============================================
+// === main ===
+// ============================================
+
+int main(int argc, char **argv) {
+    unsigned n = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 0) : 100000;
+    sim_i2c_msg_dev_t i2c_dev;
+    char line[32];
+
+    sim_pico_init();
+    ssd1306_model_init(&display);
+    i2c_dev = ssd1306_model_dev(&display);
+    sim_pico_attach_i2c(i2c1, SSD1306_MODEL_ADDR, &i2c_dev);
+    i2c_init(i2c1, 400 * 1000);
+    disp.external_vcc = false;
+    if (!ssd1306_init(&disp, 128, 64, 0x3C, i2c1)) { fprintf(stderr, "ssd1306_init falhou\n"); return 1; }
+
+    if (!check()) return 1;
+
+    ssd1306_clear(&disp);
+    ssd1306_show(&disp);
+    if (!ssd1306_async_init(&disp, async_done, NULL, 0)) { fprintf(stderr, "ssd1306_async_init falhou\n"); return 1; }
+    if (!check_nack(false) || !check_nack(true)) return 1;
+    printf("NACK no show_async: %u quadros perdidos, reenvio igual ao framebuffer (%u NACKs)\n\n",
+           frames_failed, display.stats.nacks);
+
+    ssd1306_deinit(&disp);
+    if (!ssd1306_init(&disp, 128, 64, 0x3C, i2c1) || !ssd1306_async_init(&disp, async_done, NULL, 50000)) {
+        fprintf(stderr, "reinício do display falhou\n");
+        return 1;
+    }
+    if (!check_rate_limit(50000)) return 1;
+
+    printf("%-24s %14s %14s %9s\n", "texto", "glifos/s ref", "glifos/s novo", "ganho");
+    bench_text("escala 1, y=8", n, 0, 8, 1, "Esperando dados...");
+    bench_text("escala 1, y=29", n, 0, 29, 1, "Esperando dados...");
+    bench_text("escala 2, y=24", n, 0, 24, 2, "0123456789");
+    bench_text("escala 3, y=20", n, 0, 20, 3, "1234567");
+    snprintf(line, sizeof(line), "%.1f Lux", 250.0f);
+    bench_text("show_lux (escala 2)", n, 10, (64 - 16) / 2, 2, line);
+
+    ssd1306_deinit(&disp);
+    return 0;
+}
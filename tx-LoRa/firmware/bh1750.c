@@ -5,6 +5,10 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "trace.h"
+#include "fastmem.h" // FAST_TEXT: primitivas I2C executadas da SRAM
+#include "config.h"  // Endereço I2C do sensor
+
 // ============================================
 // === Utils de tempo ===
 // ============================================
@@ -26,25 +30,25 @@ static uint32_t i2c_w_reg = 0;
 
 static void i2c_delay(void) { busy_wait_us(5); }
 
-static void i2c_set_scl(int val) {
+static FAST_TEXT void i2c_set_scl(int val) {
     if (val) i2c_w_reg |= (1 << CSR_I2C_W_SCL_OFFSET);
     else     i2c_w_reg &= ~(1 << CSR_I2C_W_SCL_OFFSET);
     i2c_w_write(i2c_w_reg);
 }
 
-static void i2c_set_sda(int val) {
+static FAST_TEXT void i2c_set_sda(int val) {
     if (val) i2c_w_reg |= (1 << CSR_I2C_W_SDA_OFFSET);
     else     i2c_w_reg &= ~(1 << CSR_I2C_W_SDA_OFFSET);
     i2c_w_write(i2c_w_reg);
 }
 
-static void i2c_set_oe(int val) {
+static FAST_TEXT void i2c_set_oe(int val) {
     if (val) i2c_w_reg |= (1 << CSR_I2C_W_OE_OFFSET);
     else     i2c_w_reg &= ~(1 << CSR_I2C_W_OE_OFFSET);
     i2c_w_write(i2c_w_reg);
 }
 
-static int i2c_read_sda(void) {
+static FAST_TEXT int i2c_read_sda(void) {
     return (i2c_r_read() & (1 << CSR_I2C_R_SDA_OFFSET)) != 0;
 }
 
@@ -55,20 +59,21 @@ void i2c_init(void) {
 }
 
 // --- Funções Internas I2C (static) ---
-static void i2c_start(void) {
+static FAST_TEXT void i2c_start(void) {
     i2c_set_sda(1); i2c_set_oe(1); i2c_set_scl(1); i2c_delay();
     i2c_set_sda(0); i2c_delay();
     i2c_set_scl(0); i2c_delay();
 }
 
-static void i2c_stop(void) {
+static FAST_TEXT void i2c_stop(void) {
     i2c_set_sda(0); i2c_set_oe(1); i2c_set_scl(0); i2c_delay();
     i2c_set_scl(1); i2c_delay();
     i2c_set_sda(1); i2c_delay();
 }
 
-static bool i2c_write_byte(uint8_t byte) {
+static FAST_TEXT bool i2c_write_byte(uint8_t byte) {
     int i; bool ack;
+    TRACE_BEGIN(I2C_WRITE_BYTE, byte);
     i2c_set_oe(1);
     for (i = 0; i < 8; i++) {
         i2c_set_sda((byte & 0x80) != 0); i2c_delay();
@@ -80,11 +85,13 @@ static bool i2c_write_byte(uint8_t byte) {
     i2c_set_scl(1); i2c_delay();
     ack = !i2c_read_sda();
     i2c_set_scl(0); i2c_delay();
+    TRACE_END(I2C_WRITE_BYTE, ack);
     return ack;
 }
 
-static uint8_t i2c_read_byte(bool send_ack) {
+static FAST_TEXT uint8_t i2c_read_byte(bool send_ack) {
     int i; uint8_t byte = 0;
+    TRACE_BEGIN(I2C_READ_BYTE, send_ack);
     i2c_set_oe(0); i2c_set_sda(1); i2c_delay();
     for (i = 0; i < 8; i++) {
         byte <<= 1;
@@ -95,6 +102,7 @@ static uint8_t i2c_read_byte(bool send_ack) {
     i2c_set_oe(1); i2c_set_sda(!send_ack); i2c_delay();
     i2c_set_scl(1); i2c_delay();
     i2c_set_scl(0); i2c_delay();
+    TRACE_END(I2C_READ_BYTE, byte);
     return byte;
 }
 
@@ -115,41 +123,63 @@ void i2c_scan(void) {
 // ======================================================
 // BH1750
 // ======================================================
-#define BH1750_I2C_ADDR       0x23
+#define BH1750_I2C_ADDR       ((uint8_t)config.bh1750_addr) // Padrão 0x23 (ADDR em GND)
 #define BH1750_POWER_ON       0x01
 #define BH1750_CONT_HRES_MODE 0x10
 #define BH1750_ONE_TIME_HRES_MODE 0x20
 
-int bh1750_init(void) {
+int bh1750_start(void) {
     i2c_start();
     if (!i2c_write_byte(BH1750_I2C_ADDR << 1 | 0)) { i2c_stop(); return -1; }
     if (!i2c_write_byte(BH1750_POWER_ON)) { i2c_stop(); return -1; }
     i2c_stop();
-    busy_wait_ms(10);
-    
-    // Configurar modo contínuo de alta resolução
+
+    // Configurar modo contínuo de alta resolução (a conversão começa aqui)
     i2c_start();
     if (!i2c_write_byte(BH1750_I2C_ADDR << 1 | 0)) { i2c_stop(); return -1; }
     if (!i2c_write_byte(BH1750_CONT_HRES_MODE)) { i2c_stop(); return -1; }
     i2c_stop();
-    busy_wait_ms(180); // Esperar primeira medição
-    
+
     return 0;
 }
 
-bool bh1750_get_data(bh1750_dados *d) {
+int bh1750_init(void) {
+    if (bh1750_start() != 0) return -1;
+    busy_wait_ms(BH1750_MEAS_TIME_MS); // Esperar primeira medição
+    return 0;
+}
+
+// Leitura crua; false só sem ACK do sensor
+static bool bh1750_read_raw(uint16_t *raw) {
     uint8_t data[2];
-    uint16_t raw;
+
+    TRACE_BEGIN(BH1750_READ, 0);
 
     // Ler dados (modo contínuo já está configurado)
     i2c_start();
-    if (!i2c_write_byte(BH1750_I2C_ADDR << 1 | 1)) { i2c_stop(); return false; }
+    if (!i2c_write_byte(BH1750_I2C_ADDR << 1 | 1)) { i2c_stop(); TRACE_END(BH1750_READ, 0); return false; }
 
     data[0] = i2c_read_byte(true);
     data[1] = i2c_read_byte(false);
     i2c_stop();
 
-    raw = ((uint16_t)data[0] << 8) | data[1];
+    *raw = ((uint16_t)data[0] << 8) | data[1];
+    TRACE_END(BH1750_READ, *raw);
+    return true;
+}
+
+bool bh1750_read(bh1750_dados *d) {
+    uint16_t raw;
+
+    if (!bh1750_read_raw(&raw)) return false;
+    d->luminosidade = (uint16_t)((raw * 250) / 3);
+    return true;
+}
+
+bool bh1750_get_data(bh1750_dados *d) {
+    uint16_t raw;
+
+    if (!bh1750_read_raw(&raw)) return false;
     if (raw == 0xFFFF || raw == 0x0000) return false;
 
     // Conversão: lux = raw / 1.2 → multiplicado por 100 (sem float)
@@ -31,16 +31,32 @@ void i2c_scan(void);
 // === Protótipos BH1750 ===
 // ============================================
 
+// Tempo máximo de uma conversão em alta resolução (datasheet: 120 ms típico, 180 ms máximo)
+#define BH1750_MEAS_TIME_MS 180
+
 /**
- * Inicializa o sensor BH1750.
+ * Inicializa o sensor BH1750 e espera a primeira medição (bloqueia ~180 ms).
  * Retorna 0 em sucesso, -1 em falha.
  */
 int bh1750_init(void);
 
+/**
+ * Liga o BH1750 e inicia a conversão contínua, sem esperar a primeira medição.
+ * A primeira leitura válida fica pronta em até BH1750_MEAS_TIME_MS.
+ * Retorna 0 em sucesso, -1 em falha.
+ */
+int bh1750_start(void);
+
 /**
  * Lê os dados do BH1750 e preenche a estrutura bh1750_dados.
  * Retorna true se a leitura foi bem-sucedida, false caso contrário.
  */
 bool bh1750_get_data(bh1750_dados *d);
 
+/**
+ * Lê a medição atual sem descartar valores: 0 lux (escuro) também vale.
+ * Retorna false só se o sensor não respondeu no I2C.
+ */
+bool bh1750_read(bh1750_dados *d);
+
 #endif // BH1750_H_
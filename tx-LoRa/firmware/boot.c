@@ -0,0 +1,180 @@
+// boot.c
+#include "boot.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+#include "bh1750.h"
+#include "lora_RFM95.h"
+#include "journal.h"
+#include "config.h"
+#include "log.h"
+#include "ticks.h"
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define TICKS_PER_US           (CONFIG_CLOCK_FREQUENCY / 1000000)
+
+#define BOOT_LORA_RESET_US     100   // RESET baixo mínimo (datasheet SX1276: 100 us)
+#define BOOT_LORA_READY_MS     5     // Após o reset manual o chip só aceita configuração depois de 5 ms
+#define BOOT_LORA_PROBE_MS     20    // Prazo para o chip responder após o reset
+
+typedef enum {
+    BOOT_PH_MAIN,
+    BOOT_PH_CONFIG,
+    BOOT_PH_I2C,
+    BOOT_PH_BH1750_START,
+    BOOT_PH_LORA_RESET,
+    BOOT_PH_LORA_PROBE,
+    BOOT_PH_LORA_CONFIG,
+    BOOT_PH_BH1750_DATA,
+    BOOT_PH_JOURNAL,
+    BOOT_PH_DONE,
+    BOOT_PH_FIRST_TX,
+    BOOT_PH_COUNT
+} boot_phase_t;
+
+static const char * const boot_phase_names[BOOT_PH_COUNT] = {
+    "main()",
+    "config carregada",
+    "I2C pronto",
+    "BH1750 conversao iniciada",
+    "LoRa reset liberado",
+    "LoRa respondeu",
+    "LoRa configurado",
+    "BH1750 primeira leitura",
+    "journal recuperado",
+    "boot concluido",
+    "primeiro TX (TxDone)",
+};
+
+static uint64_t boot_ticks[BOOT_PH_COUNT]; // 0 = fase não alcançada
+
+static inline void boot_mark(boot_phase_t ph) {
+    boot_ticks[ph] = ticks_now();
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+void boot_begin(void) {
+    boot_mark(BOOT_PH_MAIN);
+}
+
+void boot_run(void) {
+    bh1750_dados first;
+    bool bh_ok, lora_ok, journal_ok = false;
+
+    // Parâmetros do rádio/sensor: leitura mapeada da flash, antes de tudo
+    config_load();
+    boot_mark(BOOT_PH_CONFIG);
+
+    i2c_init();
+    boot_mark(BOOT_PH_I2C);
+
+#ifdef CSR_TIMER0_UPTIME_CYCLES_ADDR
+    enum { LORA_RESET, LORA_PROBE, LORA_READY, LORA_DONE } lora_st = LORA_RESET;
+    enum { BH_WAIT, BH_DONE } bh_st = BH_WAIT;
+    uint64_t now, lora_next, lora_released = 0, lora_deadline = 0, bh_ready;
+
+    // Dispara as duas esperas longas: conversão do BH1750 (~180 ms) e reset do rádio
+    bh_ok = bh1750_start() == 0;
+    boot_mark(BOOT_PH_BH1750_START);
+    if (!bh_ok) bh_st = BH_DONE;
+    // A leitura só vale depois de uma conversão completa: 0 lux é uma medida válida no escuro
+    bh_ready = ticks_now() + (uint64_t)BH1750_MEAS_TIME_MS * 1000 * TICKS_PER_US;
+
+    lora_ok = false;
+    lora_reset_begin();
+    lora_next = ticks_now() + BOOT_LORA_RESET_US * TICKS_PER_US;
+
+    while (lora_st != LORA_DONE || bh_st != BH_DONE || !journal_ok) {
+        now = ticks_now();
+
+        switch (lora_st) {
+        case LORA_RESET:
+            if (now < lora_next) break;
+            lora_reset_end();
+            boot_mark(BOOT_PH_LORA_RESET);
+            lora_released = now;
+            lora_deadline = now + (uint64_t)BOOT_LORA_PROBE_MS * 1000 * TICKS_PER_US;
+            lora_st = LORA_PROBE;
+            break;
+        case LORA_PROBE:
+            // A versão pode responder antes do chip aceitar configuração: sondar já
+            // detecta um rádio ausente cedo, mas a configuração espera os 5 ms
+            if (lora_probe()) {
+                boot_mark(BOOT_PH_LORA_PROBE);
+                lora_next = lora_released + (uint64_t)BOOT_LORA_READY_MS * 1000 * TICKS_PER_US;
+                lora_st = LORA_READY;
+            } else if (now >= lora_deadline) {
+                LOG_E(LORA_VERSION_FAIL, lora_read_reg(0x42));
+                lora_st = LORA_DONE;
+            }
+            break;
+        case LORA_READY:
+            if (now < lora_next) break;
+            lora_configure();
+            boot_mark(BOOT_PH_LORA_CONFIG);
+            lora_ok = true;
+            lora_st = LORA_DONE;
+            break;
+        default:
+            // Rádio pronto: recupera o journal enquanto o BH1750 converte
+            if (!journal_ok) {
+                journal_init();
+                boot_mark(BOOT_PH_JOURNAL);
+                journal_ok = true;
+            }
+            break;
+        }
+
+        if (bh_st == BH_WAIT && now >= bh_ready) {
+            bh_ok = bh1750_read(&first); // Só falha sem ACK do sensor
+            if (bh_ok) boot_mark(BOOT_PH_BH1750_DATA);
+            bh_st = BH_DONE;
+        }
+    }
+#else
+    // Sem contador de ciclos não há como medir prazos: sequência bloqueante
+    bh_ok = bh1750_init() == 0 && bh1750_read(&first);
+    lora_ok = lora_init();
+    journal_init();
+    boot_mark(BOOT_PH_JOURNAL);
+#endif
+
+    boot_mark(BOOT_PH_DONE);
+
+    printf(bh_ok ? "BH1750 inicializado com sucesso.\n" : "Falha ao inicializar BH1750.\n");
+    printf(lora_ok ? "LoRa inicializado com sucesso.\n" : "Falha ao inicializar LoRa.\n");
+
+#if BOOT_FIRST_TX
+    if (bh_ok) {
+        bool sent = lora_ok && lora_send_bytes((uint8_t*)&first, sizeof(first));
+        if (sent) boot_mark(BOOT_PH_FIRST_TX);
+        journal_append(first.luminosidade, sent);
+    }
+#endif
+}
+
+void boot_print_report(void) {
+    uint64_t first_tx = lora_first_txdone_ticks();
+
+    printf("Fases do boot (desde o reset):\n");
+    for (int i = 0; i < BOOT_PH_COUNT; i++) {
+        if (boot_ticks[i])
+            printf("  %-26s %9lu us\n", boot_phase_names[i], (unsigned long)ticks_to_us(boot_ticks[i]));
+        else
+            printf("  %-26s %9s\n", boot_phase_names[i], "-");
+    }
+    if (boot_ticks[BOOT_PH_MAIN] && boot_ticks[BOOT_PH_DONE])
+        printf("  main() -> boot concluido:  %9lu us\n",
+               (unsigned long)ticks_to_us(boot_ticks[BOOT_PH_DONE] - boot_ticks[BOOT_PH_MAIN]));
+    if (first_tx)
+        printf("  reset -> primeiro TX:      %9lu us\n", (unsigned long)ticks_to_us(first_tx));
+}
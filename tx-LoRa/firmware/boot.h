@@ -0,0 +1,36 @@
+// boot.h
+#ifndef BOOT_H_
+#define BOOT_H_
+
+#include <stdbool.h>
+
+// ============================================
+// === Orquestrador do boot ===
+// ============================================
+//
+// Inicia a conversão do BH1750 e o reset/configuração do LoRa ao mesmo tempo,
+// trocando esperas fixas por polling com prazo. Cada fase tem seu instante
+// registrado (ciclos desde o reset) e pode ser consultada com `boot_info`.
+
+// Envia a primeira amostra assim que sensor e rádio ficam prontos
+#ifndef BOOT_FIRST_TX
+#define BOOT_FIRST_TX 1
+#endif
+
+/**
+ * @brief Registra a entrada em main(); deve ser a primeira chamada.
+ */
+void boot_begin(void);
+
+/**
+ * @brief Inicializa I2C, BH1750 e LoRa em paralelo e (opcional) envia a primeira amostra.
+ * Chamar após uart_init().
+ */
+void boot_run(void);
+
+/**
+ * @brief Imprime os tempos de cada fase do boot.
+ */
+void boot_print_report(void);
+
+#endif // BOOT_H_
@@ -0,0 +1,250 @@
+// config.c
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <generated/csr.h>
+#include <generated/mem.h>
+#include <system.h>       // flush_cpu_dcache
+#include <crc.h>
+
+#include "flash_layout.h"
+
+#if defined(CSR_SPIFLASH_MASTER_CS_ADDR) || defined(CSR_SPIFLASH_CORE_MASTER_CS_ADDR)
+#include <liblitespi/spiflash.h>
+#define CONFIG_HAS_FLASH 1
+#endif
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define SLOTS_PER_SECTOR  (FLASH_SECTOR_SIZE / CONFIG_SLOT_SIZE)
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;     // CONFIG_MAGIC (0xFFFFFFFF = slot livre)
+    uint16_t version;   // CONFIG_VERSION de quem gravou
+    uint16_t count;     // Pares chave/valor a seguir
+    uint16_t crc;       // CRC16 do bloco inteiro com este campo em 0
+    uint16_t reserved;
+} config_hdr_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t key;
+    uint16_t reserved;
+    uint32_t value;
+} config_pair_t;
+
+#define MAX_PAIRS ((CONFIG_SLOT_SIZE - sizeof(config_hdr_t)) / sizeof(config_pair_t))
+
+typedef struct {
+    uint16_t id;
+    const char *name;
+    uint16_t offset;
+    uint32_t min, max, def;
+    uint8_t apply;
+} config_key_t;
+
+#define CONFIG_KEY_ENTRY(id, field, name, min, max, def, apply) \
+    { id, name, offsetof(config_t, field), min, max, def, apply },
+static const config_key_t keys[] = { CONFIG_KEYS(CONFIG_KEY_ENTRY) };
+#undef CONFIG_KEY_ENTRY
+
+#define NUM_KEYS (sizeof(keys) / sizeof(keys[0]))
+
+_Static_assert(NUM_KEYS <= MAX_PAIRS, "config nao cabe em um slot");
+
+// Larguras de banda do SX1276, na ordem do código de RegModemConfig1
+static const uint32_t bw_table[] = {
+    7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000
+};
+
+// ============================================
+// === Estado ===
+// ============================================
+
+config_t config;
+
+static int  loaded_slot = -1;   // Slot lido no boot (-1 = padrões)
+static bool dirty = false;      // Alterações não salvas
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static inline uint32_t *field_ptr(const config_key_t *k) {
+    return (uint32_t *)((uint8_t *)&config + k->offset);
+}
+
+static const config_key_t *find_key(const char *name) {
+    for (size_t i = 0; i < NUM_KEYS; i++)
+        if (strcmp(keys[i].name, name) == 0) return &keys[i];
+    return NULL;
+}
+
+static const config_key_t *find_id(uint16_t id) {
+    for (size_t i = 0; i < NUM_KEYS; i++)
+        if (keys[i].id == id) return &keys[i];
+    return NULL;
+}
+
+static bool value_ok(const config_key_t *k, uint32_t v) {
+    if (v < k->min || v > k->max) return false;
+    if (k->offset == offsetof(config_t, lora_bw_hz)) return config_lora_bw_code(v) >= 0;
+    return true;
+}
+
+static uint16_t block_crc(uint8_t *blk, size_t len) {
+    config_hdr_t *h = (config_hdr_t *)blk;
+    uint16_t saved = h->crc, crc;
+
+    h->crc = 0;
+    crc = crc16(blk, (int)len);
+    h->crc = saved;
+    return crc;
+}
+
+#ifdef CONFIG_HAS_FLASH
+static inline const uint8_t *slot_ptr(int slot) {
+    return (const uint8_t *)(SPIFLASH_BASE + FLASH_CONFIG_OFFSET + slot * CONFIG_SLOT_SIZE);
+}
+
+// Copia o slot para blk e confere magic, tamanho e CRC; retorna o tamanho ou 0
+static size_t slot_read(int slot, uint8_t *blk) {
+    config_hdr_t h;
+    size_t len;
+
+    memcpy(&h, slot_ptr(slot), sizeof(h));
+    if (h.magic != CONFIG_MAGIC || h.count > MAX_PAIRS) return 0;
+    len = sizeof(h) + h.count * sizeof(config_pair_t);
+    memcpy(blk, slot_ptr(slot), len);
+    return block_crc(blk, len) == h.crc ? len : 0;
+}
+#endif
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+int config_lora_bw_code(uint32_t bw_hz) {
+    for (size_t i = 0; i < sizeof(bw_table) / sizeof(bw_table[0]); i++)
+        if (bw_table[i] == bw_hz) return (int)i;
+    return -1;
+}
+
+bool config_load(void) {
+    for (size_t i = 0; i < NUM_KEYS; i++) *field_ptr(&keys[i]) = keys[i].def;
+    loaded_slot = -1;
+    dirty = false;
+
+#ifdef CONFIG_HAS_FLASH
+    uint8_t blk[CONFIG_SLOT_SIZE];
+    const config_hdr_t *h = (const config_hdr_t *)blk;
+    const config_pair_t *p = (const config_pair_t *)(blk + sizeof(config_hdr_t));
+    int last = -1;
+
+    // Slots gravados em ordem: para no primeiro livre; vale o último válido
+    for (int s = 0; s < SLOTS_PER_SECTOR; s++) {
+        uint32_t magic;
+        memcpy(&magic, slot_ptr(s), sizeof(magic));
+        if (magic == 0xFFFFFFFFu) break;
+        if (slot_read(s, blk)) last = s;
+    }
+    if (last < 0) return false;
+
+    slot_read(last, blk);
+    for (uint16_t i = 0; i < h->count; i++) {
+        const config_key_t *k = find_id(p[i].key);
+        if (k && value_ok(k, p[i].value)) *field_ptr(k) = p[i].value;
+    }
+    loaded_slot = last;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool config_save(void) {
+#ifdef CONFIG_HAS_FLASH
+    uint8_t blk[CONFIG_SLOT_SIZE];
+    config_hdr_t *h = (config_hdr_t *)blk;
+    config_pair_t *p = (config_pair_t *)(blk + sizeof(config_hdr_t));
+    size_t len = sizeof(config_hdr_t) + NUM_KEYS * sizeof(config_pair_t);
+    int slot = -1;
+
+    h->magic = CONFIG_MAGIC;
+    h->version = CONFIG_VERSION;
+    h->count = NUM_KEYS;
+    h->reserved = 0xFFFF;
+    for (size_t i = 0; i < NUM_KEYS; i++) {
+        p[i].key = keys[i].id;
+        p[i].reserved = 0xFFFF;
+        p[i].value = *field_ptr(&keys[i]);
+    }
+    h->crc = block_crc(blk, len);
+
+    for (int s = 0; s < SLOTS_PER_SECTOR; s++) {
+        uint32_t magic;
+        memcpy(&magic, slot_ptr(s), sizeof(magic));
+        if (magic == 0xFFFFFFFFu) { slot = s; break; }
+    }
+    // Setor cheio: só então apaga (o bloco anterior vale até aqui)
+    if (slot < 0) {
+        spiflash_erase_range(FLASH_CONFIG_OFFSET, FLASH_SECTOR_SIZE);
+        slot = 0;
+    }
+
+    spiflash_write_stream(FLASH_CONFIG_OFFSET + slot * CONFIG_SLOT_SIZE, blk, len);
+    flush_cpu_dcache();
+    if (memcmp(slot_ptr(slot), blk, len) != 0) return false;
+
+    loaded_slot = slot;
+    dirty = false;
+    return true;
+#else
+    return false;
+#endif
+}
+
+int config_set(const char *name, uint32_t value) {
+    const config_key_t *k = find_key(name);
+
+    if (!k) return CONFIG_ERR_KEY;
+    if (!value_ok(k, value)) return CONFIG_ERR_RANGE;
+    if (*field_ptr(k) != value) {
+        *field_ptr(k) = value;
+        dirty = true;
+    }
+    return k->apply;
+}
+
+bool config_get(const char *name, uint32_t *value) {
+    const config_key_t *k = find_key(name);
+
+    if (!k) return false;
+    *value = *field_ptr(k);
+    return true;
+}
+
+bool config_range(const char *name, uint32_t *min, uint32_t *max) {
+    const config_key_t *k = find_key(name);
+
+    if (!k) return false;
+    *min = k->min;
+    *max = k->max;
+    return true;
+}
+
+void config_print(void) {
+    for (size_t i = 0; i < NUM_KEYS; i++) {
+        uint32_t v = *field_ptr(&keys[i]);
+        printf("  %-14s = %-10lu (padrao %lu, faixa %lu..%lu)%s\n", keys[i].name,
+               (unsigned long)v, (unsigned long)keys[i].def,
+               (unsigned long)keys[i].min, (unsigned long)keys[i].max,
+               v != keys[i].def ? " *" : "");
+    }
+    if (loaded_slot >= 0) printf("Origem: flash (slot %d)", loaded_slot);
+    else printf("Origem: padroes do firmware");
+    printf("%s\n", dirty ? ", com alteracoes nao salvas ('save')" : "");
+}
@@ -0,0 +1,98 @@
+// config.h
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================
+// === Configuração persistente ===
+// ============================================
+//
+// Parâmetros do rádio e do sensor, carregados da flash (FLASH_CONFIG_OFFSET)
+// uma vez no boot para a struct `config` e editáveis pelo console
+// (`set`, `get`, `save`).
+//
+// Na flash, cada gravação é um bloco versionado de pares chave/valor com CRC16,
+// escrito no próximo slot livre de 256 bytes do setor; o último bloco válido
+// vale. Chaves desconhecidas são ignoradas e as ausentes ficam no padrão, então
+// firmwares novos leem blocos antigos (e vice-versa).
+
+#define CONFIG_MAGIC          0x4746434Cu // "LCFG"
+#define CONFIG_VERSION        1
+#define CONFIG_SLOT_SIZE      256
+
+// O que precisa ser reaplicado quando a chave muda
+#define CONFIG_APPLY_NONE     0x00
+#define CONFIG_APPLY_LORA     0x01 // lora_configure()
+#define CONFIG_APPLY_BH1750   0x02 // bh1750_start()
+
+// X(id, campo, "nome", mínimo, máximo, padrão, aplicar)
+// O id é gravado na flash: não reutilize ids; acrescente no fim.
+#define CONFIG_KEYS(X) \
+    X(1, lora_freq_hz,     "lora.freq",     137000000, 1020000000, 915000000, CONFIG_APPLY_LORA)   \
+    X(2, lora_bw_hz,       "lora.bw",       7800,      500000,     125000,    CONFIG_APPLY_LORA)   \
+    X(3, lora_sf,          "lora.sf",       7,         12,         12,        CONFIG_APPLY_LORA)   \
+    X(4, lora_cr,          "lora.cr",       5,         8,          8,         CONFIG_APPLY_LORA)   \
+    X(5, lora_power_dbm,   "lora.power",    2,         20,         20,        CONFIG_APPLY_LORA)   \
+    X(6, lora_preamble,    "lora.preamble", 6,         65535,      12,        CONFIG_APPLY_LORA)   \
+    X(7, lora_sync_word,   "lora.sync",     0,         0xFF,       0x12,      CONFIG_APPLY_LORA)   \
+    X(8, sample_period_ms, "sample.period", 0,         3600000,    1000,      CONFIG_APPLY_NONE)   \
+    X(9, bh1750_addr,      "bh1750.addr",   0x08,      0x77,       0x23,      CONFIG_APPLY_BH1750)
+
+#define CONFIG_FIELD(id, field, name, min, max, def, apply) uint32_t field;
+typedef struct { CONFIG_KEYS(CONFIG_FIELD) } config_t;
+#undef CONFIG_FIELD
+
+// Erros de config_set()
+#define CONFIG_ERR_KEY        -1 // Chave desconhecida
+#define CONFIG_ERR_RANGE      -2 // Valor fora da faixa (ou banda inválida)
+
+extern config_t config;
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+/**
+ * @brief Carrega os padrões e sobrepõe o último bloco válido da flash.
+ * @return true se um bloco foi lido da flash.
+ */
+bool config_load(void);
+
+/**
+ * @brief Grava a configuração atual no próximo slot livre (apaga o setor se cheio).
+ * @return true se o bloco foi gravado e conferido.
+ */
+bool config_save(void);
+
+/**
+ * @brief Altera uma chave na RAM (use config_save() para persistir).
+ * @return Máscara CONFIG_APPLY_* a reaplicar, ou CONFIG_ERR_*.
+ */
+int config_set(const char *name, uint32_t value);
+
+/**
+ * @brief Lê uma chave pelo nome.
+ * @return false se a chave não existe.
+ */
+bool config_get(const char *name, uint32_t *value);
+
+/**
+ * @brief Faixa aceita por uma chave (a mesma que config_set() confere).
+ * @return false se a chave não existe.
+ */
+bool config_range(const char *name, uint32_t *min, uint32_t *max);
+
+/**
+ * @brief Lista todas as chaves com valor atual e padrão.
+ */
+void config_print(void);
+
+/**
+ * @brief Código de banda do SX1276 (RegModemConfig1[7:4]) para a largura em Hz.
+ * @return 0..9, ou -1 se a largura não é suportada.
+ */
+int config_lora_bw_code(uint32_t bw_hz);
+
+#endif // CONFIG_H_
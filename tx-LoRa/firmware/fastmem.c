@@ -0,0 +1,16 @@
+// fastmem.c
+#include "fastmem.h"
+
+#include <string.h>
+#include <system.h> // flush_cpu_icache, flush_cpu_dcache
+
+// Símbolos definidos em linker.ld
+extern char _ffasttext[], _efasttext[], _ffasttext_rom[];
+extern char _ffastdata[], _efastdata[], _ffastdata_rom[];
+
+void fastmem_init(void) {
+    memcpy(_ffasttext, _ffasttext_rom, (size_t)(_efasttext - _ffasttext));
+    memcpy(_ffastdata, _ffastdata_rom, (size_t)(_efastdata - _ffastdata));
+    flush_cpu_dcache();
+    flush_cpu_icache();
+}
@@ -0,0 +1,27 @@
+// fastmem.h
+#ifndef FASTMEM_H_
+#define FASTMEM_H_
+
+// ============================================
+// === Código/dados na SRAM interna ===
+// ============================================
+//
+// .text/.rodata ficam na SDRAM (main_ram), atrás de um L2 de 8 KB; a latência
+// de busca de instrução varia com o cache. Funções marcadas com FAST_TEXT são
+// ligadas em .fasttext (VMA na sram, LMA na main_ram) e copiadas para a SRAM
+// por fastmem_init(); FAST_DATA faz o mesmo para dados inicializados.
+// O orçamento da SRAM é verificado no linker.ld e exibido por `make size`.
+// SDRAM_BSS vai no sentido oposto: buffers grandes, sem valor inicial, na
+// main_ram (a .bss comum fica na sram de 8 KB).
+
+#define FAST_TEXT __attribute__((section(".fasttext"), noinline))
+#define FAST_DATA __attribute__((section(".fastdata")))
+#define SDRAM_BSS __attribute__((section(".sdram_bss")))
+
+/**
+ * @brief Copia .fasttext/.fastdata para a SRAM e invalida o cache de instruções.
+ * Deve ser a primeira chamada de main(), antes de qualquer função FAST_TEXT.
+ */
+void fastmem_init(void);
+
+#endif // FASTMEM_H_
@@ -0,0 +1,58 @@
+// flash_layout.h
+#ifndef FLASH_LAYOUT_H_
+#define FLASH_LAYOUT_H_
+
+#include <generated/soc.h>
+
+// ============================================
+// === Mapa da flash SPI ===
+// ============================================
+//
+// Offsets relativos ao início da flash (os mesmos usados por liblitespi e
+// openFPGALoader). Para ler pelo barramento, some SPIFLASH_BASE.
+//
+//   i9 (W25Q64, 8 MB)                 i5 (GD25Q16, 2 MB)
+//   0x000000  bitstream do FPGA       0x000000  bitstream do FPGA
+//   0x200000  firmware (main.fbi)     0x100000  firmware (main.fbi)
+//   0x400000  journal de amostras     fim - 4K  configuração
+//   fim - 4K  configuração
+//
+// O offset do firmware é o --flash-boot-offset do colorlight_i5.py e o
+// FLASH_OFFSET do Makefile; os padrões dos três seguem a placa.
+
+#ifndef SPIFLASH_MODULE_TOTAL_SIZE
+#define SPIFLASH_MODULE_TOTAL_SIZE  (8 * 1024 * 1024)
+#endif
+#ifndef SPIFLASH_MODULE_PAGE_SIZE
+#define SPIFLASH_MODULE_PAGE_SIZE   256
+#endif
+
+#define FLASH_SECTOR_SIZE           4096 // Menor unidade de apagamento
+#define FLASH_PAGE_SIZE             SPIFLASH_MODULE_PAGE_SIZE
+
+#define FLASH_CONFIG_OFFSET         (SPIFLASH_MODULE_TOTAL_SIZE - FLASH_SECTOR_SIZE)
+
+#if SPIFLASH_MODULE_TOTAL_SIZE > 0x200000
+#define FLASH_FIRMWARE_OFFSET       0x200000
+#define FLASH_FIRMWARE_MAX_SIZE     0x200000
+#else
+#define FLASH_FIRMWARE_OFFSET       0x100000
+#define FLASH_FIRMWARE_MAX_SIZE     (FLASH_CONFIG_OFFSET - FLASH_FIRMWARE_OFFSET)
+#endif
+
+#define FLASH_JOURNAL_OFFSET        (FLASH_FIRMWARE_OFFSET + FLASH_FIRMWARE_MAX_SIZE)
+#define FLASH_JOURNAL_MIN_SIZE      (2 * FLASH_SECTOR_SIZE) // A rotação precisa de dois setores
+
+// Flash menor (p.ex. GD25Q16, 2 MB): não sobra região para o journal, que é
+// compilado como stub (journal.c) em vez de invadir firmware e configuração
+#if FLASH_CONFIG_OFFSET >= FLASH_JOURNAL_OFFSET + FLASH_JOURNAL_MIN_SIZE
+#define FLASH_JOURNAL_ENABLED       1
+#define FLASH_JOURNAL_SIZE          (FLASH_CONFIG_OFFSET - FLASH_JOURNAL_OFFSET)
+#else
+#define FLASH_JOURNAL_ENABLED       0
+#define FLASH_JOURNAL_SIZE          0
+#endif
+
+_Static_assert(FLASH_JOURNAL_SIZE % FLASH_SECTOR_SIZE == 0, "journal deve ocupar setores inteiros");
+
+#endif // FLASH_LAYOUT_H_
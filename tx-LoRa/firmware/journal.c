@@ -0,0 +1,420 @@
+// journal.c
+#include "journal.h"
+
+#include <string.h>
+#include <stddef.h>
+#include <generated/csr.h>
+#include <generated/mem.h>
+#include <generated/soc.h>
+#include <system.h>       // flush_cpu_dcache
+#include <crc.h>
+
+#include "flash_layout.h"
+#include "bh1750.h"
+#include "lora_RFM95.h"
+#include "log.h"
+#include "ticks.h"
+
+#if (defined(CSR_SPIFLASH_MASTER_CS_ADDR) || defined(CSR_SPIFLASH_CORE_MASTER_CS_ADDR)) && FLASH_JOURNAL_ENABLED
+#include <liblitespi/spiflash.h>
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define TICKS_PER_MS       (CONFIG_CLOCK_FREQUENCY / 1000)
+
+#define SLOT_SIZE          16
+#define SLOTS_PER_SECTOR   (FLASH_SECTOR_SIZE / SLOT_SIZE) // Slot 0 = cabeçalho
+#define NUM_SECTORS        (FLASH_JOURNAL_SIZE / FLASH_SECTOR_SIZE)
+#define NO_PAGE            0xFFFFFFFFu
+
+_Static_assert(sizeof(journal_sector_hdr_t) == SLOT_SIZE, "cabecalho deve ocupar um slot");
+_Static_assert(sizeof(journal_rec_t) == SLOT_SIZE, "registro deve ocupar um slot");
+_Static_assert(FLASH_PAGE_SIZE % SLOT_SIZE == 0, "pagina deve conter slots inteiros");
+
+// ============================================
+// === Estado Interno ===
+// ============================================
+
+static journal_stats_t st;
+
+static uint32_t head_seq;          // Sequência do setor da cabeça
+static uint32_t rec_seq;           // Sequência do próximo registro
+static uint32_t pend_total;        // Pendentes acrescentados desde a formatação
+static uint64_t next_drain;
+
+// Página em RAM: bytes [pend_lo, pend_hi) ainda não foram gravados
+static uint8_t  page_buf[FLASH_PAGE_SIZE];
+static uint32_t page_addr = NO_PAGE;
+static uint32_t pend_lo, pend_hi;
+static uint64_t pend_since;
+
+// ============================================
+// === Acesso à flash ===
+// ============================================
+
+static inline uint32_t slot_addr(uint32_t sector, uint32_t slot) {
+    return FLASH_JOURNAL_OFFSET + sector * FLASH_SECTOR_SIZE + slot * SLOT_SIZE;
+}
+
+static inline bool in_page_buf(uint32_t addr) {
+    return page_addr != NO_PAGE && addr >= page_addr + pend_lo && addr < page_addr + pend_hi;
+}
+
+// Leitura mapeada em memória; a parte ainda em RAM vem de page_buf
+static void flash_read(uint32_t addr, void *dst, size_t len) {
+    if (in_page_buf(addr)) memcpy(dst, &page_buf[addr - page_addr], len);
+    else memcpy(dst, (const void *)(SPIFLASH_BASE + addr), len);
+}
+
+static void flash_program(uint32_t addr, const void *src, uint32_t len) {
+    if (spiflash_write_stream(addr, (uint8_t *)src, len) != 0) {
+        st.errors++;
+        LOG_E(JOURNAL_WRITE_FAIL, addr);
+    }
+    flush_cpu_dcache(); // A região da flash passa pelo cache de dados
+}
+
+static void flash_erase_sector(uint32_t sector) {
+    spiflash_erase_range(slot_addr(sector, 0), FLASH_SECTOR_SIZE);
+    flush_cpu_dcache();
+}
+
+// ============================================
+// === Setores e registros ===
+// ============================================
+
+static uint16_t hdr_crc(const journal_sector_hdr_t *h) {
+    return crc16((const unsigned char *)h, offsetof(journal_sector_hdr_t, drained));
+}
+
+static uint16_t rec_crc(const journal_rec_t *r) {
+    return crc16((const unsigned char *)&r->luminosidade,
+                 offsetof(journal_rec_t, crc) - offsetof(journal_rec_t, luminosidade));
+}
+
+static bool hdr_read(uint32_t sector, journal_sector_hdr_t *h) {
+    flash_read(slot_addr(sector, 0), h, sizeof(*h));
+    return h->magic == JOURNAL_MAGIC && h->version == JOURNAL_VERSION && h->crc == hdr_crc(h);
+}
+
+static void hdr_write(uint32_t sector, uint32_t seq, uint32_t pend_base) {
+    journal_sector_hdr_t h;
+
+    memset(&h, 0xFF, sizeof(h));
+    h.magic = JOURNAL_MAGIC;
+    h.seq = seq;
+    h.pend_base = pend_base;
+    h.version = JOURNAL_VERSION;
+    h.crc = hdr_crc(&h);
+    flash_program(slot_addr(sector, 0), &h, sizeof(h));
+}
+
+static void mark_drained(uint32_t sector) {
+    journal_sector_hdr_t h;
+    static const uint8_t clear = JOURNAL_FLAG_CLEAR;
+
+    if (hdr_read(sector, &h) && h.drained != JOURNAL_FLAG_CLEAR)
+        flash_program(slot_addr(sector, 0) + offsetof(journal_sector_hdr_t, drained), &clear, 1);
+}
+
+static bool rec_read(uint32_t sector, uint32_t slot, journal_rec_t *r) {
+    flash_read(slot_addr(sector, slot), r, sizeof(*r));
+    return r->marker == JOURNAL_REC_MARKER && r->crc == rec_crc(r);
+}
+
+// Acumulado de pendentes até `r`: o setor tem no máximo 255 registros, então
+// os 16 bits do registro bastam sobre a base do cabeçalho
+static inline uint32_t rec_pend_total(const journal_sector_hdr_t *h, const journal_rec_t *r) {
+    return h->pend_base + (uint16_t)(r->pend_ord - (uint16_t)h->pend_base);
+}
+
+static inline bool rec_pending(uint32_t sector, uint32_t slot) {
+    journal_rec_t r;
+    return rec_read(sector, slot, &r) && r.sent != JOURNAL_FLAG_CLEAR;
+}
+
+static void mark_sent(uint32_t sector, uint32_t slot) {
+    static const uint8_t clear = JOURNAL_FLAG_CLEAR;
+    uint32_t addr = slot_addr(sector, slot) + offsetof(journal_rec_t, sent);
+
+    if (in_page_buf(addr)) page_buf[addr - page_addr] = JOURNAL_FLAG_CLEAR;
+    else flash_program(addr, &clear, 1);
+}
+
+static inline bool tail_at_head(void) {
+    return st.tail_sector == st.head_sector && st.tail_slot == st.head_slot;
+}
+
+// Avança a cauda até o próximo pendente (ou até a cabeça), marcando os
+// setores deixados para trás como drenados
+static void tail_skip_sent(void) {
+    while (!tail_at_head()) {
+        if (st.tail_slot >= SLOTS_PER_SECTOR) {
+            mark_drained(st.tail_sector);
+            st.tail_sector = (st.tail_sector + 1) % NUM_SECTORS;
+            st.tail_slot = 1;
+            continue;
+        }
+        if (rec_pending(st.tail_sector, st.tail_slot)) return;
+        st.tail_slot++;
+    }
+}
+
+// Setor da cabeça cheio: apaga o próximo (descartando pendentes, se for o da cauda)
+static void rotate(void) {
+    uint32_t next = (st.head_sector + 1) % NUM_SECTORS;
+    uint32_t lost = 0;
+
+    journal_flush();
+
+    if (st.pending && st.tail_sector == next) {
+        for (uint32_t s = st.tail_slot; s < SLOTS_PER_SECTOR; s++)
+            if (rec_pending(next, s)) lost++;
+        st.pending -= lost;
+        st.dropped += lost;
+        st.tail_sector = (next + 1) % NUM_SECTORS;
+        st.tail_slot = 1;
+        LOG_W(JOURNAL_DROPPED, lost, next);
+    }
+
+    flash_erase_sector(next);
+    hdr_write(next, ++head_seq, pend_total);
+    st.head_sector = next;
+    st.head_slot = 1;
+
+    if (st.pending == 0) {
+        // Todo setor atrás da cauda fica drenado (journal_init() busca a cauda por isso)
+        while (st.tail_sector != st.head_sector) {
+            mark_drained(st.tail_sector);
+            st.tail_sector = (st.tail_sector + 1) % NUM_SECTORS;
+        }
+        st.tail_slot = st.head_slot;
+    } else {
+        tail_skip_sent();
+    }
+}
+
+// Setores em uso formam uma sequência contígua (seq, seq+1, ...) a partir de `base`
+static bool in_run(uint32_t sector, uint32_t base, uint32_t base_seq) {
+    journal_sector_hdr_t h;
+    return hdr_read(sector, &h) && h.seq == base_seq + (sector - base);
+}
+
+// Setor `back` posições atrás da cabeça já foi deixado para trás pela cauda
+// (ou não é do anel atual). Vale para um prefixo do mais antigo até a cauda.
+static bool behind_tail(uint32_t back) {
+    journal_sector_hdr_t h;
+    uint32_t sector = (st.head_sector + NUM_SECTORS - back) % NUM_SECTORS;
+
+    if (back == 0) return false;
+    if (!hdr_read(sector, &h) || h.seq != head_seq - back) return true;
+    return h.drained == JOURNAL_FLAG_CLEAR;
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+void journal_init(void) {
+    journal_sector_hdr_t h;
+    journal_rec_t r;
+    uint64_t t0 = ticks_now();
+    uint32_t base, lo, hi, mid;
+
+    memset(&st, 0, sizeof(st));
+    st.sectors = NUM_SECTORS;
+    st.tx_ok = true;
+    page_addr = NO_PAGE;
+    pend_lo = pend_hi = 0;
+
+    // Setor de referência: 0, ou 1 se a rotação para o 0 foi interrompida
+    if (hdr_read(0, &h)) base = 0;
+    else if (hdr_read(1, &h)) base = 1;
+    else {
+        LOG_I(JOURNAL_FORMAT);
+        flash_erase_sector(0);
+        hdr_write(0, 0, 0);
+        head_seq = 0;
+        rec_seq = 0;
+        pend_total = 0;
+        st.head_slot = st.tail_slot = 1;
+        st.ready = true;
+        st.recovery_us = ticks_to_us(ticks_now() - t0);
+        return;
+    }
+
+    // Busca binária: último setor da sequência contígua iniciada em `base`
+    lo = base;
+    hi = NUM_SECTORS - 1;
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1) / 2;
+        if (in_run(mid, base, h.seq)) lo = mid;
+        else hi = mid - 1;
+    }
+    st.head_sector = lo;
+    hdr_read(lo, &h);
+    head_seq = h.seq;
+
+    // Busca binária: primeiro slot livre do setor da cabeça (gravados em ordem)
+    lo = 1;
+    hi = SLOTS_PER_SECTOR;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        flash_read(slot_addr(st.head_sector, mid), &r, 1);
+        if (r.marker == 0xFF) hi = mid;
+        else lo = mid + 1;
+    }
+    st.head_slot = lo;
+
+    // Sequência do próximo registro e acumulado de pendentes a partir do último
+    // registro íntegro do setor da cabeça (uma página interrompida pode deixar lixo)
+    pend_total = h.pend_base;
+    rec_seq = 0;
+    for (uint32_t slot = st.head_slot - 1; slot >= 1; slot--) {
+        if (rec_read(st.head_sector, slot, &r)) {
+            pend_total = rec_pend_total(&h, &r);
+            rec_seq = r.seq + 1;
+            break;
+        }
+    }
+    if (st.head_slot == 1 && rec_read((st.head_sector + NUM_SECTORS - 1) % NUM_SECTORS, SLOTS_PER_SECTOR - 1, &r))
+        rec_seq = r.seq + 1;
+
+    // Busca binária: setor da cauda, o primeiro depois dos já drenados
+    lo = 0;
+    hi = NUM_SECTORS - 1;
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1) / 2;
+        if (behind_tail(mid)) hi = mid - 1;
+        else lo = mid;
+    }
+    st.tail_sector = (st.head_sector + NUM_SECTORS - lo) % NUM_SECTORS;
+    st.tail_slot = 1;
+
+    // Primeiro pendente a partir dali (no máximo um setor de leituras)
+    tail_skip_sent();
+
+    // Pendentes = acumulado na cabeça - acumulado antes da cauda
+    if (!tail_at_head() && hdr_read(st.tail_sector, &h) && rec_read(st.tail_sector, st.tail_slot, &r))
+        st.pending = pend_total - (rec_pend_total(&h, &r) - 1);
+
+    st.ready = true;
+    if (st.head_slot >= SLOTS_PER_SECTOR) rotate();
+
+    st.recovery_us = ticks_to_us(ticks_now() - t0);
+    LOG_I(JOURNAL_RECOVERED, st.head_sector, st.head_slot, st.pending);
+}
+
+void journal_append(uint16_t luminosidade, bool sent) {
+    journal_rec_t r;
+    uint64_t now = ticks_now();
+    uint32_t addr, page;
+
+    if (!st.ready) return;
+
+    // Estado do rádio pelo TX ao vivo: ao voltar, o dreno começa já
+    if (sent) {
+        if (!st.tx_ok) next_drain = now;
+        st.tx_ok = true;
+    } else {
+        st.tx_ok = false;
+        next_drain = now + (uint64_t)JOURNAL_RETRY_MS * TICKS_PER_MS;
+    }
+
+    memset(&r, 0xFF, sizeof(r));
+    r.marker = JOURNAL_REC_MARKER;
+    r.sent = sent ? JOURNAL_FLAG_CLEAR : 0xFF;
+    r.luminosidade = luminosidade;
+    r.seq = rec_seq++;
+    r.timestamp_us = ticks_to_us(now);
+    r.pend_ord = (uint16_t)(sent ? pend_total : ++pend_total);
+    r.crc = rec_crc(&r);
+
+    addr = slot_addr(st.head_sector, st.head_slot);
+    page = addr & ~(uint32_t)(FLASH_PAGE_SIZE - 1);
+    if (page != page_addr) {
+        journal_flush();
+        page_addr = page;
+        pend_lo = pend_hi = addr - page;
+    }
+    if (pend_lo == pend_hi) pend_since = now;
+    memcpy(&page_buf[addr - page], &r, sizeof(r));
+    pend_hi += sizeof(r);
+
+    if (!sent && st.pending++ == 0) {
+        st.tail_sector = st.head_sector;
+        st.tail_slot = st.head_slot;
+    }
+    st.head_slot++;
+    if (st.pending == 0) st.tail_slot = st.head_slot;
+
+    // Página completa vai para a flash; setor completo roda na hora
+    if (pend_hi >= FLASH_PAGE_SIZE) journal_flush();
+    if (st.head_slot >= SLOTS_PER_SECTOR) rotate();
+}
+
+void journal_flush(void) {
+    if (page_addr == NO_PAGE || pend_hi <= pend_lo) return;
+    flash_program(page_addr + pend_lo, &page_buf[pend_lo], pend_hi - pend_lo);
+    pend_lo = pend_hi;
+}
+
+void journal_service(void) {
+    journal_rec_t r;
+    bh1750_dados luz;
+    uint64_t now;
+
+    if (!st.ready) return;
+    now = ticks_now();
+
+    if (pend_hi > pend_lo && now - pend_since >= (uint64_t)JOURNAL_FLUSH_MS * TICKS_PER_MS)
+        journal_flush();
+
+    if (st.pending == 0 || now < next_drain) return;
+
+    if (!rec_read(st.tail_sector, st.tail_slot, &r)) {
+        // Registro corrompido: não há o que reenviar
+        st.pending--;
+        st.tail_slot++;
+        tail_skip_sent();
+        return;
+    }
+
+    // Mesmo formato do envio ao vivo (o receptor só conhece bh1750_dados)
+    luz.luminosidade = r.luminosidade;
+    if (lora_send_bytes((uint8_t *)&luz, sizeof(luz))) {
+        mark_sent(st.tail_sector, st.tail_slot);
+        st.pending--;
+        st.resent++;
+        st.tx_ok = true;
+        st.tail_slot++;
+        tail_skip_sent();
+        LOG_I(JOURNAL_RESENT, r.seq, st.pending);
+        next_drain = ticks_now() + (uint64_t)JOURNAL_DRAIN_GAP_MS * TICKS_PER_MS;
+    } else {
+        st.tx_ok = false;
+        next_drain = ticks_now() + (uint64_t)JOURNAL_RETRY_MS * TICKS_PER_MS;
+    }
+}
+
+void journal_drain_now(void) {
+    next_drain = 0;
+}
+
+void journal_get_stats(journal_stats_t *out) {
+    *out = st;
+    out->buffered = (pend_hi - pend_lo) / SLOT_SIZE;
+}
+
+#else // Sem controlador da flash no gateware ou flash pequena demais: journal desativado
+
+void journal_init(void) {}
+void journal_append(uint16_t luminosidade, bool sent) { (void)luminosidade; (void)sent; }
+void journal_flush(void) {}
+void journal_service(void) {}
+void journal_drain_now(void) {}
+void journal_get_stats(journal_stats_t *out) { memset(out, 0, sizeof(*out)); }
+
+#endif
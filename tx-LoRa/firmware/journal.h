@@ -0,0 +1,117 @@
+// journal.h
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================
+// === Journal de amostras na flash ===
+// ============================================
+//
+// Log circular, só de acréscimo, na região FLASH_JOURNAL_* (flash_layout.h).
+// - Cada setor de 4 KB começa com um cabeçalho (número de sequência do setor)
+//   seguido de 255 registros de 16 bytes; os setores são usados em ordem e
+//   apagados só ao serem reaproveitados, o que distribui o desgaste.
+// - Os registros são agrupados em RAM e gravados uma página (256 B) por vez.
+// - O flag `sent` é limpo (1 -> 0, sem apagar) quando o registro é enviado.
+// - Cabeçalhos e registros guardam o total acumulado de pendentes; com ele, o
+//   boot acha cabeça e cauda por busca binária e conta os pendentes sem
+//   percorrer os registros entre as duas.
+// - Não há confirmação do receptor: "enviado" quer dizer TxDone no rádio local.
+//   O journal cobre falhas do rádio/TX deste lado (rádio ausente, timeout do
+//   TX); uma amostra transmitida com o receptor fora de alcance é dada como
+//   enviada e não volta para o dreno.
+
+#define JOURNAL_MAGIC            0x4C4E524Au // "JRNL"
+#define JOURNAL_VERSION          2
+#define JOURNAL_REC_MARKER       0x5A
+#define JOURNAL_FLAG_CLEAR       0x00        // Valor gravado em `sent`/`drained`
+
+#define JOURNAL_FLUSH_MS         10000 // Grava a página parcial após este tempo
+#define JOURNAL_RETRY_MS         30000 // Nova tentativa do dreno após falha de TX
+#define JOURNAL_DRAIN_GAP_MS     200   // Pausa entre reenvios (deixa o console rodar)
+
+/**
+ * Cabeçalho de setor (ocupa o primeiro slot de 16 bytes).
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;         // JOURNAL_MAGIC
+    uint32_t seq;           // Sequência do setor (cresce a cada rotação)
+    uint32_t pend_base;     // Pendentes acrescentados antes deste setor (acumulado)
+    uint8_t  version;       // JOURNAL_VERSION
+    uint8_t  drained;       // 0xFF; JOURNAL_FLAG_CLEAR quando a cauda passou do setor
+    uint16_t crc;           // CRC16 de magic..version
+} journal_sector_hdr_t;
+
+/**
+ * Registro de uma amostra.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  marker;        // JOURNAL_REC_MARKER (0xFF = slot livre)
+    uint8_t  sent;          // 0xFF = pendente; JOURNAL_FLAG_CLEAR = enviado
+    uint16_t luminosidade;  // lux * 100 (igual a bh1750_dados)
+    uint32_t seq;           // Sequência do registro (continua entre boots)
+    uint32_t timestamp_us;  // Instante da amostra desde o reset
+    uint16_t pend_ord;      // 16 bits baixos do acumulado de pendentes até este registro
+    uint16_t crc;           // CRC16 de luminosidade..pend_ord
+} journal_rec_t;
+
+/**
+ * Estado do journal (comando `journal`).
+ */
+typedef struct {
+    bool     ready;         // false sem flash ou antes de journal_init()
+    bool     tx_ok;         // Último TX local (ao vivo ou do dreno) teve TxDone
+    uint32_t head_sector;   // Setor e slot do próximo registro
+    uint32_t head_slot;
+    uint32_t tail_sector;   // Registro pendente mais antigo
+    uint32_t tail_slot;
+    uint32_t pending;       // Registros ainda não enviados
+    uint32_t buffered;      // Registros na página em RAM (não gravados)
+    uint32_t dropped;       // Pendentes perdidos ao reaproveitar um setor
+    uint32_t resent;        // Reenviados pelo dreno
+    uint32_t errors;        // Falhas de gravação na flash
+    uint32_t sectors;       // Setores da região do journal
+    uint32_t recovery_us;   // Duração de journal_init()
+} journal_stats_t;
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+/**
+ * @brief Recupera a cabeça e a cauda do journal na flash (ou formata se vazio).
+ */
+void journal_init(void);
+
+/**
+ * @brief Acrescenta uma amostra.
+ * @param luminosidade lux * 100.
+ * @param sent true se o TX da amostra terminou com TxDone; false a deixa para o dreno.
+ * Também informa o estado do rádio: um TX bem-sucedido depois de uma falha antecipa o dreno.
+ */
+void journal_append(uint16_t luminosidade, bool sent);
+
+/**
+ * @brief Grava na flash os registros ainda em RAM.
+ */
+void journal_flush(void);
+
+/**
+ * @brief Serviço do journal; chamar no loop principal.
+ * Grava a página parcial antiga e reenvia o pendente mais antigo quando o TX voltou a funcionar.
+ */
+void journal_service(void);
+
+/**
+ * @brief Força uma tentativa de reenvio na próxima chamada de journal_service().
+ */
+void journal_drain_now(void);
+
+/**
+ * @brief Preenche o estado atual do journal.
+ */
+void journal_get_stats(journal_stats_t *st);
+
+#endif // JOURNAL_H_
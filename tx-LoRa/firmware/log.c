@@ -0,0 +1,91 @@
+// log.c
+#include "log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry.h"
+#include "ticks.h"
+#include "fastmem.h"
+
+// ============================================
+// === Estado Interno ===
+// ============================================
+
+int log_level = LOG_LEVEL_MAX;
+
+static log_entry_t log_ring[LOG_RING_SIZE];
+static volatile uint32_t log_head = 0; // Próxima posição de escrita
+static volatile uint32_t log_tail = 0; // Próxima posição de leitura
+static uint32_t log_dropped = 0;
+
+#define LOG_FMT_ENTRY(id, fmt) fmt,
+static const char * const log_formats[LOG_ID_COUNT] = { LOG_MESSAGES(LOG_FMT_ENTRY) };
+#undef LOG_FMT_ENTRY
+
+static const char * const log_level_names[] = { "E", "W", "I", "D" };
+
+// ============================================
+// === Produtor (caminhos críticos) ===
+// ============================================
+
+FAST_TEXT void log_write(uint8_t level, uint16_t id, uint32_t a0, uint32_t a1, uint32_t a2) {
+    uint32_t head = log_head;
+    log_entry_t *e;
+
+    if (head - log_tail >= LOG_RING_SIZE) {
+        log_dropped++;
+        return;
+    }
+
+    e = &log_ring[head & (LOG_RING_SIZE - 1)];
+    e->cycles  = ticks_now32();
+    e->id      = id;
+    e->level   = level;
+    e->args[0] = a0;
+    e->args[1] = a1;
+    e->args[2] = a2;
+    log_head = head + 1;
+}
+
+// ============================================
+// === Consumidor (tempo ocioso) ===
+// ============================================
+
+static void log_emit(const log_entry_t *e, uint64_t now) {
+    // Reconstrói o instante de 64 bits a partir dos 32 bits baixos
+    uint64_t when = now - (uint32_t)((uint32_t)now - e->cycles);
+
+    if (telemetry_active()) {
+        telemetry_log_t rec;
+        rec.type = TELEM_TYPE_LOG;
+        rec.level = e->level;
+        rec.id = e->id;
+        rec.timestamp_us = ticks_to_us(when);
+        memcpy(rec.args, e->args, sizeof(rec.args));
+        telemetry_send_frame((const uint8_t*)&rec, sizeof(rec));
+        return;
+    }
+
+    if (e->id >= LOG_ID_COUNT) return;
+    printf("[%s] ", log_level_names[e->level & 3]);
+    printf(log_formats[e->id], e->args[0], e->args[1], e->args[2]);
+    printf("\n");
+}
+
+void log_service(unsigned int max_entries) {
+    uint64_t now = ticks_now();
+    unsigned int n = 0;
+
+    while (log_tail != log_head) {
+        if (max_entries && n++ >= max_entries) return;
+        log_emit(&log_ring[log_tail & (LOG_RING_SIZE - 1)], now);
+        log_tail = log_tail + 1;
+    }
+
+    if (log_dropped) {
+        log_entry_t e = { (uint32_t)now, LOG_LOG_OVERRUN, LOG_LVL_WARN, 0, { log_dropped, 0, 0 } };
+        log_dropped = 0;
+        log_emit(&e, now);
+    }
+}
@@ -0,0 +1,62 @@
+// log.h
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "log_ids.h"
+
+// ============================================
+// === Log binário com formatação adiada ===
+// ============================================
+//
+// LOG_I(LORA_TX_START, len) grava (ID, ciclos, argumentos) num ring buffer
+// em RAM; log_service() formata e imprime (ou envia como quadro binário
+// quando o stream de telemetria está ativo) fora dos caminhos críticos.
+
+#define LOG_LVL_ERROR 0
+#define LOG_LVL_WARN  1
+#define LOG_LVL_INFO  2
+#define LOG_LVL_DEBUG 3
+
+// Nível máximo compilado; chamadas acima dele não geram código
+#ifndef LOG_LEVEL_MAX
+#define LOG_LEVEL_MAX LOG_LVL_INFO
+#endif
+
+#define LOG_RING_SIZE 32 // Potência de 2
+
+typedef struct {
+    uint32_t cycles;   // 32 bits baixos de ticks_now()
+    uint16_t id;       // log_id_t
+    uint8_t  level;    // LOG_LVL_*
+    uint8_t  reserved;
+    uint32_t args[3];
+} log_entry_t;
+
+extern int log_level; // Nível em tempo de execução
+
+void log_write(uint8_t level, uint16_t id, uint32_t a0, uint32_t a1, uint32_t a2);
+
+// Completa com zeros até 3 argumentos (extensão GNU para ##__VA_ARGS__)
+#define LOG_ARGS_(d, a, b, c, ...) (uint32_t)(a), (uint32_t)(b), (uint32_t)(c)
+#define LOG_ARGS(...) LOG_ARGS_(0, ##__VA_ARGS__, 0, 0, 0)
+
+#define LOG_AT(lvl, id, ...) do { \
+        if ((lvl) <= LOG_LEVEL_MAX && (lvl) <= log_level) \
+            log_write((lvl), LOG_##id, LOG_ARGS(__VA_ARGS__)); \
+    } while (0)
+
+#define LOG_E(id, ...) LOG_AT(LOG_LVL_ERROR, id, ##__VA_ARGS__)
+#define LOG_W(id, ...) LOG_AT(LOG_LVL_WARN,  id, ##__VA_ARGS__)
+#define LOG_I(id, ...) LOG_AT(LOG_LVL_INFO,  id, ##__VA_ARGS__)
+#define LOG_D(id, ...) LOG_AT(LOG_LVL_DEBUG, id, ##__VA_ARGS__)
+
+/**
+ * @brief Drena até max_entries mensagens do ring (0 = todas).
+ * Chamar no loop principal (tempo ocioso).
+ */
+void log_service(unsigned int max_entries);
+
+#endif // LOG_H_
@@ -0,0 +1,34 @@
+// log_ids.h
+#ifndef LOG_IDS_H_
+#define LOG_IDS_H_
+
+// ============================================
+// === Tabela de mensagens do log ===
+// ============================================
+//
+// X(ID, "formato"): o firmware guarda só o ID e até 3 argumentos de 32 bits;
+// o texto é formatado no dreno (firmware) ou no host (telemetry_decode).
+// Use apenas conversões de 32 bits (%d, %u, %x, %02X...) nos formatos.
+// Não reordene: os IDs fazem parte do protocolo com o host; acrescente no fim.
+
+#define LOG_MESSAGES(X) \
+    X(LORA_VERSION_FAIL,  "Falha na comunicacao (versao=0x%02X)") \
+    X(LORA_MODEM_CONFIG,  "Modulacao: BW=%u Hz, SF=%u, CR=4/%u") \
+    X(LORA_BAD_LEN,       "Erro LoRa: Tamanho do pacote invalido (%d bytes)") \
+    X(LORA_TX_START,      "Enviando %d bytes via LoRa...") \
+    X(LORA_TX_DONE,       "Pacote enviado com sucesso! (%u ms)") \
+    X(LORA_TX_TIMEOUT,    "Erro: Timeout de TX! O radio foi resetado para Standby.") \
+    X(LOG_OVERRUN,        "Log: %u mensagens descartadas (buffer cheio)") \
+    X(LORA_WAKE_RESUME,   "LoRa acordou com a configuracao retida") \
+    X(LORA_WAKE_REINIT,   "LoRa perdeu a configuracao (soma 0x%04X, esperada 0x%04X); reprogramando") \
+    X(JOURNAL_FORMAT,     "Journal: regiao vazia, formatando") \
+    X(JOURNAL_RECOVERED,  "Journal: cabeca no setor %u slot %u, %u registros pendentes") \
+    X(JOURNAL_DROPPED,    "Journal: %u registros pendentes descartados (setor %u reaproveitado)") \
+    X(JOURNAL_RESENT,     "Journal: registro %u reenviado (%u pendentes)") \
+    X(JOURNAL_WRITE_FAIL, "Journal: falha de gravacao na flash em 0x%06X")
+
+#define LOG_ID_ENUM(id, fmt) LOG_##id,
+typedef enum { LOG_MESSAGES(LOG_ID_ENUM) LOG_ID_COUNT } log_id_t;
+#undef LOG_ID_ENUM
+
+#endif // LOG_IDS_H_
@@ -1,10 +1,16 @@
 // lora_RFM95.c
 #include "lora_RFM95.h"
 
-#include <stdio.h> // Para printf
 #include <string.h> // Para memcpy
 #include <generated/csr.h> // Para acesso aos registradores CSR do LiteX
 #include <system.h>       // Para busy_wait_us, busy_wait_ms
+#include <crc.h>          // crc16 da libbase (soma da configuração)
+
+#include "log.h"              // Log com formatação adiada (sem printf no caminho do rádio)
+#include "trace.h"
+#include "fastmem.h"              // FAST_TEXT: primitivas SPI executadas da SRAM
+#include "ticks.h"
+#include "config.h"            // Frequência, modulação e potência
 
 // ============================================
 // === Definições Internas ===
@@ -52,6 +58,20 @@
 #define IRQ_TX_DONE_MASK         0x08
 
 
+// Instante do primeiro TxDone (0 = nenhum pacote enviado)
+static uint64_t first_txdone = 0;
+
+// Registradores conferidos por lora_wake(): frequência, modem, PA e sync word.
+// Juntos, detectam um reset/brown-out do rádio (voltam aos valores de fábrica).
+static const uint8_t cfg_check_regs[] = {
+    REG_FRF_MSB, REG_FRF_MID, REG_FRF_LSB,
+    REG_MODEM_CONFIG_1, REG_MODEM_CONFIG_2, REG_MODEM_CONFIG_3,
+    REG_PA_CONFIG, REG_SYNC_WORD,
+};
+
+static uint16_t cfg_checksum = 0;      // Soma gravada por lora_configure()
+static bool     cfg_valid = false;     // false até a primeira configuração
+
 // ============================================
 // === Protótipos Internos (static) ===
 // ============================================
@@ -59,8 +79,9 @@ static void busy_wait_ms_local(unsigned int ms); // Cópia local da função de
 static void spi_master_init(void);
 static inline void spi_select(void);
 static inline void spi_deselect(void);
-static inline uint8_t spi_txrx(uint8_t tx_byte);
-static void lora_write_fifo(const uint8_t *data, uint8_t len);
+static FAST_TEXT uint8_t spi_txrx(uint8_t tx_byte);
+static FAST_TEXT void lora_write_fifo(const uint8_t *data, uint8_t len);
+static uint16_t lora_config_checksum(void);
 
 
 // ============================================
@@ -89,7 +110,6 @@ static void spi_master_init(void) {
     #ifdef CSR_SPI_LOOPBACK_ADDR
     spi_loopback_write(0);
     #endif
-    busy_wait_ms_local(1);
 }
 
 static inline void spi_select(void) {
@@ -104,9 +124,10 @@ static inline void spi_deselect(void) {
     busy_wait_us(2); // Pequeno delay para estabilidade
 }
 
-static inline uint8_t spi_txrx(uint8_t tx_byte) {
+static FAST_TEXT uint8_t spi_txrx(uint8_t tx_byte) {
     uint32_t rx_byte;
 
+    TRACE_BEGIN(SPI_TXRX, tx_byte);
     spi_mosi_write((uint32_t)tx_byte);
     spi_control_write(
         (1 << CSR_SPI_CONTROL_START_OFFSET) |
@@ -116,11 +137,12 @@ static inline uint8_t spi_txrx(uint8_t tx_byte) {
         /* Aguarda conclusão */
     }
     rx_byte = spi_miso_read();
+    TRACE_END(SPI_TXRX, rx_byte & 0xFF);
     return (uint8_t)(rx_byte & 0xFF);
 }
 
 
-static void lora_write_fifo(const uint8_t *data, uint8_t len) {
+static FAST_TEXT void lora_write_fifo(const uint8_t *data, uint8_t len) {
     spi_select();
     spi_txrx(REG_FIFO | 0x80); // Endereço FIFO com bit de escrita
     for (uint8_t i = 0; i < len; i++) {
@@ -129,12 +151,21 @@ static void lora_write_fifo(const uint8_t *data, uint8_t len) {
     spi_deselect();
 }
 
+// CRC16 dos registradores de configuração (legíveis também em SLEEP)
+static uint16_t lora_config_checksum(void) {
+    uint8_t vals[sizeof(cfg_check_regs)];
+    for (size_t i = 0; i < sizeof(cfg_check_regs); i++) {
+        vals[i] = lora_read_reg(cfg_check_regs[i]);
+    }
+    return crc16(vals, (int)sizeof(vals));
+}
+
 // ============================================
 // === Implementação das Funções Públicas ===
 // ============================================
 
 // Lê registrador (pública)
-uint8_t lora_read_reg(uint8_t reg) {
+FAST_TEXT uint8_t lora_read_reg(uint8_t reg) {
     uint8_t val;
     spi_select();
     spi_txrx(reg & 0x7F); // Endereço com bit de escrita em 0
@@ -144,7 +175,7 @@ uint8_t lora_read_reg(uint8_t reg) {
 }
 
 // Escreve registrador (pública)
-void lora_write_reg(uint8_t reg, uint8_t value) {
+FAST_TEXT void lora_write_reg(uint8_t reg, uint8_t value) {
     spi_select();
     spi_txrx(reg | 0x80); // Endereço com bit de escrita em 1
     spi_txrx(value);
@@ -154,44 +185,64 @@ void lora_write_reg(uint8_t reg, uint8_t value) {
 // Define modo (pública)
 void lora_set_mode(uint8_t mode) {
     // O bit 7 (LongRangeMode) deve estar sempre 1 para LoRa
+    TRACE_BEGIN(LORA_SET_MODE, mode);
     lora_write_reg(REG_OP_MODE, (0x80 | mode));
+    TRACE_END(LORA_SET_MODE, mode);
 }
 
-// Inicializa LoRa (pública)
-bool lora_init(void) {
-    // 1. Inicializa o barramento SPI primeiro
+// Inicia o reset: SPI pronto e RESET em nível baixo (pública)
+void lora_reset_begin(void) {
     spi_master_init();
+    #ifdef CSR_LORA_RESET_BASE
+    lora_reset_out_write(0);
+    #endif
+}
 
-    uint8_t rx;
-
-    // 2. Reseta o módulo LoRa (se o pino de reset estiver disponível no CSR)
+// Libera o RESET; o chip responde via SPI após ~5 ms (pública)
+void lora_reset_end(void) {
     #ifdef CSR_LORA_RESET_BASE
-    lora_reset_out_write(0); busy_wait_ms_local(5);
-    lora_reset_out_write(1); busy_wait_ms_local(10);
+    lora_reset_out_write(1);
     #endif
+}
 
-    // 3. Verifica a versão do chip via SPI
-    rx = lora_read_reg(REG_VERSION);
-    if (rx != 0x12) {
-        printf("Falha na comunicação\n");
-        return false; // Falha na inicialização
-    }
+// Verifica a versão do chip (pública)
+bool lora_probe(void) {
+    return lora_read_reg(REG_VERSION) == 0x12;
+}
+
+// Programa os registradores do rádio a partir de `config` e deixa em Standby (pública)
+void lora_configure(void) {
+    uint32_t sf = config.lora_sf;
+    uint32_t pwr = config.lora_power_dbm;
+    bool ldro;
 
-    // 4. Configurações do rádio (idênticas às do código anterior)
     lora_set_mode(MODE_SLEEP); // Precisa estar em Sleep para setar a frequência
 
-    uint64_t frf = ((uint64_t)915000000 << 19) / 32000000; // 915 MHz
+    uint64_t frf = ((uint64_t)config.lora_freq_hz << 19) / 32000000;
     lora_write_reg(REG_FRF_MSB, (uint8_t)(frf >> 16));
     lora_write_reg(REG_FRF_MID, (uint8_t)(frf >> 8));
     lora_write_reg(REG_FRF_LSB, (uint8_t)(frf >> 0));
-    lora_write_reg(REG_PA_CONFIG, 0xFF); // PA_BOOST, MaxPower, OutputPower=17dBm default
-    lora_write_reg(REG_PA_DAC, 0x87);    // Ativa +20dBm
-    lora_write_reg(REG_MODEM_CONFIG_1, 0x78); // BW=62.5kHz, CR=4/8, Explicit header
-    lora_write_reg(REG_MODEM_CONFIG_2, 0xC4); // SF=12, CRC On
-    lora_write_reg(REG_MODEM_CONFIG_3, 0x0C); // LowDataRateOptimize On, AGC On
-    lora_write_reg(REG_PREAMBLE_MSB, 0x00);
-    lora_write_reg(REG_PREAMBLE_LSB, 0x0C); // Preamble Length = 12
-    lora_write_reg(REG_SYNC_WORD, 0x12);    // Sync Word = 0x12
+
+    // PA_BOOST, MaxPower=7: até 17 dBm com PA_DAC normal; 18-20 dBm com PA_DAC em +20dBm
+    if (pwr > 17) {
+        lora_write_reg(REG_PA_CONFIG, (uint8_t)(0xF0 | (pwr - 5)));
+        lora_write_reg(REG_PA_DAC, 0x87);
+    } else {
+        lora_write_reg(REG_PA_CONFIG, (uint8_t)(0xF0 | (pwr - 2)));
+        lora_write_reg(REG_PA_DAC, 0x84);
+    }
+
+    // LowDataRateOptimize obrigatório com símbolo > 16 ms (2^SF / BW); sem dividir,
+    // para SF11/125 kHz e SF12/250 kHz (16,384 ms) não arredondarem para 16
+    ldro = (1000u << sf) > 16u * config.lora_bw_hz;
+
+    lora_write_reg(REG_MODEM_CONFIG_1, (uint8_t)((config_lora_bw_code(config.lora_bw_hz) << 4) |
+                                                 ((config.lora_cr - 4) << 1))); // Explicit header
+    lora_write_reg(REG_MODEM_CONFIG_2, (uint8_t)((sf << 4) | 0x04));              // CRC On
+    lora_write_reg(REG_MODEM_CONFIG_3, ldro ? 0x0C : 0x04);                       // AGC On
+    lora_write_reg(REG_PREAMBLE_MSB, (uint8_t)(config.lora_preamble >> 8));
+    lora_write_reg(REG_PREAMBLE_LSB, (uint8_t)(config.lora_preamble & 0xFF));
+    lora_write_reg(REG_SYNC_WORD, (uint8_t)config.lora_sync_word);
     lora_write_reg(REG_OCP, 0x37);       // OCP On, 200mA
     lora_write_reg(REG_FIFO_TX_BASE_ADDR, 0x00);
     lora_write_reg(REG_FIFO_RX_BASE_ADDR, 0x00);
@@ -203,21 +254,72 @@ bool lora_init(void) {
     // lora_write_reg(REG_DIO_MAPPING_1, 0x40);
 
     lora_set_mode(MODE_STDBY); // Volta para Standby após configuração
-    busy_wait_ms_local(10);
 
-    printf("Modulacao: BW=62.5kHz, SF=12, CR=4/8, Preamble=12, SyncWord=0x12\n");
+    cfg_checksum = lora_config_checksum();
+    cfg_valid = true;
+
+    LOG_I(LORA_MODEM_CONFIG, config.lora_bw_hz, sf, config.lora_cr);
+}
+
+// Inicializa LoRa (pública, bloqueante)
+bool lora_init(void) {
+    uint8_t rx;
+
+    // 1. Reseta o módulo LoRa (se o pino de reset estiver disponível no CSR)
+    lora_reset_begin(); busy_wait_ms_local(5);
+    lora_reset_end();   busy_wait_ms_local(10);
+
+    // 2. Verifica a versão do chip via SPI
+    rx = lora_read_reg(REG_VERSION);
+    if (rx != 0x12) {
+        LOG_E(LORA_VERSION_FAIL, rx);
+        return false; // Falha na inicialização
+    }
+
+    // 3. Configurações do rádio
+    lora_configure();
+    busy_wait_ms_local(10);
 
     return true; // Sucesso
 }
 
 
+// Coloca em SLEEP (pública)
+void lora_sleep(void) {
+    lora_set_mode(MODE_SLEEP);
+}
+
+// Acorda, reprogramando só se necessário (pública)
+lora_wake_t lora_wake(void) {
+    uint16_t sum;
+
+    if (cfg_valid) {
+        sum = lora_config_checksum();
+        if (sum == cfg_checksum) {
+            lora_set_mode(MODE_STDBY);
+            LOG_D(LORA_WAKE_RESUME);
+            return LORA_WAKE_RESUMED;
+        }
+        LOG_W(LORA_WAKE_REINIT, sum, cfg_checksum);
+    }
+
+    // Configuração perdida: sem reset se o chip ainda responde
+    if (lora_probe()) {
+        lora_configure();
+        return LORA_WAKE_REINIT;
+    }
+    return lora_init() ? LORA_WAKE_REINIT : LORA_WAKE_FAIL;
+}
+
 // Envia bytes (pública)
 bool lora_send_bytes(const uint8_t *data, size_t len) {
     if (len == 0 || len > 255) {
-        printf("Erro LoRa: Tamanho do pacote inválido (%d bytes)\n", (int)len);
+        LOG_E(LORA_BAD_LEN, len);
         return false;
     }
 
+    TRACE_BEGIN(LORA_SEND, len);
+
     // Garante que está em Standby antes de começar
     lora_set_mode(MODE_STDBY);
 
@@ -230,19 +332,23 @@ bool lora_send_bytes(const uint8_t *data, size_t len) {
     lora_write_reg(REG_IRQ_FLAGS, 0xFF);
     lora_write_reg(REG_DIO_MAPPING_1, 0x40); // DIO0 = 01 (TxDone)
 
-    printf("Enviando %d bytes via LoRa...\n", (int)len);
+    LOG_I(LORA_TX_START, len);
 
     // Inicia a transmissão
     lora_set_mode(MODE_TX);
 
     // Espera pelo TxDone (IRQ_TX_DONE_MASK = 0x08) com timeout
+    TRACE_BEGIN(LORA_WAIT_TXDONE, 0);
     int timeout_cnt = TX_TIMEOUT_MS;
     while (timeout_cnt > 0) {
         // Polling na flag IRQ
         if (lora_read_reg(REG_IRQ_FLAGS) & IRQ_TX_DONE_MASK) {
+            TRACE_END(LORA_WAIT_TXDONE, TX_TIMEOUT_MS - timeout_cnt);
+            if (first_txdone == 0) first_txdone = ticks_now();
             lora_write_reg(REG_IRQ_FLAGS, IRQ_TX_DONE_MASK); // Limpa a flag TxDone
             lora_set_mode(MODE_STDBY); // Volta para Standby após enviar
-            printf("Pacote enviado com sucesso!\n");
+            LOG_I(LORA_TX_DONE, TX_TIMEOUT_MS - timeout_cnt);
+            TRACE_END(LORA_SEND, 1);
             return true; // Sucesso
         }
         busy_wait_ms_local(1); // Espera 1ms antes de verificar de novo
@@ -250,7 +356,13 @@ bool lora_send_bytes(const uint8_t *data, size_t len) {
     }
 
     // Se saiu do loop, ocorreu timeout
-    printf("Erro: Timeout de TX! O radio foi resetado para Standby.\n");
+    TRACE_END(LORA_WAIT_TXDONE, TX_TIMEOUT_MS);
+    LOG_E(LORA_TX_TIMEOUT);
     lora_set_mode(MODE_STDBY); // Tenta voltar para Standby para abortar TX
+    TRACE_END(LORA_SEND, 0);
     return false; // Falha (timeout)
-}
\ No newline at end of file
+}
+
+uint64_t lora_first_txdone_ticks(void) {
+    return first_txdone;
+}
@@ -17,6 +17,59 @@
  */
 bool lora_init(void);
 
+// ============================================
+// === Inicialização em etapas (boot.c) ===
+// ============================================
+// lora_init() = lora_reset_begin + 5 ms + lora_reset_end + 10 ms + lora_probe + lora_configure.
+// As etapas separadas permitem intercalar o reset do rádio com outras tarefas do boot.
+
+/**
+ * @brief Inicializa o SPI e coloca o pino RESET do rádio em nível baixo.
+ */
+void lora_reset_begin(void);
+
+/**
+ * @brief Libera o pino RESET (mantê-lo baixo por pelo menos 100 us).
+ */
+void lora_reset_end(void);
+
+/**
+ * @brief Lê REG_VERSION e confere o valor esperado (0x12).
+ * Após o reset o chip só responde depois de alguns ms; pode ser chamada em polling.
+ * @return true se o chip respondeu com a versão correta.
+ */
+bool lora_probe(void);
+
+/**
+ * @brief Programa frequência, modem, potência e FIFO e deixa o rádio em Standby.
+ */
+void lora_configure(void);
+
+// ============================================
+// === Sleep / wake ===
+// ============================================
+// O SX1276 mantém os registradores em SLEEP. lora_wake() confere uma soma
+// de alguns registradores de configuração e só reprograma se ela mudou.
+
+typedef enum {
+    LORA_WAKE_RESUMED,   // Configuração retida; só voltou para Standby
+    LORA_WAKE_REINIT,    // Configuração perdida; rádio reprogramado
+    LORA_WAKE_FAIL       // Rádio não respondeu nem após init completo
+} lora_wake_t;
+
+/**
+ * @brief Coloca o rádio em SLEEP (menor consumo, registradores retidos).
+ */
+void lora_sleep(void);
+
+/**
+ * @brief Acorda o rádio e deixa em Standby, pronto para lora_send_bytes().
+ * Se a soma dos registradores de configuração não confere, chama
+ * lora_configure() (ou lora_init() se o chip não responder).
+ * @return Caminho tomado (lora_wake_t).
+ */
+lora_wake_t lora_wake(void);
+
 /**
  * @brief Envia um buffer de bytes via LoRa.
  * @param data Ponteiro para o buffer de dados a ser enviado.
@@ -50,5 +103,12 @@ uint8_t lora_read_reg(uint8_t reg);
  */
 void lora_write_reg(uint8_t reg, uint8_t value);
 
+/**
+ * @brief Instante do primeiro TxDone desde o reset (ciclos de ticks_now()).
+ * Usado para medir o tempo do reset até o primeiro pacote transmitido.
+ * @return Ciclos desde o reset, ou 0 se nenhum pacote foi enviado ainda.
+ */
+uint64_t lora_first_txdone_ticks(void);
+
 
 #endif // LORA_RFM95_H_
\ No newline at end of file
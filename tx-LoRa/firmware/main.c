@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdlib.h>
 #include <generated/csr.h>
 #include <generated/soc.h>
 #include <system.h>
@@ -11,19 +12,15 @@
 
 #include "bh1750.h"   // Agora contém I2C + BH1750
 #include "lora_RFM95.h"
-
-// ------------------------------
-// Utils de tempo
-// ------------------------------
-static void busy_wait_ms(unsigned int ms) {
-    for (unsigned int i = 0; i < ms; ++i) {
-#ifdef CSR_TIMER0_BASE
-        busy_wait_us(1000);
-#else
-        for (volatile int j = 0; j < 1000; j++);
-#endif
-    }
-}
+#include "telemetry.h"
+#include "log.h"
+#include "trace.h"
+#include "fastmem.h"
+#include "boot.h"
+#include "journal.h"
+#include "sdlog.h"
+#include "config.h"
+#include "ticks.h"
 
 // ------------------------------
 // Console (mantenha igual)
@@ -70,6 +67,16 @@ static void help(void) {
     puts("enviar      - ler BH1750 e enviar via LoRa");
     puts("info_LoRa   - informações do módulo LoRa");
     puts("scan_i2c    - escanear barramento I2C");
+    puts("stream      - stream binario: stream on [periodo_ms] [notx] | stream off");
+    puts("log         - nivel do log: log [0=erro..3=debug]");
+    puts("trace       - trace de execucao: trace on | off | clear | dump");
+    puts("boot_info   - tempos de cada fase do boot e do primeiro TX");
+    puts("wake_tx     - latencia ate o TX: acordar do sleep vs. init completo");
+    puts("journal     - journal de amostras na flash: journal [flush | drain]");
+    puts("sdlog       - log de amostras no cartao SD: sdlog on | off | reset");
+    puts("set         - altera parametro: set <chave> <valor>");
+    puts("get         - mostra parametros: get [chave]");
+    puts("save        - grava os parametros na flash");
 }
 
 static void reboot(void) { ctrl_reset_write(1); }
@@ -90,8 +97,10 @@ static void send_sensor_data(void) {
     if(bh1750_get_data(&luz)) {
         printf("Luminosidade: %u.%02u lux\n", luz.luminosidade/100, luz.luminosidade%100);
 
-        if(!lora_send_bytes((uint8_t*)&luz, sizeof(luz))) {
-            printf("Falha no envio LoRa.\n");
+        bool sent = lora_send_bytes((uint8_t*)&luz, sizeof(luz));
+        journal_append(luz.luminosidade, sent);
+        if(!sent) {
+            printf("Falha no envio LoRa (amostra guardada no journal).\n");
         } else {
             printf("Dados BH1750 enviados via LoRa.\n");
         }
@@ -100,11 +109,193 @@ static void send_sensor_data(void) {
     }
 }
 
+// Acordar do SLEEP (registradores retidos) vs. lora_init() completo, até o TxDone
+static void wake_tx_bench(void) {
+    bh1750_dados luz;
+    uint64_t t0, t_ready, t_done;
+    lora_wake_t w;
+    bool ok;
+
+    if(!bh1750_get_data(&luz)) {
+        printf("Falha ao ler BH1750.\n");
+        return;
+    }
+
+    lora_sleep();
+    t0 = ticks_now();
+    w = lora_wake();
+    t_ready = ticks_now();
+    ok = (w != LORA_WAKE_FAIL) && lora_send_bytes((uint8_t*)&luz, sizeof(luz));
+    t_done = ticks_now();
+    printf("lora_wake (%s): pronto em %lu us, TxDone em %lu us%s\n",
+           w == LORA_WAKE_RESUMED ? "config retida" : "reprogramado",
+           (unsigned long)ticks_to_us(t_ready - t0), (unsigned long)ticks_to_us(t_done - t0),
+           ok ? "" : " (falha)");
+
+    lora_sleep();
+    t0 = ticks_now();
+    ok = lora_init();
+    t_ready = ticks_now();
+    ok = ok && lora_send_bytes((uint8_t*)&luz, sizeof(luz));
+    t_done = ticks_now();
+    printf("lora_init completo:        pronto em %lu us, TxDone em %lu us%s\n",
+           (unsigned long)ticks_to_us(t_ready - t0), (unsigned long)ticks_to_us(t_done - t0),
+           ok ? "" : " (falha)");
+}
+
 static void lorainfo(void) {
     uint8_t version = lora_read_reg(0x42);
     printf("LoRa Version: 0x%02X\n", version);
 }
 
+// ------------------------------
+// Stream binário de telemetria
+// ------------------------------
+static void stream_cmd(char *args) {
+    char *mode = get_token(&args);
+
+    if(strcmp(mode, "on") == 0) {
+        uint32_t period_ms = config.sample_period_ms, min, max;
+        bool with_tx = true;
+        char *end = "";
+        char *tok = get_token(&args);
+        if(*tok) period_ms = strtoul(tok, &end, 0);
+        // Mesma faixa de sample.period, sem o 0: amostras sem intervalo inundam a UART
+        config_range("sample.period", &min, &max);
+        if(*end || period_ms == 0 || period_ms < min || period_ms > max) {
+            printf("Periodo invalido: use 1..%lu ms\n", (unsigned long)max);
+            return;
+        }
+        tok = get_token(&args);
+        if(strcmp(tok, "notx") == 0) with_tx = false;
+        printf("Stream binario: periodo=%lu ms, LoRa=%s\n",
+               (unsigned long)period_ms, with_tx ? "on" : "off");
+        telemetry_start(period_ms, with_tx);
+    } else if(strcmp(mode, "off") == 0) {
+        telemetry_stop();
+        printf("\nStream binario desativado.\n");
+    } else {
+        puts("Uso: stream on [periodo_ms] [notx] | stream off");
+    }
+}
+
+static void log_cmd(char *args) {
+    char *tok = get_token(&args);
+    if(*tok) log_level = (int)strtoul(tok, NULL, 0);
+    printf("Nivel do log: %d (compilado ate %d)\n", log_level, LOG_LEVEL_MAX);
+}
+
+static void trace_cmd(char *args) {
+    char *tok = get_token(&args);
+
+    if(strcmp(tok, "on") == 0) trace_enable(true);
+    else if(strcmp(tok, "off") == 0) trace_enable(false);
+    else if(strcmp(tok, "clear") == 0) trace_clear();
+    else if(strcmp(tok, "dump") == 0) {
+        printf("Enviando %u eventos...\n", trace_count());
+        trace_dump();
+        printf("\n");
+    }
+    printf("Trace: %s, %u eventos no buffer\n", trace_on ? "ligado" : "desligado", trace_count());
+}
+
+static void journal_cmd(char *args) {
+    char *tok = get_token(&args);
+    journal_stats_t st;
+
+    if(strcmp(tok, "flush") == 0) journal_flush();
+    else if(strcmp(tok, "drain") == 0) journal_drain_now();
+
+    journal_get_stats(&st);
+    if(!st.ready) {
+        puts("Journal desativado (sem flash SPI no gateware).");
+        return;
+    }
+    printf("Journal: %lu setores, cabeca %lu/%lu, cauda %lu/%lu\n",
+           (unsigned long)st.sectors, (unsigned long)st.head_sector, (unsigned long)st.head_slot,
+           (unsigned long)st.tail_sector, (unsigned long)st.tail_slot);
+    printf("  pendentes: %lu (em RAM: %lu), reenviados: %lu, descartados: %lu, erros: %lu\n",
+           (unsigned long)st.pending, (unsigned long)st.buffered, (unsigned long)st.resent,
+           (unsigned long)st.dropped, (unsigned long)st.errors);
+    printf("  ultimo TX: %s, recuperacao no boot: %lu us\n",
+           st.tx_ok ? "ok" : "falhou", (unsigned long)st.recovery_us);
+}
+
+static void print_hist(const char *title, const uint32_t *hist, const char *unit) {
+    printf("  %s:\n", title);
+    for(int i = 0; i < SDLOG_HIST_BUCKETS; i++) {
+        if(hist[i] == 0) continue;
+        printf("    [%7lu, %7lu) %s: %lu\n", i ? 1ul << i : 0ul, 2ul << i, unit, (unsigned long)hist[i]);
+    }
+}
+
+static void sdlog_cmd(char *args) {
+    char *tok = get_token(&args);
+    sdlog_stats_t st;
+
+    if(strcmp(tok, "on") == 0) {
+        if(!sdlog_start()) return;
+    } else if(strcmp(tok, "off") == 0) {
+        sdlog_stop();
+    } else if(strcmp(tok, "reset") == 0) {
+        sdlog_reset_stats();
+    }
+
+    sdlog_get_stats(&st);
+    printf("Log SD: %s, arquivo " SDLOG_FILE_FMT " (seq %lu) de %u\n", st.active ? "ativo" : "parado",
+           st.file_idx, (unsigned long)st.file_seq, st.files);
+    printf("  amostras: %lu, descartadas: %lu, escritas: %lu, %lu KB gravados\n",
+           (unsigned long)st.samples, (unsigned long)st.overruns, (unsigned long)st.writes,
+           (unsigned long)(st.bytes_written / 1024));
+    if(st.write_us)
+        printf("  vazao media: %lu KB/s\n", (unsigned long)(st.bytes_written * 1000000 / 1024 / st.write_us));
+    print_hist("latencia de sdlog_append", st.hist_append_us, "us");
+    print_hist("latencia de escrita no cartao", st.hist_write_us, "us");
+    print_hist("vazao por escrita", st.hist_kbps, "KB/s");
+}
+
+// ------------------------------
+// Configuração persistente
+// ------------------------------
+static void set_cmd(char *args) {
+    char *key = get_token(&args);
+    char *val = get_token(&args);
+    int apply;
+
+    if(!*key || !*val) {
+        puts("Uso: set <chave> <valor>  (chaves: 'get')");
+        return;
+    }
+    apply = config_set(key, strtoul(val, NULL, 0));
+    if(apply == CONFIG_ERR_KEY) { printf("Chave desconhecida: %s\n", key); return; }
+    if(apply == CONFIG_ERR_RANGE) { printf("Valor invalido para %s\n", key); return; }
+
+    // Aplica sem reiniciar; 'save' torna permanente
+    if(apply & CONFIG_APPLY_LORA) lora_configure();
+    if((apply & CONFIG_APPLY_BH1750) && bh1750_start() != 0) printf("BH1750 nao respondeu no novo endereco.\n");
+    printf("%s = %s\n", key, val);
+}
+
+static void get_cmd(char *args) {
+    char *key = get_token(&args);
+    uint32_t v;
+
+    if(!*key) config_print();
+    else if(config_get(key, &v)) printf("%s = %lu (0x%lX)\n", key, (unsigned long)v, (unsigned long)v);
+    else printf("Chave desconhecida: %s\n", key);
+}
+
+static void save_cmd(void) {
+    printf(config_save() ? "Configuracao gravada na flash.\n" : "Falha ao gravar a configuracao.\n");
+}
+
+// Até 4 caracteres do comando, para identificar o evento no trace
+static uint32_t cmd_tag(const char *token) {
+    uint32_t tag = 0;
+    for(int i = 0; i < 4 && token[i]; i++) tag |= (uint32_t)(uint8_t)token[i] << (8 * i);
+    return tag;
+}
+
 // ------------------------------
 // Serviço do console
 // ------------------------------
@@ -112,15 +303,29 @@ static void console_service(void) {
     char *str = readstr();
     if(!str) return;
     char *token = get_token(&str);
+    uint32_t tag = cmd_tag(token);
 
+    TRACE_BEGIN(CONSOLE_CMD, tag);
     if(strcmp(token, "help") == 0) help();
     else if(strcmp(token, "reboot") == 0) reboot();
     else if(strcmp(token, "led") == 0) toggle_led();
     else if(strcmp(token, "enviar") == 0) send_sensor_data();
     else if(strcmp(token, "info_LoRa") == 0) lorainfo();
     else if(strcmp(token, "scan_i2c") == 0) i2c_scan();
+    else if(strcmp(token, "stream") == 0) stream_cmd(str);
+    else if(strcmp(token, "log") == 0) log_cmd(str);
+    else if(strcmp(token, "trace") == 0) trace_cmd(str);
+    else if(strcmp(token, "boot_info") == 0) boot_print_report();
+    else if(strcmp(token, "wake_tx") == 0) wake_tx_bench();
+    else if(strcmp(token, "journal") == 0) journal_cmd(str);
+    else if(strcmp(token, "sdlog") == 0) sdlog_cmd(str);
+    else if(strcmp(token, "set") == 0) set_cmd(str);
+    else if(strcmp(token, "get") == 0) get_cmd(str);
+    else if(strcmp(token, "save") == 0) save_cmd();
     else puts("Comando desconhecido. Digite 'help'.");
+    TRACE_END(CONSOLE_CMD, tag);
 
+    log_service(0); // Mensagens do comando aparecem antes do prompt
     prompt();
 }
 
@@ -128,38 +333,33 @@ static void console_service(void) {
 // main
 // ------------------------------
 int main(void) {
+    boot_begin();
+    fastmem_init(); // Antes de qualquer FAST_TEXT (inclusive a ISR da UART)
+
 #ifdef CONFIG_CPU_HAS_INTERRUPT
     irq_setmask(0);
     irq_setie(1);
 #endif
 
     uart_init();
-    busy_wait_ms(500);
 
     printf("Hello World!\n");
     printf("Tarefa – Transmissão de dados BH1750 via LoRa\n");
 
-    // Inicializa I2C UMA VEZ
-    i2c_init();
-    
-    // Inicializa sensores
-    if(bh1750_init() != 0) {
-        printf("Falha ao inicializar BH1750.\n");
-    } else {
-        printf("BH1750 inicializado com sucesso.\n");
-    }
-    
-    // Inicializa LoRa UMA VEZ
-    if(!lora_init()) {
-        printf("Falha ao inicializar LoRa.\n");
-    } else {
-        printf("LoRa inicializado com sucesso.\n");
-    }
+    // I2C, BH1750 e LoRa inicializados em paralelo (ver boot.c)
+    boot_run();
+    log_service(0);
 
     help();
     prompt();
 
-    while(1) console_service();
+    while(1) {
+        console_service();
+        telemetry_service();
+        journal_service();
+        sdlog_service();
+        log_service(4);
+    }
 
     return 0;
 }
@@ -0,0 +1,353 @@
+// sdlog.c
+#include "sdlog.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+#include "telemetry.h"
+#include "fastmem.h"
+#include "ticks.h"
+
+#ifdef CSR_SDCORE_BASE
+#include <crc.h>
+#include <libfatfs/ff.h>
+#include <liblitesdcard/sdcard.h>
+
+// ============================================
+// === Definições Internas ===
+// ============================================
+
+#define TICKS_PER_MS     (CONFIG_CLOCK_FREQUENCY / 1000)
+#define SDLOG_VERSION    1
+
+typedef struct {
+    uint8_t *data;
+    uint32_t fill;      // Bytes com quadros
+    uint32_t flushed;   // Bytes já gravados no cartão
+    uint32_t lba;       // Bloco do cartão correspondente a data[0]
+    uint64_t since;     // Instante do primeiro byte ainda não gravado
+    bool     full;      // Fechado; aguarda sdlog_service()
+} sdlog_buf_t;
+
+typedef struct {
+    bool     valid;
+    uint16_t idx;
+    uint32_t seq;
+    uint32_t lba;       // Primeiro bloco do arquivo
+    uint32_t blocks;    // Blocos utilizáveis (múltiplo de SDLOG_BUF_BLOCKS)
+} sdlog_file_t;
+
+// ============================================
+// === Estado Interno ===
+// ============================================
+
+static uint8_t buf_mem[2][SDLOG_BUF_SIZE] SDRAM_BSS __attribute__((aligned(64)));
+
+static sdlog_buf_t  bufs[2] = { { .data = buf_mem[0] }, { .data = buf_mem[1] } };
+static int          act;            // Buffer que recebe as amostras
+static sdlog_file_t cur, next;      // Arquivo atual e o próximo da rotação (preparado antes)
+static uint32_t     cur_block;      // Próximo bloco livre do arquivo atual
+static FATFS        fs;
+static sdlog_stats_t st;
+
+// ============================================
+// === Funções Internas ===
+// ============================================
+
+static void hist_add(uint32_t *hist, uint32_t v) {
+    int b = 0;
+    while (v > 1 && b < SDLOG_HIST_BUCKETS - 1) {
+        v >>= 1;
+        b++;
+    }
+    hist[b]++;
+}
+
+static void file_name(char *name, unsigned idx) {
+    snprintf(name, 16, SDLOG_FILE_FMT, idx);
+}
+
+// Decodifica o primeiro quadro do bloco; retorna o tamanho do payload ou 0
+static size_t first_frame(const uint8_t *blk, uint8_t *out, size_t max) {
+    const uint8_t *p = blk + 1, *end = blk + SDLOG_BLOCK_SIZE;
+    size_t n = 0;
+    uint16_t crc;
+
+    if (blk[0] != 0x00) return 0;
+    while (p < end && *p != 0x00) {
+        uint8_t code = *p++;
+        for (uint8_t i = 1; i < code; i++) {
+            if (p >= end || *p == 0x00 || n >= max) return 0;
+            out[n++] = *p++;
+        }
+        if (code != 0xFF && p < end && *p != 0x00) {
+            if (n >= max) return 0;
+            out[n++] = 0x00;
+        }
+    }
+    if (n < 3) return 0;
+    crc = crc16(out, (int)(n - 2));
+    if (out[n - 2] != (uint8_t)(crc & 0xFF) || out[n - 1] != (uint8_t)(crc >> 8)) return 0;
+    return n - 2;
+}
+
+// Lê o cabeçalho TELEM_TYPE_FILE do arquivo; false se nunca foi usado
+static bool read_header(FIL *f, uint32_t *seq) {
+    uint8_t payload[TELEM_MAX_PAYLOAD + 2];
+    telemetry_file_t h;
+    UINT br;
+    uint8_t *blk = bufs[1].data; // Rascunho: só usado com o log parado
+
+    if (f_lseek(f, 0) != FR_OK || f_read(f, blk, SDLOG_BLOCK_SIZE, &br) != FR_OK || br != SDLOG_BLOCK_SIZE)
+        return false;
+    if (first_frame(blk, payload, sizeof(payload)) != sizeof(h)) return false;
+    memcpy(&h, payload, sizeof(h));
+    if (h.type != TELEM_TYPE_FILE || h.version != SDLOG_VERSION) return false;
+    *seq = h.file_seq;
+    return true;
+}
+
+// Localiza o arquivo no cartão; exige clusters contíguos para gravar em blocos
+static bool open_file(uint16_t idx, sdlog_file_t *out) {
+    char name[16];
+    FIL f;
+    uint32_t clus_bytes = (uint32_t)fs.csize * SDLOG_BLOCK_SIZE;
+    uint32_t size, sclust;
+    bool ok = true;
+
+    file_name(name, idx);
+    if (f_open(&f, name, FA_READ) != FR_OK) return false;
+
+    size = f_size(&f);
+    sclust = f.obj.sclust;
+    if (size < SDLOG_BUF_SIZE || sclust < 2) ok = false;
+
+    // Posição k*cluster+1 fica no k-ésimo cluster: a cadeia da FAT deve ser sequencial
+    for (uint32_t k = 1; ok && k * clus_bytes < size; k++) {
+        if (f_lseek(&f, k * clus_bytes + 1) != FR_OK || f.clust != sclust + k) ok = false;
+    }
+    f_close(&f);
+
+    if (!ok) {
+        printf("SD: %s ignorado (menor que %u bytes ou fragmentado)\n", name, SDLOG_BUF_SIZE);
+        return false;
+    }
+    out->valid = true;
+    out->idx = idx;
+    out->lba = fs.database + (sclust - 2) * fs.csize;
+    out->blocks = (size / SDLOG_BUF_SIZE) * SDLOG_BUF_BLOCKS;
+    return true;
+}
+
+// Próximo arquivo utilizável depois de `after`, em ordem circular
+static bool prepare_next(uint16_t after, uint32_t seq, sdlog_file_t *out) {
+    for (uint16_t i = 1; i <= st.files; i++) {
+        if (open_file((after + i) % st.files, out)) {
+            out->seq = seq;
+            return true;
+        }
+    }
+    out->valid = false;
+    return false;
+}
+
+// Associa um buffer livre aos próximos blocos (abrindo o próximo arquivo se preciso)
+static bool start_buffer(sdlog_buf_t *b) {
+    if (cur_block + SDLOG_BUF_BLOCKS > cur.blocks) {
+        if (!next.valid) return false;
+        cur = next;
+        next.valid = false;
+        cur_block = 0;
+    }
+
+    b->lba = cur.lba + cur_block;
+    b->fill = b->flushed = 0;
+    b->full = false;
+
+    if (cur_block == 0) {
+        telemetry_file_t h = {
+            .type = TELEM_TYPE_FILE,
+            .version = SDLOG_VERSION,
+            .file_idx = cur.idx,
+            .file_seq = cur.seq,
+            .timestamp_us = ticks_to_us(ticks_now()),
+        };
+        b->fill = telemetry_encode_frame((const uint8_t *)&h, sizeof(h), b->data);
+        b->since = ticks_now();
+        st.file_idx = cur.idx;
+        st.file_seq = cur.seq;
+    }
+    cur_block += SDLOG_BUF_BLOCKS;
+    return true;
+}
+
+// Grava b->data[flushed..upto) (em blocos inteiros) com uma escrita de vários blocos
+static void write_buf(sdlog_buf_t *b, uint32_t upto) {
+    uint32_t first = b->flushed / SDLOG_BLOCK_SIZE;
+    uint32_t last = (upto + SDLOG_BLOCK_SIZE - 1) / SDLOG_BLOCK_SIZE;
+    uint32_t bytes, us;
+    uint64_t t0;
+
+    if (last <= first) return;
+    // Completa o último bloco com 0x00 (delimitador: ignorado pelo decodificador)
+    memset(b->data + upto, 0, last * SDLOG_BLOCK_SIZE - upto);
+
+    bytes = (last - first) * SDLOG_BLOCK_SIZE;
+    t0 = ticks_now();
+    sdcard_write(b->lba + first, last - first, b->data + first * SDLOG_BLOCK_SIZE);
+    us = ticks_to_us(ticks_now() - t0);
+
+    st.writes++;
+    st.bytes_written += bytes;
+    st.write_us += us;
+    hist_add(st.hist_write_us, us);
+    hist_add(st.hist_kbps, us ? (uint32_t)((uint64_t)bytes * 1000000 / 1024 / us) : 0);
+
+    b->flushed = upto;
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+bool sdlog_start(void) {
+    char name[16];
+    FIL f;
+    uint32_t seq, max_seq = 0;
+    int newest = -1;
+
+    if (st.active) return true;
+
+    fatfs_set_ops_sdcard();
+    if (f_mount(&fs, "", 1) != FR_OK) {
+        printf("SD: falha ao montar o cartao\n");
+        return false;
+    }
+
+    // Arquivos pré-alocados em sequência; o mais recente tem o maior file_seq
+    st.files = 0;
+    for (uint16_t i = 0; i < SDLOG_MAX_FILES; i++) {
+        file_name(name, i);
+        if (f_open(&f, name, FA_READ) != FR_OK) break;
+        if (read_header(&f, &seq) && (newest < 0 || seq > max_seq)) {
+            newest = i;
+            max_seq = seq;
+        }
+        f_close(&f);
+        st.files++;
+    }
+    if (st.files == 0) {
+        printf("SD: nenhum " SDLOG_FILE_FMT " no cartao (ver README)\n", 0u);
+        return false;
+    }
+
+    if (!prepare_next(newest < 0 ? st.files - 1 : (uint16_t)newest, newest < 0 ? 0 : max_seq + 1, &next))
+        return false;
+    cur_block = 0;
+    cur.blocks = 0; // Força start_buffer() a abrir `next`
+
+    act = 0;
+    bufs[1].fill = bufs[1].flushed = 0;
+    bufs[1].full = false;
+    if (!start_buffer(&bufs[0])) return false;
+
+    st.active = true;
+    return true;
+}
+
+void sdlog_stop(void) {
+    if (!st.active) return;
+    sdlog_service();
+    write_buf(&bufs[act], bufs[act].fill);
+    st.active = false;
+}
+
+void sdlog_append(const uint8_t *payload, size_t len) {
+    uint8_t frame[TELEM_MAX_FRAME];
+    sdlog_buf_t *b;
+    uint64_t t0 = ticks_now();
+    size_t n;
+
+    if (!st.active) return;
+    n = telemetry_encode_frame(payload, len, frame);
+    if (n == 0) return;
+
+    b = &bufs[act];
+    if (b->fill + n > SDLOG_BUF_SIZE) {
+        sdlog_buf_t *o = &bufs[act ^ 1];
+
+        memset(b->data + b->fill, 0, SDLOG_BUF_SIZE - b->fill);
+        b->fill = SDLOG_BUF_SIZE;
+        b->full = true;
+
+        // O outro buffer ainda não foi gravado (ou não há arquivo): descarta
+        if (o->full || !start_buffer(o)) {
+            st.overruns++;
+            return;
+        }
+        act ^= 1;
+        b = o;
+    }
+
+    if (b->fill == b->flushed) b->since = t0;
+    memcpy(b->data + b->fill, frame, n);
+    b->fill += n;
+    st.samples++;
+    hist_add(st.hist_append_us, ticks_to_us(ticks_now() - t0));
+}
+
+void sdlog_service(void) {
+    sdlog_buf_t *b;
+
+    if (!st.active) return;
+
+    // Buffer fechado: grava tudo (o que restou após a gravação incremental)
+    b = &bufs[act ^ 1];
+    if (b->full) {
+        write_buf(b, SDLOG_BUF_SIZE);
+        b->full = false;
+        b->fill = b->flushed = 0;
+        return;
+    }
+
+    // Buffer parcial antigo: grava os blocos novos; o último será regravado depois
+    b = &bufs[act];
+    if (b->fill > b->flushed && ticks_now() - b->since >= (uint64_t)SDLOG_FLUSH_MS * TICKS_PER_MS) {
+        write_buf(b, b->fill);
+        b->since = ticks_now();
+        return;
+    }
+
+    // Ocioso: deixa o próximo arquivo pronto para a rotação
+    if (!next.valid) prepare_next(cur.idx, cur.seq + 1, &next);
+}
+
+void sdlog_get_stats(sdlog_stats_t *out) {
+    *out = st;
+}
+
+void sdlog_reset_stats(void) {
+    st.samples = st.overruns = st.writes = 0;
+    st.bytes_written = st.write_us = 0;
+    memset(st.hist_append_us, 0, sizeof(st.hist_append_us));
+    memset(st.hist_write_us, 0, sizeof(st.hist_write_us));
+    memset(st.hist_kbps, 0, sizeof(st.hist_kbps));
+}
+
+#else // Gateware sem --with-sdcard: log no SD desativado
+
+static sdlog_stats_t st;
+
+bool sdlog_start(void) {
+    printf("SD: gateware sem cartao SD nativo (use --with-sdcard)\n");
+    return false;
+}
+void sdlog_stop(void) {}
+void sdlog_append(const uint8_t *payload, size_t len) { (void)payload; (void)len; }
+void sdlog_service(void) {}
+void sdlog_get_stats(sdlog_stats_t *out) { *out = st; }
+void sdlog_reset_stats(void) {}
+
+#endif
@@ -0,0 +1,86 @@
+// sdlog.h
+#ifndef SDLOG_H_
+#define SDLOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// ============================================
+// === Log de amostras no cartão SD ===
+// ============================================
+//
+// A libfatfs da LiteX é compilada somente leitura (FF_FS_READONLY=1). Por
+// isso os arquivos LOG000.BIN, LOG001.BIN... são pré-alocados no PC (contíguos,
+// ver README): o FatFs só localiza o primeiro bloco de cada um, e a gravação é
+// feita direto no cartão com sdcard_write() em escritas de vários blocos.
+//
+// As amostras entram como quadros do stream (COBS + CRC16, telemetry.h) em dois
+// buffers de SDLOG_BUF_SIZE na SDRAM. Um buffer cheio é gravado inteiro pelo
+// sdlog_service() no loop principal, enquanto o outro recebe as amostras; o
+// buffer parcial é gravado de forma incremental após SDLOG_FLUSH_MS.
+// O arquivo pode ser lido com telemetry_decode, igual a uma captura da UART.
+
+#define SDLOG_BLOCK_SIZE     512
+#define SDLOG_BUF_SIZE       32768  // Múltiplo do cluster (até 32 KB): escritas alinhadas
+#define SDLOG_BUF_BLOCKS     (SDLOG_BUF_SIZE / SDLOG_BLOCK_SIZE)
+#define SDLOG_FLUSH_MS       2000
+#define SDLOG_MAX_FILES      100
+#define SDLOG_FILE_FMT       "LOG%03u.BIN"
+#define SDLOG_HIST_BUCKETS   20     // Potências de 2: [2^i, 2^(i+1))
+
+/**
+ * Estatísticas do log (comando `sdlog`).
+ */
+typedef struct {
+    bool     active;
+    uint16_t files;                      // Arquivos LOGnnn.BIN encontrados
+    uint16_t file_idx;                   // Arquivo atual
+    uint32_t file_seq;
+    uint32_t samples;                    // Quadros aceitos
+    uint32_t overruns;                   // Quadros descartados (os dois buffers cheios)
+    uint64_t bytes_written;              // Bytes enviados ao cartão
+    uint64_t write_us;                   // Tempo total em sdcard_write()
+    uint32_t writes;
+    uint32_t hist_append_us[SDLOG_HIST_BUCKETS]; // Duração de sdlog_append()
+    uint32_t hist_write_us[SDLOG_HIST_BUCKETS];  // Duração de cada escrita no cartão
+    uint32_t hist_kbps[SDLOG_HIST_BUCKETS];      // Vazão de cada escrita (KB/s)
+} sdlog_stats_t;
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+/**
+ * @brief Monta o cartão, escolhe o arquivo seguinte ao mais recente e ativa o log.
+ * @return true se o log foi ativado.
+ */
+bool sdlog_start(void);
+
+/**
+ * @brief Grava o que está nos buffers e desativa o log.
+ */
+void sdlog_stop(void);
+
+/**
+ * @brief Acrescenta um registro (payload do stream) ao buffer atual.
+ * Não acessa o cartão; se os dois buffers estiverem cheios, o registro é descartado.
+ */
+void sdlog_append(const uint8_t *payload, size_t len);
+
+/**
+ * @brief Serviço do log; chamar no loop principal. Grava buffers cheios e o parcial antigo.
+ */
+void sdlog_service(void);
+
+/**
+ * @brief Copia as estatísticas atuais.
+ */
+void sdlog_get_stats(sdlog_stats_t *st);
+
+/**
+ * @brief Zera contadores e histogramas.
+ */
+void sdlog_reset_stats(void);
+
+#endif // SDLOG_H_
@@ -0,0 +1,131 @@
+// telemetry.c
+#include "telemetry.h"
+
+#include <string.h>
+#include <crc.h>          // crc16 da libbase
+#include <uart.h>         // uart_write (sem tradução de \n)
+
+#include "bh1750.h"
+#include "lora_RFM95.h"
+#include "journal.h"
+#include "sdlog.h"
+#include "ticks.h"
+
+// ============================================
+// === Estado Interno ===
+// ============================================
+
+static bool     stream_on = false;
+static bool     stream_tx = true;
+static uint64_t stream_period_us = 0;
+static uint64_t next_sample = 0;
+static uint16_t stream_seq = 0;
+
+// ============================================
+// === COBS ===
+// ============================================
+
+// Codifica len bytes de in em out (sem o delimitador). Retorna o tamanho.
+// out precisa de len + len/254 + 1 bytes.
+static size_t cobs_encode(const uint8_t *in, size_t len, uint8_t *out) {
+    size_t code_idx = 0, o = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_idx] = code;
+            code_idx = o++;
+            code = 1;
+        } else {
+            out[o++] = in[i];
+            if (++code == 0xFF) {
+                out[code_idx] = code;
+                code_idx = o++;
+                code = 1;
+            }
+        }
+    }
+    out[code_idx] = code;
+    return o;
+}
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+size_t telemetry_encode_frame(const uint8_t *payload, size_t len, uint8_t *out) {
+    uint8_t raw[TELEM_MAX_PAYLOAD + 2];
+    uint16_t crc;
+    size_t n;
+
+    if (len == 0 || len > TELEM_MAX_PAYLOAD) return 0;
+
+    memcpy(raw, payload, len);
+    crc = crc16(raw, (int)len);
+    raw[len]     = (uint8_t)(crc & 0xFF);
+    raw[len + 1] = (uint8_t)(crc >> 8);
+
+    out[0] = 0x00;
+    n = cobs_encode(raw, len + 2, &out[1]);
+    out[n + 1] = 0x00;
+    return n + 2;
+}
+
+void telemetry_send_frame(const uint8_t *payload, size_t len) {
+    uint8_t frame[TELEM_MAX_FRAME];
+    size_t n = telemetry_encode_frame(payload, len, frame);
+
+    for (size_t i = 0; i < n; i++) uart_write((char)frame[i]);
+}
+
+void telemetry_start(uint32_t period_ms, bool with_tx) {
+    stream_period_us = (uint64_t)period_ms * 1000;
+    stream_tx = with_tx;
+    stream_seq = 0;
+    next_sample = ticks_now();
+    stream_on = true;
+}
+
+void telemetry_stop(void) {
+    stream_on = false;
+}
+
+bool telemetry_active(void) {
+    return stream_on;
+}
+
+void telemetry_service(void) {
+    telemetry_sample_t rec;
+    bh1750_dados luz;
+    uint64_t t0, t1;
+
+    if (!stream_on) return;
+    if (ticks_now() < next_sample) return;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.type = TELEM_TYPE_SAMPLE;
+    rec.seq  = stream_seq++;
+
+    t0 = ticks_now();
+    rec.timestamp_us = ticks_to_us(t0);
+    if (bh1750_get_data(&luz)) {
+        rec.flags |= TELEM_FLAG_READ_OK;
+        rec.luminosidade = luz.luminosidade;
+    }
+    t1 = ticks_now();
+    rec.read_us = ticks_to_us(t1 - t0);
+
+    if (!stream_tx) {
+        rec.flags |= TELEM_FLAG_TX_SKIPPED;
+    } else if (rec.flags & TELEM_FLAG_READ_OK) {
+        if (lora_send_bytes((uint8_t*)&luz, sizeof(luz))) rec.flags |= TELEM_FLAG_TX_OK;
+        rec.tx_us = ticks_to_us(ticks_now() - t1);
+        journal_append(luz.luminosidade, rec.flags & TELEM_FLAG_TX_OK);
+    }
+
+    telemetry_send_frame((const uint8_t*)&rec, sizeof(rec));
+    sdlog_append((const uint8_t*)&rec, sizeof(rec));
+
+    // Agenda a partir do instante da amostra para não acumular atraso
+    next_sample = t0 + stream_period_us * (CONFIG_CLOCK_FREQUENCY / 1000000);
+}
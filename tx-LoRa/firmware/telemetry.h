@@ -0,0 +1,125 @@
+// telemetry.h
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "trace.h"
+
+// ============================================
+// === Protocolo do stream binário ===
+// ============================================
+//
+// Cada quadro é: 0x00 | COBS(payload | crc16) | 0x00
+// - payload começa sempre com o byte de tipo (TELEM_TYPE_*);
+// - crc16 é o CRC-16/CCITT da libbase (init 0), little-endian,
+//   calculado sobre o payload;
+// - o 0x00 inicial descarta lixo (ex.: texto do console) no receptor.
+// Todos os campos multibyte são little-endian.
+
+#define TELEM_TYPE_SAMPLE        0x01
+#define TELEM_TYPE_LOG           0x02
+#define TELEM_TYPE_TRACE         0x03
+#define TELEM_TYPE_FILE          0x04
+
+#define TELEM_FLAG_READ_OK       0x01 // Leitura do BH1750 bem-sucedida
+#define TELEM_FLAG_TX_OK         0x02 // TxDone recebido do rádio
+#define TELEM_FLAG_TX_SKIPPED    0x04 // Stream sem transmissão LoRa
+
+#define TELEM_MAX_PAYLOAD        64
+// Quadro codificado: delimitadores + COBS (1 byte a cada 254) + CRC
+#define TELEM_MAX_FRAME          (TELEM_MAX_PAYLOAD + 2 + 1 + 2)
+
+/**
+ * Registro de uma amostra (TELEM_TYPE_SAMPLE).
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  type;          // TELEM_TYPE_SAMPLE
+    uint8_t  flags;         // TELEM_FLAG_*
+    uint16_t seq;           // Número de sequência (incrementa a cada registro)
+    uint32_t timestamp_us;  // Instante da amostra desde o reset (us)
+    uint16_t luminosidade;  // lux * 100 (igual a bh1750_dados)
+    uint32_t read_us;       // Duração da leitura do BH1750 (us)
+    uint32_t tx_us;         // Duração de lora_send_bytes (us)
+} telemetry_sample_t;
+
+/**
+ * Mensagem do log binário (TELEM_TYPE_LOG); o host formata com log_ids.h.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  type;          // TELEM_TYPE_LOG
+    uint8_t  level;         // LOG_LVL_*
+    uint16_t id;            // log_id_t
+    uint32_t timestamp_us;  // Instante do evento desde o reset (us)
+    uint32_t args[3];
+} telemetry_log_t;
+
+#define TELEM_TRACE_PER_FRAME    5
+
+/**
+ * Lote de eventos do trace (TELEM_TYPE_TRACE), enviado por trace_dump().
+ * Só os `count` primeiros eventos são transmitidos.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  type;          // TELEM_TYPE_TRACE
+    uint8_t  count;         // Eventos neste quadro
+    uint16_t clk_mhz;       // Clock do sistema, para converter ciclos em us
+    trace_entry_t entries[TELEM_TRACE_PER_FRAME];
+} telemetry_trace_t;
+
+/**
+ * Cabeçalho de arquivo de log no cartão SD (TELEM_TYPE_FILE), primeiro quadro
+ * de cada LOGnnn.BIN; `file_seq` ordena os arquivos na rotação.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  type;          // TELEM_TYPE_FILE
+    uint8_t  version;
+    uint16_t file_idx;      // nnn de LOGnnn.BIN
+    uint32_t file_seq;      // Cresce a cada arquivo aberto
+    uint32_t timestamp_us;  // Instante de abertura desde o reset
+} telemetry_file_t;
+
+// ============================================
+// === Funções Públicas ===
+// ============================================
+
+/**
+ * @brief Ativa o modo de stream binário.
+ * @param period_ms Intervalo entre amostras (0 = o mais rápido possível).
+ * @param with_tx Se true, cada amostra também é enviada via LoRa.
+ */
+void telemetry_start(uint32_t period_ms, bool with_tx);
+
+/**
+ * @brief Desativa o modo de stream binário.
+ */
+void telemetry_stop(void);
+
+/**
+ * @brief Indica se o stream binário está ativo.
+ */
+bool telemetry_active(void);
+
+/**
+ * @brief Serviço do stream; deve ser chamado no loop principal.
+ * Não bloqueia enquanto não for hora da próxima amostra.
+ */
+void telemetry_service(void);
+
+/**
+ * @brief Codifica um payload como quadro completo (0x00 | COBS | 0x00).
+ * @param out Destino com pelo menos TELEM_MAX_FRAME bytes.
+ * @return Bytes escritos em out, ou 0 se len for inválido.
+ */
+size_t telemetry_encode_frame(const uint8_t *payload, size_t len, uint8_t *out);
+
+/**
+ * @brief Envia um payload como quadro COBS + CRC16 pela UART.
+ * @param payload Bytes do registro (o primeiro é o tipo).
+ * @param len Tamanho do payload (máximo TELEM_MAX_PAYLOAD).
+ */
+void telemetry_send_frame(const uint8_t *payload, size_t len);
+
+#endif // TELEMETRY_H_
@@ -0,0 +1,49 @@
+// ticks.h
+#ifndef TICKS_H_
+#define TICKS_H_
+
+#include <stdint.h>
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+// ============================================
+// === Base de tempo (contador de ciclos) ===
+// ============================================
+
+/**
+ * @brief Lê o contador de ciclos desde o reset (timer0 uptime, 64 bits).
+ * O gateware habilita o uptime do timer0 (colorlight_i5.py). Sem ele,
+ * retorna sempre 0 e as medições de tempo ficam zeradas.
+ * @return Número de ciclos de clock do sistema desde o reset.
+ */
+static inline uint64_t ticks_now(void) {
+#ifdef CSR_TIMER0_UPTIME_CYCLES_ADDR
+    timer0_uptime_latch_write(1);
+    return timer0_uptime_cycles_read();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Lê só os 32 bits baixos do contador (uma leitura de CSR a menos).
+ * Com CSRs de 32 bits em ordem big-endian, a palavra baixa fica em +4.
+ * Dá a volta a cada 2^32 ciclos (~71 s a 60 MHz).
+ */
+static inline uint32_t ticks_now32(void) {
+#if defined(CSR_TIMER0_UPTIME_CYCLES_ADDR) && defined(CONFIG_CSR_ORDERING_BIG) && (CONFIG_CSR_DATA_WIDTH == 32)
+    timer0_uptime_latch_write(1);
+    return csr_read_simple(CSR_TIMER0_UPTIME_CYCLES_ADDR + 4);
+#else
+    return (uint32_t)ticks_now();
+#endif
+}
+
+/**
+ * @brief Converte ciclos de clock em microssegundos.
+ */
+static inline uint32_t ticks_to_us(uint64_t ticks) {
+    return (uint32_t)(ticks / (CONFIG_CLOCK_FREQUENCY / 1000000));
+}
+
+#endif // TICKS_H_
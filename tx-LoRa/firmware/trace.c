@@ -0,0 +1,69 @@
+// trace.c
+#include "trace.h"
+
+#include <string.h>
+#include <generated/soc.h>
+
+#include "telemetry.h"
+#include "ticks.h"
+#include "fastmem.h"
+
+// ============================================
+// === Estado Interno ===
+// ============================================
+
+volatile bool trace_on = false;
+
+static trace_entry_t trace_ring[TRACE_RING_SIZE];
+static uint32_t trace_head = 0; // Total de eventos gravados (o ring sobrescreve os mais antigos)
+
+// ============================================
+// === Gravação ===
+// ============================================
+
+FAST_TEXT void trace_record(uint16_t event, uint32_t arg) {
+    trace_entry_t *e = &trace_ring[trace_head & (TRACE_RING_SIZE - 1)];
+    e->cycles = ticks_now32();
+    e->event  = event;
+    e->arg    = arg;
+    trace_head++;
+}
+
+// ============================================
+// === Controle e dump ===
+// ============================================
+
+void trace_enable(bool on) {
+    trace_on = on;
+}
+
+void trace_clear(void) {
+    trace_head = 0;
+}
+
+unsigned int trace_count(void) {
+    return trace_head < TRACE_RING_SIZE ? trace_head : TRACE_RING_SIZE;
+}
+
+void trace_dump(void) {
+    telemetry_trace_t frame;
+    bool was_on = trace_on;
+    unsigned int count = trace_count();
+    uint32_t idx = trace_head - count;
+
+    trace_on = false;
+
+    frame.type = TELEM_TYPE_TRACE;
+    frame.clk_mhz = CONFIG_CLOCK_FREQUENCY / 1000000;
+    while (count > 0) {
+        unsigned int n = count < TELEM_TRACE_PER_FRAME ? count : TELEM_TRACE_PER_FRAME;
+        for (unsigned int i = 0; i < n; i++, idx++)
+            frame.entries[i] = trace_ring[idx & (TRACE_RING_SIZE - 1)];
+        frame.count = (uint8_t)n;
+        telemetry_send_frame((const uint8_t*)&frame,
+                             offsetof(telemetry_trace_t, entries) + n * sizeof(trace_entry_t));
+        count -= n;
+    }
+
+    trace_on = was_on;
+}
@@ -0,0 +1,68 @@
+// trace.h
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "trace_ids.h"
+
+// ============================================
+// === Trace de execução (ring buffer em SRAM) ===
+// ============================================
+//
+// TRACE_BEGIN/TRACE_END/TRACE_INSTANT gravam (evento, ciclo, argumento).
+// Desligado em tempo de execução, cada ponto custa um load e um desvio;
+// com TRACE_ENABLE=0 os pontos não geram código.
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+#define TRACE_RING_SIZE 128 // Potência de 2
+
+typedef struct __attribute__((packed)) {
+    uint32_t cycles;  // 32 bits baixos de ticks_now()
+    uint16_t event;   // trace_id_t | TRACE_PH_*
+    uint16_t reserved;
+    uint32_t arg;
+} trace_entry_t;
+
+extern volatile bool trace_on;
+
+void trace_record(uint16_t event, uint32_t arg);
+
+#if TRACE_ENABLE
+#define TRACE_AT(ev, ph, arg) do { \
+        if (trace_on) trace_record((uint16_t)(TRACE_##ev | (ph)), (uint32_t)(arg)); \
+    } while (0)
+#else
+#define TRACE_AT(ev, ph, arg) do { } while (0)
+#endif
+
+#define TRACE_BEGIN(ev, arg)   TRACE_AT(ev, TRACE_PH_BEGIN, arg)
+#define TRACE_END(ev, arg)     TRACE_AT(ev, TRACE_PH_END, arg)
+#define TRACE_INSTANT(ev, arg) TRACE_AT(ev, TRACE_PH_INSTANT, arg)
+
+/**
+ * @brief Liga/desliga a gravação de eventos.
+ */
+void trace_enable(bool on);
+
+/**
+ * @brief Descarta os eventos gravados.
+ */
+void trace_clear(void);
+
+/**
+ * @brief Número de eventos disponíveis no ring (no máximo TRACE_RING_SIZE).
+ */
+unsigned int trace_count(void);
+
+/**
+ * @brief Envia o conteúdo do ring como quadros binários (TELEM_TYPE_TRACE),
+ * do evento mais antigo para o mais novo. A gravação fica pausada durante o dump.
+ */
+void trace_dump(void);
+
+#endif // TRACE_H_
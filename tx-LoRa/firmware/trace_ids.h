@@ -0,0 +1,32 @@
+// trace_ids.h
+#ifndef TRACE_IDS_H_
+#define TRACE_IDS_H_
+
+// ============================================
+// === Tabela de eventos do trace ===
+// ============================================
+//
+// X(ID, "nome"): compartilhada com o conversor do host (host/trace2json).
+// Não reordene; acrescente novos eventos no fim.
+
+#define TRACE_EVENTS(X) \
+    X(SPI_TXRX,        "spi_txrx") \
+    X(LORA_SET_MODE,   "lora_set_mode") \
+    X(LORA_SEND,       "lora_send_bytes") \
+    X(LORA_WAIT_TXDONE,"lora_wait_txdone") \
+    X(I2C_WRITE_BYTE,  "i2c_write_byte") \
+    X(I2C_READ_BYTE,   "i2c_read_byte") \
+    X(BH1750_READ,     "bh1750_get_data") \
+    X(CONSOLE_CMD,     "console_cmd")
+
+#define TRACE_ID_ENUM(id, name) TRACE_##id,
+typedef enum { TRACE_EVENTS(TRACE_ID_ENUM) TRACE_ID_COUNT } trace_id_t;
+#undef TRACE_ID_ENUM
+
+// Fase do evento nos 2 bits altos do campo event
+#define TRACE_PH_BEGIN   0x0000
+#define TRACE_PH_END     0x4000
+#define TRACE_PH_INSTANT 0x8000
+#define TRACE_PH_MASK    0xC000
+
+#endif // TRACE_IDS_H_
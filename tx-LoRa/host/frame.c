@@ -0,0 +1,97 @@
+// frame.c - decodificação dos quadros COBS + CRC16 do stream do TX (lado host)
+#include "frame.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+uint16_t crc16_ccitt(const uint8_t *data, size_t len) {
+    uint16_t crc = 0;
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+size_t cobs_decode(const uint8_t *in, size_t len, uint8_t *out) {
+    size_t i = 0, o = 0;
+
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0) return 0;
+        for (uint8_t k = 1; k < code; k++) {
+            if (i >= len) return 0;
+            out[o++] = in[i++];
+        }
+        if (code != 0xFF && i < len) out[o++] = 0;
+    }
+    return o;
+}
+
+void frame_reader_init(frame_reader_t *r) {
+    memset(r, 0, sizeof(*r));
+}
+
+size_t frame_reader_push(frame_reader_t *r, uint8_t byte, uint8_t *payload, size_t maxlen) {
+    uint8_t dec[FRAME_MAX];
+    size_t n;
+
+    if (byte != 0) {
+        if (r->len < FRAME_MAX) r->buf[r->len++] = byte;
+        else r->overflow = 1;
+        return 0;
+    }
+
+    // Delimitador: fecha o quadro atual (quadros vazios são só sincronismo)
+    if (r->len == 0) return 0;
+    n = r->overflow ? 0 : cobs_decode(r->buf, r->len, dec);
+    r->len = 0;
+    r->overflow = 0;
+
+    if (n < 3 || n - 2 > maxlen ||
+        crc16_ccitt(dec, n - 2) != (uint16_t)(dec[n - 2] | (dec[n - 1] << 8))) {
+        r->bad++;
+        return 0;
+    }
+    r->good++;
+    memcpy(payload, dec, n - 2);
+    return n - 2;
+}
+
+static speed_t baud_to_speed(int baud) {
+    switch (baud) {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    case 3000000: return B3000000;
+    default:      return 0;
+    }
+}
+
+int serial_open(const char *dev, int baud) {
+    struct termios tio;
+    speed_t speed = baud_to_speed(baud);
+    int fd;
+
+    if (speed == 0) return -1;
+    fd = open(dev, O_RDONLY | O_NOCTTY);
+    if (fd < 0) return -1;
+    if (tcgetattr(fd, &tio) != 0) { close(fd); return -1; }
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tio.c_cc[VMIN]  = 1;
+    tio.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) { close(fd); return -1; }
+    return fd;
+}
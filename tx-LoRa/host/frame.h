@@ -0,0 +1,44 @@
+// frame.h - decodificação dos quadros COBS + CRC16 do stream do TX (lado host)
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FRAME_MAX 512
+
+typedef struct {
+    uint8_t  buf[FRAME_MAX];
+    size_t   len;
+    int      overflow;
+    unsigned long good;     // Quadros válidos
+    unsigned long bad;      // Quadros com COBS/CRC inválido
+} frame_reader_t;
+
+/**
+ * @brief CRC-16/CCITT idêntico ao crc16() da libbase do LiteX (init 0).
+ */
+uint16_t crc16_ccitt(const uint8_t *data, size_t len);
+
+/**
+ * @brief Decodifica um bloco COBS (sem delimitadores).
+ * @return Tamanho decodificado, ou 0 se o bloco for inválido.
+ */
+size_t cobs_decode(const uint8_t *in, size_t len, uint8_t *out);
+
+void frame_reader_init(frame_reader_t *r);
+
+/**
+ * @brief Alimenta um byte recebido da UART.
+ * @param payload Destino do payload (sem o CRC) quando um quadro fecha.
+ * @return Tamanho do payload quando um quadro válido termina, 0 caso contrário.
+ */
+size_t frame_reader_push(frame_reader_t *r, uint8_t byte, uint8_t *payload, size_t maxlen);
+
+/**
+ * @brief Abre e configura uma porta serial em modo raw.
+ * @return Descritor de arquivo, ou -1 em erro.
+ */
+int serial_open(const char *dev, int baud);
+
+#endif // FRAME_H_
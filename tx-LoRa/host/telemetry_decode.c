@@ -0,0 +1,122 @@
+// telemetry_decode.c - converte o stream binário do TX (comando `stream`) em CSV ou binário
+//
+// Uso:
+//   telemetry_decode [-d /dev/ttyACM0] [-b 115200] [-o saida.csv] [-r saida.bin] [-l saida.log] [arquivo]
+// Sem -d, lê do arquivo indicado ou da entrada padrão (ex.: captura feita com `cat`).
+// -r grava os registros telemetry_sample_t crus, concatenados, para pós-processamento.
+// Mensagens do log binário (log.h) são formatadas aqui com a tabela de log_ids.h
+// e vão para a saída de erro, ou para o arquivo indicado em -l.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include "frame.h"
+#include "telemetry.h"
+#include "log_ids.h"
+
+#define LOG_FMT_ENTRY(id, fmt) fmt,
+static const char * const log_formats[LOG_ID_COUNT] = { LOG_MESSAGES(LOG_FMT_ENTRY) };
+#undef LOG_FMT_ENTRY
+
+static void print_log(FILE *out, const telemetry_log_t *m) {
+    static const char * const levels[] = { "E", "W", "I", "D" };
+
+    fprintf(out, "[%10.6f] [%s] ", m->timestamp_us / 1e6, levels[m->level & 3]);
+    if (m->id < LOG_ID_COUNT)
+        fprintf(out, log_formats[m->id], m->args[0], m->args[1], m->args[2]);
+    else
+        fprintf(out, "id desconhecido %u (%u, %u, %u)", m->id, m->args[0], m->args[1], m->args[2]);
+    fputc('\n', out);
+}
+
+static volatile sig_atomic_t stop = 0;
+static void on_sigint(int sig) { (void)sig; stop = 1; }
+
+static void usage(const char *prog) {
+    fprintf(stderr, "uso: %s [-d dispositivo] [-b baud] [-o saida.csv] [-r saida.bin] [-l saida.log] [arquivo]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *dev = NULL, *csv_path = NULL, *bin_path = NULL, *log_path = NULL;
+    int baud = 115200, fd, opt;
+    FILE *csv = stdout, *bin = NULL, *logf = stderr;
+    frame_reader_t rd;
+    uint8_t chunk[4096], payload[FRAME_MAX];
+    unsigned long samples = 0, gaps = 0, logs = 0;
+    int have_seq = 0;
+    uint16_t last_seq = 0;
+
+    while ((opt = getopt(argc, argv, "d:b:o:r:l:h")) != -1) {
+        switch (opt) {
+        case 'd': dev = optarg; break;
+        case 'b': baud = atoi(optarg); break;
+        case 'o': csv_path = optarg; break;
+        case 'r': bin_path = optarg; break;
+        case 'l': log_path = optarg; break;
+        default:  usage(argv[0]); return 1;
+        }
+    }
+
+    if (dev) fd = serial_open(dev, baud);
+    else if (optind < argc) fd = open(argv[optind], O_RDONLY);
+    else fd = STDIN_FILENO;
+    if (fd < 0) { perror(dev ? dev : argv[optind]); return 1; }
+
+    if (csv_path && !(csv = fopen(csv_path, "w"))) { perror(csv_path); return 1; }
+    if (bin_path && !(bin = fopen(bin_path, "wb"))) { perror(bin_path); return 1; }
+    if (log_path && !(logf = fopen(log_path, "w"))) { perror(log_path); return 1; }
+
+    signal(SIGINT, on_sigint);
+    frame_reader_init(&rd);
+    fprintf(csv, "seq,timestamp_us,lux,read_ok,tx_ok,tx_skipped,read_us,tx_us\n");
+
+    while (!stop) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) break;
+
+        for (ssize_t i = 0; i < n; i++) {
+            size_t len = frame_reader_push(&rd, chunk[i], payload, sizeof(payload));
+            if (len == 0) continue;
+
+            if (payload[0] == TELEM_TYPE_SAMPLE && len == sizeof(telemetry_sample_t)) {
+                telemetry_sample_t s;
+                memcpy(&s, payload, sizeof(s));
+
+                if (have_seq && s.seq != (uint16_t)(last_seq + 1)) gaps++;
+                have_seq = 1;
+                last_seq = s.seq;
+                samples++;
+
+                if (bin) fwrite(&s, sizeof(s), 1, bin);
+                fprintf(csv, "%u,%u,%u.%02u,%d,%d,%d,%u,%u\n",
+                        s.seq, s.timestamp_us, s.luminosidade / 100, s.luminosidade % 100,
+                        !!(s.flags & TELEM_FLAG_READ_OK), !!(s.flags & TELEM_FLAG_TX_OK),
+                        !!(s.flags & TELEM_FLAG_TX_SKIPPED), s.read_us, s.tx_us);
+            } else if (payload[0] == TELEM_TYPE_LOG && len == sizeof(telemetry_log_t)) {
+                telemetry_log_t m;
+                memcpy(&m, payload, sizeof(m));
+                print_log(logf, &m);
+                logs++;
+            } else if (payload[0] == TELEM_TYPE_FILE && len == sizeof(telemetry_file_t)) {
+                telemetry_file_t f;
+                memcpy(&f, payload, sizeof(f));
+                fprintf(stderr, "arquivo SD LOG%03u.BIN (seq %u), aberto em %u us\n",
+                        f.file_idx, f.file_seq, f.timestamp_us);
+            }
+        }
+    }
+
+    fflush(csv);
+    fprintf(stderr, "amostras=%lu logs=%lu quadros_ok=%lu quadros_invalidos=%lu lacunas_seq=%lu\n",
+            samples, logs, rd.good, rd.bad, gaps);
+
+    if (bin) fclose(bin);
+    if (logf != stderr) fclose(logf);
+    if (csv != stdout) fclose(csv);
+    if (fd != STDIN_FILENO) close(fd);
+    return 0;
+}
@@ -0,0 +1,114 @@
+// trace2json.c - converte o dump do trace (comando `trace dump`) em JSON do Chrome trace / Perfetto
+//
+// Uso:
+//   trace2json [-d /dev/ttyACM0] [-b 115200] [-o trace.json] [arquivo]
+// Lê quadros TELEM_TYPE_TRACE até o fim da entrada (ou Ctrl+C) e grava o JSON
+// no formato "Trace Event" (abrir em chrome://tracing ou ui.perfetto.dev).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include "frame.h"
+#include "telemetry.h"
+#include "trace_ids.h"
+
+#define TRACE_NAME_ENTRY(id, name) name,
+static const char * const trace_names[TRACE_ID_COUNT] = { TRACE_EVENTS(TRACE_NAME_ENTRY) };
+#undef TRACE_NAME_ENTRY
+
+static volatile sig_atomic_t stop = 0;
+static void on_sigint(int sig) { (void)sig; stop = 1; }
+
+static void usage(const char *prog) {
+    fprintf(stderr, "uso: %s [-d dispositivo] [-b baud] [-o trace.json] [arquivo]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *dev = NULL, *out_path = NULL;
+    int baud = 115200, fd, opt;
+    FILE *out = stdout;
+    frame_reader_t rd;
+    uint8_t chunk[4096], payload[FRAME_MAX];
+    unsigned long events = 0;
+    uint64_t base = 0;          // Ciclos acumulados (desfaz a volta dos 32 bits)
+    uint32_t last = 0;
+    int first = 1;
+
+    while ((opt = getopt(argc, argv, "d:b:o:h")) != -1) {
+        switch (opt) {
+        case 'd': dev = optarg; break;
+        case 'b': baud = atoi(optarg); break;
+        case 'o': out_path = optarg; break;
+        default:  usage(argv[0]); return 1;
+        }
+    }
+
+    if (dev) fd = serial_open(dev, baud);
+    else if (optind < argc) fd = open(argv[optind], O_RDONLY);
+    else fd = STDIN_FILENO;
+    if (fd < 0) { perror(dev ? dev : argv[optind]); return 1; }
+    if (out_path && !(out = fopen(out_path, "w"))) { perror(out_path); return 1; }
+
+    signal(SIGINT, on_sigint);
+    frame_reader_init(&rd);
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    while (!stop) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) break;
+
+        for (ssize_t i = 0; i < n; i++) {
+            size_t len = frame_reader_push(&rd, chunk[i], payload, sizeof(payload));
+            telemetry_trace_t t;
+
+            if (len < offsetof(telemetry_trace_t, entries) || payload[0] != TELEM_TYPE_TRACE) continue;
+            memset(&t, 0, sizeof(t));
+            memcpy(&t, payload, len < sizeof(t) ? len : sizeof(t));
+            if (t.count > TELEM_TRACE_PER_FRAME || t.clk_mhz == 0 ||
+                len != offsetof(telemetry_trace_t, entries) + t.count * sizeof(trace_entry_t)) continue;
+
+            for (unsigned int k = 0; k < t.count; k++) {
+                const trace_entry_t *e = &t.entries[k];
+                unsigned int id = e->event & ~TRACE_PH_MASK;
+                const char *ph;
+                uint64_t cycles;
+
+                if (!first && e->cycles < last) base += 1ULL << 32;
+                last = e->cycles;
+                cycles = base + e->cycles;
+
+                switch (e->event & TRACE_PH_MASK) {
+                case TRACE_PH_BEGIN: ph = "B"; break;
+                case TRACE_PH_END:   ph = "E"; break;
+                default:             ph = "i"; break;
+                }
+
+                fprintf(out, "%s{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":1",
+                        first ? "" : ",\n", id < TRACE_ID_COUNT ? trace_names[id] : "?",
+                        ph, (double)cycles / t.clk_mhz);
+                if (id == TRACE_CONSOLE_CMD) {
+                    char tag[5] = { 0 };
+                    for (int c = 0; c < 4; c++) tag[c] = (char)(e->arg >> (8 * c));
+                    fprintf(out, ",\"args\":{\"cmd\":\"%s\"}", tag);
+                } else {
+                    fprintf(out, ",\"args\":{\"arg\":%u}", e->arg);
+                }
+                if (ph[0] == 'i') fprintf(out, ",\"s\":\"t\"");
+                fprintf(out, "}");
+                first = 0;
+                events++;
+            }
+        }
+    }
+
+    fprintf(out, "\n]}\n");
+    fprintf(stderr, "eventos=%lu quadros_ok=%lu quadros_invalidos=%lu\n", events, rd.good, rd.bad);
+
+    if (out != stdout) fclose(out);
+    if (fd != STDIN_FILENO) close(fd);
+    return 0;
+}
@@ -111,6 +111,8 @@ class BaseSoC(SoCCore):
         sdram_rate             = "1:1",
         with_video_terminal    = False,
         with_video_framebuffer = False,
+        spi_flash_mode         = "1x",
+        flash_boot_offset      = None,
         **kwargs):
         board = board.lower()
         assert board in ["i5", "i9"]
@@ -127,6 +129,8 @@ class BaseSoC(SoCCore):
         )
 
         # SoCCore ----------------------------------------------------------------------------------
+        # Uptime do timer0: contador de ciclos de 64 bits usado pelo firmware para medir tempos.
+        kwargs["timer_uptime"] = True
         SoCCore.__init__(self, platform, int(sys_clk_freq), ident = "LiteX SoC on Colorlight " + board.upper(), **kwargs)
 
         # Leds -------------------------------------------------------------------------------------
@@ -176,7 +180,21 @@ class BaseSoC(SoCCore):
             from litespi.modules import W25Q64 as SpiFlashModule
 
         from litespi.opcodes import SpiNorFlashOpCodes as Codes
-        self.add_spi_flash(mode="1x", module=SpiFlashModule(Codes.READ_1_1_1))
+        if spi_flash_mode == "4x":
+            # Leitura quad (1-1-4): usa os pads spiflash4x (DQ0..DQ3) da plataforma.
+            self.add_spi_flash(mode="4x", module=SpiFlashModule(Codes.READ_1_1_4))
+        else:
+            self.add_spi_flash(mode="1x", module=SpiFlashModule(Codes.READ_1_1_1))
+
+        # Boot do firmware pela flash: a BIOS copia a imagem (main.fbi) para a SDRAM e salta para ela.
+        # O bitstream ocupa o início da flash; o firmware fica em flash_boot_offset: 1 MB no i5
+        # (GD25Q16, 2 MB) e 2 MB no i9 (W25Q64, 8 MB), como FLASH_FIRMWARE_OFFSET (flash_layout.h).
+        if flash_boot_offset is None:
+            flash_boot_offset = {"i5": 0x00100000, "i9": 0x00200000}[board]
+        # O último setor (4 KB) guarda a configuração do firmware
+        assert flash_boot_offset < SpiFlashModule.total_size - 4096, \
+            f"flash_boot_offset 0x{flash_boot_offset:x} fora da flash de {board} ({SpiFlashModule.total_size} bytes)"
+        self.add_constant("FLASH_BOOT_ADDRESS", self.bus.regions["spiflash"].origin + flash_boot_offset)
 
         # SDR SDRAM --------------------------------------------------------------------------------
         if not self.integrated_main_ram_size:
@@ -243,6 +261,8 @@ def main():
     viopts = parser.target_group.add_mutually_exclusive_group()
     viopts.add_argument("--with-video-terminal",    action="store_true", help="Enable Video Terminal (HDMI).")
     viopts.add_argument("--with-video-framebuffer", action="store_true", help="Enable Video Framebuffer (HDMI).")
+    parser.add_target_argument("--spi-flash-mode",    default="1x", choices=["1x", "4x"], help="SPI Flash PHY mode (1x or 4x/quad).")
+    parser.add_target_argument("--flash-boot-offset", default=None,       type=lambda x: int(x, 0), help="Offset of the firmware image (main.fbi) in SPI Flash (default: 0x100000 on i5, 0x200000 on i9).")
     args = parser.parse_args()
 
     soc = BaseSoC(board=args.board, revision=args.revision,
@@ -257,6 +277,8 @@ def main():
         sdram_rate             = args.sdram_rate,
         with_video_terminal    = args.with_video_terminal,
         with_video_framebuffer = args.with_video_framebuffer,
+        spi_flash_mode         = args.spi_flash_mode,
+        flash_boot_offset      = args.flash_boot_offset,
         **parser.soc_argdict
     )
     soc.platform.add_extension(colorlight_i5._sdcard_pmod_io)
@@ -0,0 +1,569 @@
+#!/usr/bin/env python3
+
+#
+# Simulação (litex_sim/Verilator) do SoC de colorlight_i5.py.
+#
+# Mesmo CPU, clock (60 MHz), mapa de memória e mapa de CSRs da placa (spi, lora_reset, i2c,
+# ctrl, leds, spiflash, timer0, uart), de modo que o main.bin compilado para a placa roda sem
+# alterações. No lugar dos pinos, modelos comportamentais sintetizáveis:
+#   - RFM95 (SX1276, modo LoRa) como escravo SPI no SPIMaster;
+#   - BH1750 como escravo I2C no bit-bang I2CMaster.
+#
+#   python3 litex/colorlight_i5_sim.py --ram-init firmware/main.bin
+#
+# SPDX-License-Identifier: BSD-2-Clause
+
+from migen import *
+from migen.genlib.io import CRG
+
+from litex.gen import *
+
+from litex.build.generic_platform import Pins, Subsignal
+from litex.build.sim import SimPlatform
+from litex.build.sim.config import SimConfig
+
+from litex.soc.integration.common import get_mem_data
+from litex.soc.integration.soc_core import *
+from litex.soc.integration.builder import *
+from litex.soc.cores.led import LedChaser
+
+from litex.soc.cores.spi import SPIMaster
+from litex.soc.cores.bitbang import I2CMaster
+from litex.soc.cores.gpio import GPIOOut
+
+# IOs ----------------------------------------------------------------------------------------------
+
+_io = [
+    ("sys_clk", 0, Pins(1)),
+    ("sys_rst", 0, Pins(1)),
+    ("serial", 0,
+        Subsignal("source_valid", Pins(1)),
+        Subsignal("source_ready", Pins(1)),
+        Subsignal("source_data",  Pins(8)),
+        Subsignal("sink_valid",   Pins(1)),
+        Subsignal("sink_ready",   Pins(1)),
+        Subsignal("sink_data",    Pins(8)),
+    ),
+    ("user_led_n", 0, Pins(1)),
+]
+
+class Platform(SimPlatform):
+    def __init__(self):
+        SimPlatform.__init__(self, "SIM", _io, name="colorlight_i5_sim")
+
+# RFM95 --------------------------------------------------------------------------------------------
+
+# Valores de reset (datasheet do SX1276, coluna LoRa); o resto é 0x00.
+RFM95_RESET = {
+    0x01: 0x09, 0x06: 0x6C, 0x07: 0x80, 0x09: 0x4F, 0x0A: 0x09, 0x0B: 0x2B, 0x0C: 0x20,
+    0x0E: 0x80, 0x1D: 0x72, 0x1E: 0x70, 0x1F: 0x64, 0x21: 0x08, 0x22: 0x01, 0x23: 0xFF,
+    0x26: 0x04, 0x39: 0x12, 0x42: 0x12, 0x4D: 0x84,
+}
+
+# Larguras de banda pelo código de RegModemConfig1[7:4].
+RFM95_BW_HZ = [7800, 10400, 15600, 20800, 31250, 41700, 62500, 125000, 250000, 500000]
+
+class RFM95Model(LiteXModule):
+    """Modelo comportamental do RFM95 como escravo SPI (modo 0, MSB primeiro).
+
+    Registradores do modo LoRa com os valores de reset, FIFO de 256 bytes com RegFifoAddrPtr,
+    IrqFlags com escrita de 1 para limpar e RegVersion somente leitura. Ao entrar em TX, conta
+    o tempo no ar de SF/BW/CR/preâmbulo/CRC/LowDataRateOptimize (AN1200.13) e volta para STDBY
+    com TxDone. Com reset_n em 0 tudo volta ao padrão; o SPI só responde 5 ms após soltá-lo.
+    """
+    def __init__(self, pads, reset_n, sys_clk_freq):
+        regs = Array(Signal(8, reset=RFM95_RESET.get(i, 0), name=f"rfm95_reg{i:02x}") for i in range(0x80))
+        op_mode   = regs[0x01]
+        fifo_ptr  = regs[0x0D]
+        irq_flags = regs[0x12]
+
+        # # #
+
+        # Reset: 5 ms até o SPI responder.
+        ready_cnt = Signal(max=int(5e-3*sys_clk_freq) + 1)
+        ready     = Signal()
+        self.comb += ready.eq(ready_cnt == 0)
+
+        # FIFO.
+        self.specials.fifo = fifo = Memory(8, 256)
+        fifo_port = fifo.get_port(write_capable=True, async_read=True)
+        self.specials += fifo_port
+        wr_pending = Signal()
+        wr_adr     = Signal(8)
+        wr_dat     = Signal(8)
+        self.comb += [
+            fifo_port.adr.eq(Mux(wr_pending, wr_adr, fifo_ptr)),
+            fifo_port.we.eq(wr_pending),
+            fifo_port.dat_w.eq(wr_dat),
+        ]
+
+        # Escravo SPI (o SPIMaster roda no mesmo domínio: basta detectar as bordas).
+        sclk_d    = Signal()
+        shift_in  = Signal(8)
+        shift_out = Signal(8)
+        bit       = Signal(3)
+        first     = Signal()
+        wnr       = Signal()
+        addr      = Signal(7)
+        load      = Signal()
+        byte      = Signal(8)
+        rdata     = Signal(8)
+        sclk_rise = Signal()
+        sclk_fall = Signal()
+        self.sync += sclk_d.eq(pads.clk)
+        self.comb += [
+            sclk_rise.eq( pads.clk & ~sclk_d),
+            sclk_fall.eq(~pads.clk &  sclk_d),
+            byte.eq(Cat(pads.mosi, shift_in[:7])),
+            rdata.eq(Mux(addr == 0x00, fifo_port.dat_r, regs[addr])),
+        ]
+
+        # Transmissão.
+        tx_start = Signal()
+        tx_abort = Signal()
+        tx_done  = Signal()
+        self.tx = tx = _RFM95TxTimer(regs, sys_clk_freq)
+        self.comb += [
+            tx.start.eq(tx_start),
+            tx.abort.eq(tx_abort),
+            tx_done.eq(tx.done),
+        ]
+
+        # Escritas com efeito colateral.
+        write_reg = Case(addr, {
+            0x00: [
+                wr_pending.eq(1),
+                wr_adr.eq(fifo_ptr),
+                wr_dat.eq(byte),
+                fifo_ptr.eq(fifo_ptr + 1),
+            ],
+            0x01: [
+                op_mode.eq(byte),
+                tx_start.eq(byte[7] & (byte[:3] == 0b011) & ~tx.busy),
+                tx_abort.eq((byte[:3] != 0b011) & tx.busy),
+            ],
+            0x12: irq_flags.eq(irq_flags & ~byte),
+            0x42: [],
+            "default": regs[addr].eq(byte),
+        })
+
+        self.sync += [
+            wr_pending.eq(0),
+            tx_start.eq(0),
+            tx_abort.eq(0),
+            load.eq(0),
+            If(~reset_n,
+                *[r.eq(r.reset) for r in regs],
+                ready_cnt.eq(int(5e-3*sys_clk_freq)),
+                pads.miso.eq(0),
+            ).Else(
+                If(~ready, ready_cnt.eq(ready_cnt - 1)),
+                # TxDone: volta para STDBY.
+                If(tx_done,
+                    op_mode.eq(Cat(C(0b001, 3), op_mode[3:])),
+                    irq_flags.eq(irq_flags | 0x08),
+                ),
+                If(pads.cs_n | ~ready,
+                    bit.eq(0),
+                    first.eq(1),
+                ).Elif(sclk_rise,
+                    shift_in.eq(byte),
+                    bit.eq(bit + 1),
+                    If(bit == 7,
+                        If(first,
+                            first.eq(0),
+                            wnr.eq(byte[7]),
+                            addr.eq(byte[:7]),
+                            load.eq(~byte[7]),
+                        ).Elif(wnr,
+                            write_reg,
+                            If(addr != 0x00, addr.eq(addr + 1)),
+                        ).Else(
+                            # Rajada de leitura: o FIFO avança o ponteiro, os demais o endereço.
+                            If(addr == 0x00,
+                                fifo_ptr.eq(fifo_ptr + 1)
+                            ).Else(
+                                addr.eq(addr + 1)
+                            ),
+                            load.eq(1),
+                        )
+                    )
+                ).Elif(sclk_fall,
+                    pads.miso.eq(shift_out[7]),
+                    shift_out.eq(shift_out << 1),
+                ),
+                If(load, shift_out.eq(rdata)),
+            )
+        ]
+
+class _RFM95TxTimer(LiteXModule):
+    """Conta o tempo no ar de um pacote com a configuração atual dos registradores."""
+    def __init__(self, regs, sys_clk_freq):
+        self.start = Signal()
+        self.abort = Signal()
+        self.done  = Signal()
+        self.busy  = Signal()
+
+        # # #
+
+        # Ciclos por chip para cada código de banda (códigos inválidos: 125 kHz).
+        chip_cycles = Array(C(int(round(sys_clk_freq/RFM95_BW_HZ[i if i < len(RFM95_BW_HZ) else 7])), 16)
+            for i in range(16))
+
+        cr        = Signal(3)
+        bits_pos  = Signal(12)          # 8*PL + 28 + 16*CRC
+        bits_neg  = Signal(12)          # 4*SF + 20*IH, mais os bits já cobertos por símbolos
+        step      = Signal(6)           # Bits por bloco de (CR+4) símbolos: 4*(SF-2*DE)
+        symbols   = Signal(20)
+        tsym      = Signal(32)
+        cycles    = Signal(32)
+
+        self.fsm = fsm = FSM(reset_state="IDLE")
+        fsm.act("IDLE",
+            If(self.start,
+                NextValue(cr,       regs[0x1D][1:4]),
+                NextValue(bits_pos, (regs[0x22] << 3) + 28 + (regs[0x1E][2] << 4)),
+                NextValue(bits_neg, (regs[0x1E][4:8] << 2) + Mux(regs[0x1D][0], 20, 0)),
+                NextValue(step,     (regs[0x1E][4:8] - (regs[0x26][3] << 1)) << 2),
+                # Preâmbulo + 4.25 + 8 símbolos de cabeçalho (o 0.25 entra na contagem de ciclos)
+                NextValue(symbols, Cat(regs[0x21], regs[0x20]) + 4 + 8),
+                NextValue(tsym,    chip_cycles[regs[0x1D][4:8]] << regs[0x1E][4:8]),
+                NextState("CALC")
+            )
+        )
+        fsm.act("CALC",
+            self.busy.eq(1),
+            If(self.abort,
+                NextState("IDLE")
+            ).Elif((bits_pos > bits_neg) & (step != 0),
+                NextValue(bits_neg, bits_neg + step),
+                NextValue(symbols, symbols + cr + 4),
+            ).Else(
+                NextValue(cycles, tsym[2:]),
+                NextState("AIR")
+            )
+        )
+        fsm.act("AIR",
+            self.busy.eq(1),
+            If(self.abort,
+                NextState("IDLE")
+            ).Elif(cycles == 0,
+                If(symbols == 0,
+                    NextState("DONE")
+                ).Else(
+                    NextValue(symbols, symbols - 1),
+                    NextValue(cycles,  tsym - 1),
+                )
+            ).Else(
+                NextValue(cycles, cycles - 1)
+            )
+        )
+        fsm.act("DONE",
+            self.busy.eq(1),
+            self.done.eq(1),
+            NextState("IDLE")
+        )
+
+# BH1750 -------------------------------------------------------------------------------------------
+
+BH1750_CONT_H  = 0x10
+BH1750_CONT_H2 = 0x11
+BH1750_CONT_L  = 0x13
+BH1750_ONE_H   = 0x20
+BH1750_ONE_H2  = 0x21
+BH1750_ONE_L   = 0x23
+
+class BH1750Model(LiteXModule):
+    """Modelo comportamental do BH1750 como escravo I2C no nível dos pinos.
+
+    Power down/on, reset, modos contínuos e one-time (H, H2, L) com conversão de 120 ms
+    (16 ms no modo L); o one-time volta para power down. A leitura devolve lux*1.2 contagens
+    (o dobro em H2), 0 antes da primeira conversão. sda_o = 0 puxa SDA para baixo.
+    """
+    def __init__(self, scl, sda, sys_clk_freq, addr=0x23, lux=250.0):
+        self.sda_o = sda_o = Signal(reset=1)
+
+        # # #
+
+        counts_h = min(int(lux*1.2), 0xFFFF)
+        counts = {
+            "h":  C(counts_h, 16),
+            "h2": C(min(int(lux*2.4), 0xFFFF), 16),
+            "l":  C(counts_h & ~3, 16),
+        }
+        conv_h = int(120e-3*sys_clk_freq)
+        conv_l = int(16e-3*sys_clk_freq)
+
+        # Sensor.
+        powered  = Signal()
+        mode     = Signal(8)            # Comando de medida em curso (0 = nenhum)
+        data     = Signal(16)
+        conv_cnt = Signal(max=conv_h + 1)
+        result   = Signal(16)
+        self.comb += result.eq(
+            Mux((mode == BH1750_CONT_H2) | (mode == BH1750_ONE_H2), counts["h2"],
+            Mux((mode == BH1750_CONT_L)  | (mode == BH1750_ONE_L),  counts["l"],
+                counts["h"])))
+
+        # Escravo I2C.
+        scl_d = Signal(reset=1)
+        sda_d = Signal(reset=1)
+        state = Signal(3)
+        IDLE, ADDR, ADDR_ACK, WRITE, WRITE_ACK, READ, READ_ACK = range(7)
+        shift = Signal(8)
+        bits  = Signal(4)
+        rw    = Signal()
+        nack  = Signal()
+        out   = Signal(16)
+        self.sync += [scl_d.eq(scl), sda_d.eq(sda)]
+
+        start = Signal()
+        stop  = Signal()
+        rise  = Signal()
+        fall  = Signal()
+        self.comb += [
+            start.eq(scl & scl_d &  sda_d & ~sda),
+            stop.eq( scl & scl_d & ~sda_d &  sda),
+            rise.eq( scl & ~scl_d),
+            fall.eq(~scl &  scl_d),
+        ]
+
+        command = Case(shift, {
+            0x00: [powered.eq(0), mode.eq(0)],
+            0x01: powered.eq(1),
+            0x07: If(powered, data.eq(0)),
+            "default": If((shift == BH1750_CONT_H) | (shift == BH1750_CONT_H2) |
+                          (shift == BH1750_CONT_L) | (shift == BH1750_ONE_H)   |
+                          (shift == BH1750_ONE_H2) | (shift == BH1750_ONE_L),
+                powered.eq(1),
+                mode.eq(shift),
+                conv_cnt.eq(Mux(shift[:2] == 0b11, conv_l, conv_h)),
+            ),
+        })
+
+        # Bit de dados a pôr em SDA (depois dos 2 bytes, 1s).
+        next_bit = [sda_o.eq(out[15]), out.eq(Cat(C(1, 1), out[:15]))]
+
+        self.sync += [
+            # Conversão; no modo contínuo a próxima começa em seguida.
+            If(powered & (mode != 0),
+                If(conv_cnt == 0,
+                    data.eq(result),
+                    If(mode[5],
+                        powered.eq(0),
+                        mode.eq(0),
+                    ).Else(
+                        conv_cnt.eq(Mux(mode[:2] == 0b11, conv_l, conv_h)),
+                    )
+                ).Else(
+                    conv_cnt.eq(conv_cnt - 1)
+                )
+            ),
+            If(start,
+                state.eq(ADDR),
+                shift.eq(0),
+                bits.eq(0),
+                sda_o.eq(1),
+            ).Elif(stop,
+                state.eq(IDLE),
+                sda_o.eq(1),
+            ).Elif(rise,
+                Case(state, {
+                    ADDR:     [shift.eq(Cat(sda, shift[:7])), bits.eq(bits + 1)],
+                    WRITE:    [shift.eq(Cat(sda, shift[:7])), bits.eq(bits + 1)],
+                    READ:     bits.eq(bits + 1),
+                    READ_ACK: nack.eq(sda),
+                    "default": [],
+                })
+            ).Elif(fall,
+                Case(state, {
+                    ADDR: If(bits == 8,
+                        If(shift[1:] == addr,
+                            rw.eq(shift[0]),
+                            sda_o.eq(0),
+                            state.eq(ADDR_ACK),
+                        ).Else(
+                            state.eq(IDLE)
+                        )
+                    ),
+                    WRITE: If(bits == 8,
+                        command,
+                        sda_o.eq(0),
+                        state.eq(WRITE_ACK),
+                    ),
+                    ADDR_ACK: [
+                        bits.eq(0),
+                        shift.eq(0),
+                        If(rw,
+                            sda_o.eq(data[15]),
+                            out.eq(Cat(C(1, 1), data[:15])),
+                            state.eq(READ),
+                        ).Else(
+                            sda_o.eq(1),
+                            state.eq(WRITE),
+                        )
+                    ],
+                    WRITE_ACK: [
+                        bits.eq(0),
+                        shift.eq(0),
+                        sda_o.eq(1),
+                        state.eq(WRITE),
+                    ],
+                    READ: If(bits < 8,
+                        *next_bit
+                    ).Else(
+                        sda_o.eq(1), # Solta SDA para o ACK do mestre
+                        state.eq(READ_ACK),
+                    ),
+                    READ_ACK: If(nack,
+                        state.eq(IDLE)
+                    ).Else(
+                        bits.eq(0),
+                        *next_bit,
+                        state.eq(READ),
+                    ),
+                    "default": [],
+                })
+            )
+        ]
+
+# I2C ----------------------------------------------------------------------------------------------
+
+class SimI2CMaster(I2CMaster):
+    """I2CMaster com os mesmos CSRs (i2c_w, i2c_r), mas com o dreno aberto explícito em vez de
+    Tristate: sda_o é o nível imposto pelo mestre e sda_i o nível do barramento (wired-AND)."""
+    pads_layout = [("scl", 1), ("sda_o", 1), ("sda_i", 1)]
+
+    def connect(self, pads):
+        self.comb += [
+            pads.scl.eq(self._w.fields.scl),
+            pads.sda_o.eq(~(self._w.fields.oe & ~self._w.fields.sda)),
+            self._r.fields.sda.eq(pads.sda_i),
+        ]
+
+# SimSoC -------------------------------------------------------------------------------------------
+
+class SimSoC(SoCCore):
+    # Mesmos endereços da placa (build/colorlight_i5/csr.csv), para o main.bin rodar sem recompilar.
+    csr_map = {**SoCCore.csr_map,
+        "spi"            : 0,
+        "lora_reset"     : 1,
+        "i2c"            : 2,
+        "ctrl"           : 3,
+        "identifier_mem" : 4,
+        "leds"           : 5,
+        "sdram"          : 6,
+        "spiflash"       : 7,
+        "timer0"         : 8,
+        "uart"           : 9,
+    }
+    mem_map = {**SoCCore.mem_map,
+        "spiflash" : 0x00800000,
+    }
+
+    def __init__(self, sys_clk_freq=60e6,
+        with_radio        = True,
+        with_sensor       = True,
+        bh1750_addr       = 0x23,
+        bh1750_lux        = 250.0,
+        spi_flash_init    = None,
+        flash_boot_offset = 0x00200000,
+        **kwargs):
+        platform = Platform()
+
+        # CRG --------------------------------------------------------------------------------------
+        self.crg = CRG(platform.request("sys_clk"))
+
+        # SoCCore ----------------------------------------------------------------------------------
+        kwargs["timer_uptime"] = True
+        kwargs["uart_name"]    = "sim"
+        SoCCore.__init__(self, platform, int(sys_clk_freq), ident = "LiteX SoC on Colorlight I5 (sim)", **kwargs)
+
+        # Leds -------------------------------------------------------------------------------------
+        self.leds = LedChaser(pads=platform.request_all("user_led_n"), sys_clk_freq=sys_clk_freq)
+
+        # SPI + RFM95 ------------------------------------------------------------------------------
+        spi_pads = Record([("clk", 1), ("cs_n", 1), ("mosi", 1), ("miso", 1)])
+        self.spi = SPIMaster(pads=spi_pads, data_width=8, sys_clk_freq=sys_clk_freq, spi_clk_freq=1e6)
+        self.add_csr("spi")
+
+        lora_reset_n = Signal()
+        self.submodules.lora_reset = GPIOOut(lora_reset_n)
+        self.add_csr("lora_reset")
+
+        if with_radio:
+            self.rfm95 = RFM95Model(spi_pads, reset_n=lora_reset_n, sys_clk_freq=sys_clk_freq)
+        else:
+            self.comb += spi_pads.miso.eq(0)
+
+        # I2C + BH1750 -----------------------------------------------------------------------------
+        i2c_pads = Record(SimI2CMaster.pads_layout)
+        self.submodules.i2c = SimI2CMaster(pads=i2c_pads)
+        self.add_csr("i2c")
+
+        if with_sensor:
+            self.bh1750 = BH1750Model(i2c_pads.scl, i2c_pads.sda_i, sys_clk_freq, addr=bh1750_addr, lux=bh1750_lux)
+            self.comb += i2c_pads.sda_i.eq(i2c_pads.sda_o & self.bh1750.sda_o)
+        else:
+            self.comb += i2c_pads.sda_i.eq(i2c_pads.sda_o)
+
+        # SPI Flash --------------------------------------------------------------------------------
+        # Modelo da LiteSPI servindo a região spiflash a partir de uma imagem (apagada por padrão).
+        from litespi.modules import W25Q64 as SpiFlashModule
+        from litespi.opcodes import SpiNorFlashOpCodes as Codes
+        from litespi.phy.model import LiteSPIPHYModel
+        spiflash_module = SpiFlashModule(Codes.READ_1_1_1)
+        if spi_flash_init is None:
+            spi_flash_init = [0xFFFFFFFF]*(spiflash_module.total_size//4)
+        self.spiflash_phy = LiteSPIPHYModel(spiflash_module, init=spi_flash_init)
+        self.add_spi_flash(phy=self.spiflash_phy, mode="1x", module=spiflash_module, with_master=True)
+        assert flash_boot_offset < spiflash_module.total_size - 4096, "flash_boot_offset fora da flash"
+        self.add_constant("FLASH_BOOT_ADDRESS", self.bus.regions["spiflash"].origin + flash_boot_offset)
+
+# Build --------------------------------------------------------------------------------------------
+
+def main():
+    from litex.build.parser import LiteXArgumentParser
+    parser = LiteXArgumentParser(platform=Platform, description="LiteX SoC on Colorlight I5 (Verilator simulation).")
+    parser.add_target_argument("--sys-clk-freq",      default=60e6, type=float,             help="System clock frequency.")
+    parser.add_target_argument("--ram-init",          default=None,                         help="Firmware (main.bin) preloaded in main_ram; the BIOS jumps straight to it.")
+    parser.add_target_argument("--spi-flash-init",    default=None,                         help="SPI Flash image (default: erased).")
+    parser.add_target_argument("--flash-boot-offset", default=0x00200000, type=lambda x: int(x, 0), help="Offset of the firmware image (main.fbi) in SPI Flash.")
+    parser.add_target_argument("--bh1750-addr",       default=0x23, type=lambda x: int(x, 0), help="BH1750 model I2C address.")
+    parser.add_target_argument("--bh1750-lux",        default=250.0, type=float,            help="Illuminance seen by the BH1750 model.")
+    parser.add_target_argument("--no-radio",          action="store_true",                  help="No RFM95 model on the SPI bus.")
+    parser.add_target_argument("--no-sensor",         action="store_true",                  help="No BH1750 model on the I2C bus.")
+    args = parser.parse_args()
+
+    sys_clk_freq = int(args.sys_clk_freq)
+    sim_config   = SimConfig()
+    sim_config.add_clocker("sys_clk", freq_hz=sys_clk_freq)
+    sim_config.add_module("serial2console", "serial")
+
+    # main_ram integrada no lugar da SDRAM, na mesma região da placa (0x40000000, 8 MiB).
+    soc_kwargs = parser.soc_argdict
+    soc_kwargs["integrated_main_ram_size"] = 0x00800000
+    if args.ram_init is not None:
+        soc_kwargs["integrated_main_ram_init"] = get_mem_data(args.ram_init, endianness="little")
+    spi_flash_init = None
+    if args.spi_flash_init is not None:
+        spi_flash_init = get_mem_data(args.spi_flash_init, endianness="little")
+
+    soc = SimSoC(
+        sys_clk_freq      = sys_clk_freq,
+        with_radio        = not args.no_radio,
+        with_sensor       = not args.no_sensor,
+        bh1750_addr       = args.bh1750_addr,
+        bh1750_lux        = args.bh1750_lux,
+        spi_flash_init    = spi_flash_init,
+        flash_boot_offset = args.flash_boot_offset,
+        **soc_kwargs
+    )
+    if args.ram_init is not None:
+        soc.add_constant("ROM_BOOT_ADDRESS", soc.mem_map["main_ram"])
+
+    builder = Builder(soc, **parser.builder_argdict)
+    builder.build(sim_config=sim_config, **parser.toolchain_argdict)
+
+if __name__ == "__main__":
+    main()